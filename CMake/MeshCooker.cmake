@@ -0,0 +1,39 @@
+set(MESH_OUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/out)
+file(MAKE_DIRECTORY ${MESH_OUT_DIR})
+
+# Cook the mesh with the MeshCooker tool and copy it to runtime directory
+#
+# OBJ, glTF and GLB sources become <name>.mesh in meshes/, external glTF
+# buffers are tracked through the depfile written by the cooker.
+function(cook_mesh target)
+    cmake_parse_arguments(PARSE_ARGV 1 arg "" "" "SOURCES")
+    foreach(source ${arg_SOURCES})
+        get_filename_component(MESH_NAME ${source} NAME_WE)
+        set(MESH_OUT_RESULT "${MESH_OUT_DIR}/${MESH_NAME}.mesh")
+        set(MESH_DEP_RESULT "${MESH_OUT_DIR}/${MESH_NAME}.mesh.d")
+
+        add_custom_command(
+            OUTPUT ${MESH_OUT_RESULT}
+            DEPENDS ${source} MeshCooker
+            DEPFILE ${MESH_DEP_RESULT}
+            COMMAND
+                $<TARGET_FILE:MeshCooker>
+                ${CMAKE_CURRENT_SOURCE_DIR}/${source}
+                -out=${MESH_OUT_RESULT}
+                -depfile=${MESH_DEP_RESULT}
+            COMMENT
+                "Cooking mesh ${source}"
+        )
+
+        set(MESH_RUNTIME_RESULT "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/meshes/${MESH_NAME}.mesh")
+        add_custom_command(
+            OUTPUT ${MESH_RUNTIME_RESULT}
+            DEPENDS ${MESH_OUT_RESULT}
+            COMMAND
+                ${CMAKE_COMMAND} -E copy
+                ${MESH_OUT_RESULT}
+                ${MESH_RUNTIME_RESULT}
+        )
+        target_sources(${target} PRIVATE ${MESH_RUNTIME_RESULT})
+    endforeach()
+endfunction()
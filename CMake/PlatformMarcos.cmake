@@ -19,3 +19,40 @@ if (CMAKE_BUILD_TYPE STREQUAL "Debug")
 else()
     add_compile_definitions(BUILD_RELEASE)
 endif()
+
+# SIMD backend of the math library. AUTO picks NEON on ARM64 and SSE4 on
+# x86-64, AVX2 is opt-in since not every x86-64 CPU has it.
+set(ENGINE_SIMD "AUTO" CACHE STRING "Math SIMD backend: AUTO, AVX2, SSE4, NEON or SCALAR")
+set_property(CACHE ENGINE_SIMD PROPERTY STRINGS AUTO AVX2 SSE4 NEON SCALAR)
+
+set(ENGINE_SIMD_BACKEND ${ENGINE_SIMD})
+if (ENGINE_SIMD STREQUAL "AUTO")
+    if (CMAKE_SYSTEM_PROCESSOR MATCHES "^(arm64|aarch64|ARM64)$")
+        set(ENGINE_SIMD_BACKEND "NEON")
+    elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$")
+        set(ENGINE_SIMD_BACKEND "SSE4")
+    else()
+        set(ENGINE_SIMD_BACKEND "SCALAR")
+    endif()
+endif()
+
+if (ENGINE_SIMD_BACKEND STREQUAL "AVX2")
+    add_compile_definitions(MATH_SIMD_AVX2)
+    if (MSVC)
+        add_compile_options(/arch:AVX2)
+    else()
+        add_compile_options(-mavx2 -mfma)
+    endif()
+elseif (ENGINE_SIMD_BACKEND STREQUAL "SSE4")
+    add_compile_definitions(MATH_SIMD_SSE4)
+    # MSVC always allows SSE4.1 intrinsics on x64
+    if (NOT MSVC)
+        add_compile_options(-msse4.1)
+    endif()
+elseif (ENGINE_SIMD_BACKEND STREQUAL "NEON")
+    add_compile_definitions(MATH_SIMD_NEON)
+elseif (NOT ENGINE_SIMD_BACKEND STREQUAL "SCALAR")
+    message(FATAL_ERROR "Unknown ENGINE_SIMD backend ${ENGINE_SIMD}")
+endif()
+
+message(STATUS "Math SIMD backend: ${ENGINE_SIMD_BACKEND}")
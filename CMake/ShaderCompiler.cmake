@@ -7,28 +7,126 @@ find_program(glslc_executable
 
 message(STATUS "Compiling shaders using ${glslc_executable}")
 
+# Optional SPIRV-Tools, shipped with the Vulkan SDK
+find_program(spirv_opt_executable
+    NAMES
+        spirv-opt
+    HINTS
+        "$ENV{VULKAN_SDK}/bin")
+
+find_program(spirv_val_executable
+    NAMES
+        spirv-val
+    HINTS
+        "$ENV{VULKAN_SDK}/bin")
+
+mark_as_advanced(
+    glslc_executable
+    spirv_opt_executable
+    spirv_val_executable
+)
+
+# Release shaders are optimized and stripped, debug shaders keep everything
+if (CMAKE_BUILD_TYPE STREQUAL "Debug")
+    set(SHADER_OPTIMIZE_DEFAULT OFF)
+else()
+    set(SHADER_OPTIMIZE_DEFAULT ON)
+endif()
+
+option(SHADER_OPTIMIZE "Run SPIR-V performance passes and strip debug info" ${SHADER_OPTIMIZE_DEFAULT})
+
+if (SHADER_OPTIMIZE AND NOT spirv_opt_executable)
+    message(STATUS "spirv-opt not found, shaders are optimized by glslc and keep debug info")
+endif()
+
+if (NOT spirv_val_executable)
+    message(STATUS "spirv-val not found, shaders are not validated")
+endif()
+
 set(SHADER_OUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/out)
+set(SHADER_STATS_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/SpirvStats.cmake)
 file(MAKE_DIRECTORY ${SHADER_OUT_DIR})
 
 # Compile and copy the shader to runtime directory
+#
+# With SHADER_OPTIMIZE and spirv-opt the shader is first compiled with debug
+# info to <source>.debug.<format>, which stays in the build directory as a
+# side-car for debugging tools, then optimized and stripped for shipping. The
+# stats compare against the side-car with only the debug info stripped, so
+# they show what the optimizer removed.
 function(compile_shader target)
     cmake_parse_arguments(PARSE_ARGV 1 arg "" "ENV;FORMAT" "SOURCES")
     foreach(source ${arg_SOURCES})
         set(SHADER_OUT_RESULT "${SHADER_OUT_DIR}/${source}.${arg_FORMAT}")
         set(SHADER_DEP_RESULT "${SHADER_OUT_DIR}/${source}.d")
 
-        add_custom_command(
-            OUTPUT ${SHADER_OUT_RESULT}
-            DEPENDS ${source}
-            DEPFILE ${SHADER_DEP_RESULT}
-            COMMAND
-                ${glslc_executable}
-                -MD -MF ${SHADER_DEP_RESULT}
-                -o ${SHADER_OUT_RESULT}
-                ${CMAKE_CURRENT_SOURCE_DIR}/${source}
-            COMMENT
-                "Building shader ${source}"
-        )
+        if (spirv_val_executable)
+            set(SHADER_VALIDATE_COMMAND
+                COMMAND
+                    ${spirv_val_executable}
+                    --target-env vulkan1.0
+                    ${SHADER_OUT_RESULT})
+        else()
+            set(SHADER_VALIDATE_COMMAND "")
+        endif()
+
+        if (SHADER_OPTIMIZE AND spirv_opt_executable)
+            set(SHADER_DEBUG_RESULT "${SHADER_OUT_DIR}/${source}.debug.${arg_FORMAT}")
+            set(SHADER_BASELINE_RESULT "${SHADER_OUT_DIR}/${source}.baseline.${arg_FORMAT}")
+
+            add_custom_command(
+                OUTPUT ${SHADER_OUT_RESULT} ${SHADER_DEBUG_RESULT} ${SHADER_BASELINE_RESULT}
+                DEPENDS ${source} ${SHADER_STATS_SCRIPT}
+                DEPFILE ${SHADER_DEP_RESULT}
+                COMMAND
+                    ${glslc_executable}
+                    -g
+                    -MD -MF ${SHADER_DEP_RESULT} -MT ${SHADER_OUT_RESULT}
+                    -o ${SHADER_DEBUG_RESULT}
+                    ${CMAKE_CURRENT_SOURCE_DIR}/${source}
+                COMMAND
+                    ${spirv_opt_executable}
+                    --strip-debug
+                    -o ${SHADER_BASELINE_RESULT}
+                    ${SHADER_DEBUG_RESULT}
+                COMMAND
+                    ${spirv_opt_executable}
+                    -O
+                    --strip-debug
+                    -o ${SHADER_OUT_RESULT}
+                    ${SHADER_DEBUG_RESULT}
+                ${SHADER_VALIDATE_COMMAND}
+                COMMAND
+                    ${CMAKE_COMMAND}
+                    -DNAME=${source}
+                    -DBEFORE=${SHADER_BASELINE_RESULT}
+                    -DAFTER=${SHADER_OUT_RESULT}
+                    -P ${SHADER_STATS_SCRIPT}
+                COMMENT
+                    "Building optimized shader ${source}"
+            )
+        else()
+            if (SHADER_OPTIMIZE)
+                set(SHADER_COMPILE_FLAGS -O)
+            else()
+                set(SHADER_COMPILE_FLAGS -g -O0)
+            endif()
+
+            add_custom_command(
+                OUTPUT ${SHADER_OUT_RESULT}
+                DEPENDS ${source}
+                DEPFILE ${SHADER_DEP_RESULT}
+                COMMAND
+                    ${glslc_executable}
+                    ${SHADER_COMPILE_FLAGS}
+                    -MD -MF ${SHADER_DEP_RESULT}
+                    -o ${SHADER_OUT_RESULT}
+                    ${CMAKE_CURRENT_SOURCE_DIR}/${source}
+                ${SHADER_VALIDATE_COMMAND}
+                COMMENT
+                    "Building shader ${source}"
+            )
+        endif()
 
         set(SHADER_RUNTIME_RESULT "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/shaders/${source}.${arg_FORMAT}")
         add_custom_command(
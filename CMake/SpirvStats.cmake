@@ -0,0 +1,47 @@
+# Prints the instruction count and size of a SPIR-V module before and after
+# optimization.
+#
+# Usage: cmake -DNAME=<shader> -DBEFORE=<file> -DAFTER=<file> -P SpirvStats.cmake
+
+function(count_spirv_instructions file out_count out_bytes)
+    file(SIZE ${file} bytes)
+    file(READ ${file} content HEX)
+
+    # The header is five words, starting with the magic number 0x07230203
+    string(SUBSTRING "${content}" 0 8 magic)
+    if (NOT magic STREQUAL "03022307")
+        message(WARNING "${file} is not a little-endian SPIR-V module")
+        set(${out_count} 0 PARENT_SCOPE)
+        set(${out_bytes} ${bytes} PARENT_SCOPE)
+        return()
+    endif()
+
+    string(LENGTH "${content}" length)
+
+    set(count 0)
+    set(offset 40)
+    while (offset LESS length)
+        # The upper half of the first word is the instruction word count
+        math(EXPR high_offset "${offset} + 4")
+        string(SUBSTRING "${content}" ${high_offset} 2 low_byte)
+        math(EXPR high_offset "${offset} + 6")
+        string(SUBSTRING "${content}" ${high_offset} 2 high_byte)
+        math(EXPR word_count "0x${high_byte}${low_byte}")
+
+        if (word_count EQUAL 0)
+            message(WARNING "${file} contains an instruction of zero words")
+            break()
+        endif()
+
+        math(EXPR offset "${offset} + ${word_count} * 8")
+        math(EXPR count "${count} + 1")
+    endwhile()
+
+    set(${out_count} ${count} PARENT_SCOPE)
+    set(${out_bytes} ${bytes} PARENT_SCOPE)
+endfunction()
+
+count_spirv_instructions(${BEFORE} before_count before_bytes)
+count_spirv_instructions(${AFTER} after_count after_bytes)
+
+message(STATUS "${NAME}: ${before_count} -> ${after_count} instructions, ${before_bytes} -> ${after_bytes} bytes")
@@ -0,0 +1,76 @@
+#include "Benchmark/BenchmarkReport.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+FBenchmarkReport::FRow& FBenchmarkReport::FRow::Set(const std::string& key,
+                                                    double value)
+{
+    for (auto& metric : metrics) {
+        if (metric.first == key) {
+            metric.second = value;
+            return *this;
+        }
+    }
+
+    metrics.emplace_back(key, value);
+    return *this;
+}
+
+FBenchmarkReport::FBenchmarkReport(const std::string& name) : name(name) {}
+
+FBenchmarkReport::FRow& FBenchmarkReport::AddRow(const std::string& rowName)
+{
+    rows.push_back({.name = rowName, .metrics = {}});
+    return rows.back();
+}
+
+void FBenchmarkReport::Print() const
+{
+    std::cout << "Benchmark: " << name << std::endl;
+
+    for (const FRow& row : rows) {
+        std::cout << '\t' << std::left << std::setw(24) << row.name;
+        for (const auto& [key, value] : row.metrics) {
+            std::cout << ' ' << key << '=' << value;
+        }
+        std::cout << std::endl;
+    }
+}
+
+void FBenchmarkReport::WriteJson(const std::string& filename) const
+{
+    std::ofstream file(filename);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open benchmark output file");
+    }
+
+    file << std::setprecision(9);
+    file << "{\n  \"benchmark\": \"" << name << "\",\n  \"results\": [";
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const FRow& row = rows[i];
+
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"name\": \"" << row.name << "\"";
+
+        for (const auto& [key, value] : row.metrics) {
+            file << ", \"" << key << "\": ";
+            // JSON has no representation for nan or inf
+            if (std::isfinite(value)) {
+                file << value;
+            } else {
+                file << "null";
+            }
+        }
+
+        file << "}";
+    }
+
+    file << "\n  ]\n}\n";
+}
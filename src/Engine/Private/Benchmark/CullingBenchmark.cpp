@@ -0,0 +1,197 @@
+#include "Benchmark/CullingBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "Core/FrustumCuller.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr float SceneExtent = 100.0f;
+
+// Objects the backends may disagree on lie within rounding of a plane
+constexpr double PlaneTolerance = 1e-3;
+
+// How far the object is inside the frustum, negative when outside
+using FPenetration = std::function<double(uint32_t)>;
+
+void CheckSameVisible(const std::vector<uint32_t>& reference,
+                      std::span<const uint32_t> result,
+                      const FPenetration& penetration, const char* name)
+{
+    std::vector<uint32_t> differences;
+    std::set_symmetric_difference(reference.begin(), reference.end(),
+                                  result.begin(), result.end(),
+                                  std::back_inserter(differences));
+
+    for (const uint32_t index : differences) {
+        if (std::abs(penetration(index)) > PlaneTolerance) {
+            throw std::runtime_error(std::string(name) + " culling of object " +
+                                     std::to_string(index) +
+                                     " differs from the scalar path");
+        }
+    }
+}
+
+double GetPlaneDistance(const FVector4& plane, double x, double y, double z)
+{
+    return plane.x * x + plane.y * y + plane.z * z + plane.w;
+}
+
+} // namespace
+
+FCullingBenchmark::FCullingBenchmark()
+    : objectCount(static_cast<uint32_t>(
+          FCommandLine::GetInt("cullobjects", 1'000'000))),
+      warmupIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FCullingBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> position(-SceneExtent, SceneExtent);
+    std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+    // Spheres use the first four arrays, boxes all but the radius
+    std::array<std::vector<float>, 7> arrays;
+    for (size_t i = 0; i < arrays.size(); i++) {
+        arrays[i].resize(objectCount);
+        for (float& value : arrays[i]) {
+            value = i < 3 ? position(random) : size(random);
+        }
+    }
+
+    const FSphereArrays spheres = {
+        .centerX = arrays[0].data(),
+        .centerY = arrays[1].data(),
+        .centerZ = arrays[2].data(),
+        .radius = arrays[3].data(),
+        .count = objectCount,
+    };
+    const FBoundsArrays bounds = {
+        .centerX = arrays[0].data(),
+        .centerY = arrays[1].data(),
+        .centerZ = arrays[2].data(),
+        .extentX = arrays[4].data(),
+        .extentY = arrays[5].data(),
+        .extentZ = arrays[6].data(),
+        .count = objectCount,
+    };
+
+    // From the middle of the scene, so about a tenth is visible
+    const FMatrix4 view = FMatrix4::LookAt(
+        {0.0f, 0.0f, 0.0f}, {0.3f, 0.1f, -1.0f}, {0.0f, 1.0f, 0.0f});
+    const FMatrix4 projection =
+        FMatrix4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, SceneExtent);
+    const FFrustum frustum = FFrustum::FromMatrix(projection * view);
+
+    const FPenetration spherePenetration = [&](uint32_t i) {
+        double result = std::numeric_limits<double>::max();
+        for (const FVector4& plane : frustum.planes) {
+            result = std::min(
+                result, GetPlaneDistance(plane, spheres.centerX[i],
+                                         spheres.centerY[i],
+                                         spheres.centerZ[i]) +
+                            spheres.radius[i]);
+        }
+        return result;
+    };
+    const FPenetration boxPenetration = [&](uint32_t i) {
+        double result = std::numeric_limits<double>::max();
+        for (const FVector4& plane : frustum.planes) {
+            const double radius = std::abs(plane.x) * bounds.extentX[i] +
+                                  std::abs(plane.y) * bounds.extentY[i] +
+                                  std::abs(plane.z) * bounds.extentZ[i];
+            result = std::min(
+                result, GetPlaneDistance(plane, bounds.centerX[i],
+                                         bounds.centerY[i],
+                                         bounds.centerZ[i]) +
+                            radius);
+        }
+        return result;
+    };
+
+    FFrustumCuller culler;
+
+    std::cout << "Math backend " << FMathBatch::GetNativeBackendName() << ", "
+              << FMathBatch::GetNativeWidth() << " lanes" << std::endl;
+
+    for (const bool bBoxes : {false, true}) {
+        const auto cull = [&](FThreadPool* pool, EMathBackend backend) {
+            return bBoxes ? culler.CullBounds(frustum, bounds, pool, backend)
+                          : culler.CullSpheres(frustum, spheres, pool,
+                                               backend);
+        };
+
+        const std::span<const uint32_t> scalarVisible =
+            cull(nullptr, EMathBackend::Scalar);
+        const std::vector<uint32_t> reference(scalarVisible.begin(),
+                                              scalarVisible.end());
+
+        const char* shape = bBoxes ? "boxes" : "spheres";
+
+        for (const EMathBackend backend :
+             {EMathBackend::Scalar, EMathBackend::Native}) {
+            for (const bool bParallel : {false, true}) {
+                FThreadPool* pool = bParallel ? &FThreadPool::Get() : nullptr;
+
+                CheckSameVisible(reference, cull(pool, backend),
+                                 bBoxes ? boxPenetration : spherePenetration,
+                                 shape);
+
+                for (uint32_t i = 0; i < warmupIterations; i++) {
+                    cull(pool, backend);
+                }
+
+                const auto begin = Clock::now();
+                for (uint32_t i = 0; i < measuredIterations; i++) {
+                    cull(pool, backend);
+                }
+                const double time =
+                    Milliseconds(Clock::now() - begin).count() /
+                    std::max(measuredIterations, 1u);
+
+                const std::string name =
+                    std::string(shape) +
+                    (backend == EMathBackend::Native ? "_native" : "_scalar") +
+                    (bParallel ? "_parallel" : "_serial");
+
+                report.AddRow(name)
+                    .Set("objects", static_cast<double>(objectCount))
+                    .Set("visible",
+                         static_cast<double>(culler.GetVisible().size()))
+                    .Set("cull_ms", time)
+                    .Set("ns_per_object",
+                         time * 1e6 /
+                             std::max<double>(static_cast<double>(objectCount),
+                                              1.0));
+
+                std::cout << name << ": " << culler.GetVisible().size()
+                          << " of " << objectCount << " visible in " << time
+                          << " ms" << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include "Benchmark/DrawSortBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "Core/DrawQueue.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t PassCount = 2;
+constexpr uint32_t PipelineCount = 64;
+constexpr uint32_t MaterialCount = 1024;
+
+struct FBindCounts {
+    uint64_t pipelines = 0;
+    uint64_t materials = 0;
+};
+
+// Binds the way recording does, only when the state bits of the key change
+FBindCounts CountBinds(std::span<const FDrawItem> items)
+{
+    FBindCounts counts;
+    for (size_t i = 0; i < items.size(); i++) {
+        const uint64_t key = items[i].key;
+        const bool bFirst = i == 0;
+        if (bFirst || FDrawKey::GetState(key) !=
+                          FDrawKey::GetState(items[i - 1].key)) {
+            const uint64_t previous = bFirst ? ~key : items[i - 1].key;
+            counts.pipelines += FDrawKey::GetPass(key) !=
+                                    FDrawKey::GetPass(previous) ||
+                                FDrawKey::GetPipeline(key) !=
+                                    FDrawKey::GetPipeline(previous);
+            counts.materials += FDrawKey::GetMaterial(key) !=
+                                FDrawKey::GetMaterial(previous);
+        }
+    }
+    return counts;
+}
+
+} // namespace
+
+FDrawSortBenchmark::FDrawSortBenchmark()
+    : drawCount(
+          static_cast<uint32_t>(FCommandLine::GetInt("draws", 1'000'000))),
+      warmupIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FDrawSortBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::mt19937 random(9);
+    std::uniform_int_distribution<uint32_t> pass(0, PassCount - 1);
+    std::uniform_int_distribution<uint32_t> pipeline(0, PipelineCount - 1);
+    std::uniform_int_distribution<uint32_t> material(0, MaterialCount - 1);
+    std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+
+    std::vector<FDrawItem> submitted(drawCount);
+    for (uint32_t i = 0; i < drawCount; i++) {
+        submitted[i] = {
+            .key = FDrawKey::Make(pass(random), pipeline(random),
+                                  material(random),
+                                  FDrawKey::EncodeDepth(depth(random))),
+            .draw = i,
+        };
+    }
+
+    std::vector<FDrawItem> reference = submitted;
+    std::stable_sort(reference.begin(), reference.end(),
+                     [](const FDrawItem& a, const FDrawItem& b) {
+                         return a.key < b.key;
+                     });
+
+    FDrawQueue queue;
+    const auto fillQueue = [&]() {
+        queue.Reset();
+        for (const FDrawItem& item : submitted) {
+            queue.Add(item.key, item.draw);
+        }
+    };
+
+    struct FCase {
+        const char* name;
+        bool bRadix;
+        bool bParallel;
+    };
+    const FCase cases[] = {
+        {"stable_sort", false, false},
+        {"radix_serial", true, false},
+        {"radix_parallel", true, true},
+    };
+
+    for (const FCase& sortCase : cases) {
+        FThreadPool* pool = sortCase.bParallel ? &FThreadPool::Get() : nullptr;
+        std::vector<FDrawItem> sorted;
+
+        double total = 0.0;
+        for (uint32_t i = 0; i < warmupIterations + measuredIterations; i++) {
+            // Filling the queue is part of every frame, so it is timed too
+            const auto begin = Clock::now();
+            if (sortCase.bRadix) {
+                fillQueue();
+                queue.Sort(pool);
+            } else {
+                sorted = submitted;
+                std::stable_sort(sorted.begin(), sorted.end(),
+                                 [](const FDrawItem& a, const FDrawItem& b) {
+                                     return a.key < b.key;
+                                 });
+            }
+            const auto end = Clock::now();
+
+            if (i >= warmupIterations) {
+                total += Milliseconds(end - begin).count();
+            }
+        }
+
+        if (sortCase.bRadix) {
+            const std::span<const FDrawItem> items = queue.GetItems();
+            for (size_t i = 0; i < items.size(); i++) {
+                if (items[i].key != reference[i].key ||
+                    items[i].draw != reference[i].draw) {
+                    throw std::runtime_error(
+                        std::string(sortCase.name) +
+                        " order differs from std::stable_sort at " +
+                        std::to_string(i));
+                }
+            }
+        }
+
+        const double time = total / std::max(measuredIterations, 1u);
+        report.AddRow(sortCase.name)
+            .Set("draws", static_cast<double>(drawCount))
+            .Set("sort_ms", time)
+            .Set("ns_per_draw",
+                 time * 1e6 /
+                     std::max<double>(static_cast<double>(drawCount), 1.0));
+
+        std::cout << sortCase.name << ": " << drawCount << " draws in "
+                  << time << " ms" << std::endl;
+    }
+
+    for (const bool bSorted : {false, true}) {
+        const FBindCounts binds =
+            CountBinds(bSorted ? reference : submitted);
+
+        report.AddRow(bSorted ? "binds_sorted" : "binds_submitted")
+            .Set("draws", static_cast<double>(drawCount))
+            .Set("pipeline_binds", static_cast<double>(binds.pipelines))
+            .Set("material_binds", static_cast<double>(binds.materials));
+    }
+}
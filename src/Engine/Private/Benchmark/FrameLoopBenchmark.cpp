@@ -0,0 +1,98 @@
+#include "Benchmark/FrameLoopBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/AllocationTracker.h"
+#include "Core/CommandLine.h"
+#include "VulkanRHI/VulkanRHI.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+FFrameLoopBenchmark::FFrameLoopBenchmark(FVulkanRHI* rhi)
+    : rhi(rhi),
+      warmupFrames(static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredFrames(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 1000))),
+      maxFrameAllocations(
+          static_cast<uint64_t>(FCommandLine::GetInt("maxframeallocs", 0)))
+{
+}
+
+void FFrameLoopBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (!FAllocationTracker::IsEnabled()) {
+        std::cout << "Allocation tracking is disabled, configure with "
+                     "-DENGINE_ALLOCATION_TRACKING=ON to count allocations"
+                  << std::endl;
+    }
+
+    for (uint32_t i = 0; i < warmupFrames; i++) {
+        if (!rhi->PollEvents()) {
+            return;
+        }
+        rhi->Draw();
+    }
+
+    uint32_t frames = 0;
+    uint64_t totalAllocations = 0;
+    uint64_t totalBytes = 0;
+    uint64_t maxAllocations = 0;
+    uint32_t allocatingFrames = 0;
+    uint64_t threadAllocations = 0;
+    double cpuTotal = 0.0;
+
+    for (; frames < measuredFrames; frames++) {
+        // Event polling belongs to the platform layer, only Draw is checked
+        if (!rhi->PollEvents()) {
+            break;
+        }
+
+        // Workers of the thread pool, streaming reads and the readback
+        // consumer allocate on other threads, the global counters see them
+        const FAllocationStats before = FAllocationTracker::GetGlobalStats();
+        const FAllocationStats threadBefore =
+            FAllocationTracker::GetThreadStats();
+        const auto begin = Clock::now();
+
+        rhi->Draw();
+
+        const auto end = Clock::now();
+        const FAllocationStats delta =
+            FAllocationTracker::GetGlobalStats() - before;
+        threadAllocations +=
+            (FAllocationTracker::GetThreadStats() - threadBefore).allocations;
+
+        cpuTotal +=
+            std::chrono::duration<double, std::milli>(end - begin).count();
+
+        totalAllocations += delta.allocations;
+        totalBytes += delta.bytesAllocated;
+        maxAllocations = std::max(maxAllocations, delta.allocations);
+        if (delta.allocations > 0) {
+            allocatingFrames += 1;
+        }
+    }
+
+    const double frameCount = std::max(frames, 1u);
+
+    report.AddRow("steady_state")
+        .Set("frames", frames)
+        .Set("cpu_ms", cpuTotal / frameCount)
+        .Set("allocs_per_frame", totalAllocations / frameCount)
+        .Set("alloc_bytes_per_frame", totalBytes / frameCount)
+        .Set("max_allocs_per_frame", static_cast<double>(maxAllocations))
+        .Set("allocating_frames", allocatingFrames)
+        .Set("render_thread_allocs_per_frame", threadAllocations / frameCount);
+
+    if (FAllocationTracker::IsEnabled() &&
+        maxAllocations > maxFrameAllocations) {
+        throw std::runtime_error(
+            "Steady state frame allocated " + std::to_string(maxAllocations) +
+            " times, allowed " + std::to_string(maxFrameAllocations));
+    }
+}
@@ -0,0 +1,147 @@
+#include "Benchmark/InstanceBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/AllocationTracker.h"
+#include "Core/CommandLine.h"
+#include "VulkanRHI/InstanceData.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanRHI.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<FInstanceData> MakeInstanceGrid(uint32_t count)
+{
+    const uint32_t side =
+        static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cellSize = 2.0f / static_cast<float>(side);
+
+    std::vector<FInstanceData> instances(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t x = i % side;
+        const uint32_t y = i / side;
+
+        instances[i] = {
+            .offset = {-1.0f + cellSize * (static_cast<float>(x) + 0.5f),
+                       -1.0f + cellSize * (static_cast<float>(y) + 0.5f)},
+            .scale = cellSize * 0.8f,
+            .padding = 0.0f,
+        };
+    }
+
+    return instances;
+}
+} // namespace
+
+FInstanceBenchmark::FInstanceBenchmark(FVulkanRHI* rhi)
+    : rhi(rhi),
+      maxInstances(static_cast<uint32_t>(
+          FCommandLine::GetInt("maxinstances", 1'000'000))),
+      warmupFrames(static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredFrames(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FInstanceBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+
+    FVulkanDevice* device =
+        rhi->GetInstance()->GetPhysicalDevice()->GetLogicalDevice();
+
+    for (uint64_t count = 1; count <= maxInstances; count *= 10) {
+        const auto instances = MakeInstanceGrid(static_cast<uint32_t>(count));
+        device->SetInstanceData(instances);
+
+        for (uint32_t i = 0; i < warmupFrames; i++) {
+            if (!rhi->PollEvents()) {
+                return;
+            }
+            rhi->Draw();
+        }
+
+        double frameTotal = 0.0;
+        double recordTotal = 0.0;
+        double fenceWaitTotal = 0.0;
+        double gpuTotal = 0.0;
+        uint32_t gpuSamples = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t threadAllocations = 0;
+        FCommandListStats commands;
+
+        for (uint32_t i = 0; i < measuredFrames; i++) {
+            if (!rhi->PollEvents()) {
+                return;
+            }
+
+            // Global, the culling and streaming workers allocate too
+            const FAllocationStats allocsBefore =
+                FAllocationTracker::GetGlobalStats();
+            const FAllocationStats threadAllocsBefore =
+                FAllocationTracker::GetThreadStats();
+            const auto begin = Clock::now();
+
+            rhi->Draw();
+
+            const auto end = Clock::now();
+            const FAllocationStats allocs =
+                FAllocationTracker::GetGlobalStats() - allocsBefore;
+
+            allocations += allocs.allocations;
+            allocatedBytes += allocs.bytesAllocated;
+            threadAllocations += (FAllocationTracker::GetThreadStats() -
+                                  threadAllocsBefore)
+                                     .allocations;
+            commands += device->GetLastCommandStats();
+
+            // The frame time includes the fence wait and a present that may
+            // wait for vsync, only recording scales with the instances
+            frameTotal +=
+                std::chrono::duration<double, std::milli>(end - begin).count();
+            recordTotal += device->GetLastRecordTime();
+            fenceWaitTotal += device->GetLastFenceWaitTime();
+
+            // Resolved when the frame starts, so this is the previous frame
+            if (const auto gpuTime = device->GetLastGpuTime()) {
+                gpuTotal += *gpuTime;
+                gpuSamples += 1;
+            }
+        }
+
+        const double frameCount = std::max(measuredFrames, 1u);
+        const double cpuTime = recordTotal / frameCount;
+        const double gpuTime = gpuSamples > 0
+                                   ? gpuTotal / gpuSamples
+                                   : std::numeric_limits<double>::quiet_NaN();
+
+        report.AddRow("instances_" + std::to_string(count))
+            .Set("instances", static_cast<double>(count))
+            .Set("triangles",
+                 static_cast<double>(device->GetSceneTriangleCount()))
+            .Set("frame_ms", frameTotal / frameCount)
+            .Set("fence_wait_ms", fenceWaitTotal / frameCount)
+            .Set("cpu_ms", cpuTime)
+            .Set("gpu_ms", gpuTime)
+            .Set("cpu_ns_per_instance", cpuTime * 1e6 / count)
+            .Set("gpu_ns_per_instance", gpuTime * 1e6 / count)
+            .Set("allocs_per_frame", allocations / frameCount)
+            .Set("alloc_bytes_per_frame", allocatedBytes / frameCount)
+            .Set("render_thread_allocs_per_frame",
+                 threadAllocations / frameCount)
+            .Set("commands_issued", commands.issued / frameCount)
+            .Set("commands_filtered", commands.filtered / frameCount);
+
+        std::cout << "Instances " << count << ": cpu " << cpuTime
+                  << " ms, gpu " << gpuTime << " ms" << std::endl;
+    }
+}
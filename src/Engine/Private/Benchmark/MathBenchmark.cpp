@@ -0,0 +1,221 @@
+#include "Benchmark/MathBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "Math/MathBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Relative to the magnitude of the values, FMA and reassociation move the
+// last bits
+constexpr float Tolerance = 1e-5f;
+
+float GetMaxError(const std::vector<float>& reference,
+                  const std::vector<float>& result)
+{
+    float maxError = 0.0f;
+    for (size_t i = 0; i < reference.size(); i++) {
+        const float magnitude = std::max(std::abs(reference[i]), 1.0f);
+        maxError =
+            std::max(maxError, std::abs(reference[i] - result[i]) / magnitude);
+    }
+    return maxError;
+}
+
+// Columns of float arrays behind the structure of arrays views
+struct FStreams {
+    std::vector<std::vector<float>> columns;
+
+    FStreams(size_t columnCount, size_t count)
+        : columns(columnCount, std::vector<float>(count))
+    {
+    }
+
+    float* operator[](size_t column) { return columns[column].data(); }
+
+    std::vector<float> Flatten() const
+    {
+        std::vector<float> values;
+        for (const std::vector<float>& column : columns) {
+            values.insert(values.end(), column.begin(), column.end());
+        }
+        return values;
+    }
+};
+
+FPointArrays GetPoints(FStreams& streams)
+{
+    return {streams[0], streams[1], streams[2], streams.columns[0].size()};
+}
+
+FBoundsArrays GetBounds(FStreams& streams)
+{
+    return {streams[0], streams[1], streams[2], streams[3],
+            streams[4], streams[5], streams.columns[0].size()};
+}
+
+FSphereArrays GetSpheres(FStreams& streams)
+{
+    return {streams[0], streams[1], streams[2], streams[3],
+            streams.columns[0].size()};
+}
+
+} // namespace
+
+FMathBenchmark::FMathBenchmark()
+    : elementCount(
+          static_cast<uint32_t>(FCommandLine::GetInt("mathcount", 1'000'000))),
+      warmupIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FMathBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> positive(0.1f, 10.0f);
+
+    const FMatrix4 matrix = FMatrix4::FromTransform(
+        {12.0f, -3.0f, 40.0f},
+        FQuaternion::FromAxisAngle(Normalize(FVector3{1.0f, 2.0f, 3.0f}),
+                                   0.7f),
+        {2.0f, 0.5f, 1.5f});
+
+    // Six input columns cover every kernel, extents and radii are positive
+    FStreams input(6, elementCount);
+    for (size_t column = 0; column < 6; column++) {
+        for (float& value : input.columns[column]) {
+            value = column < 3 ? distribution(random) : positive(random);
+        }
+    }
+
+    std::vector<FMatrix4> matricesA(elementCount / 16 + 1);
+    std::vector<FMatrix4> matricesB(matricesA.size());
+    for (size_t i = 0; i < matricesA.size(); i++) {
+        const FQuaternion rotation = FQuaternion::FromAxisAngle(
+            Normalize(FVector3{distribution(random), distribution(random),
+                               distribution(random)}),
+            distribution(random));
+        matricesA[i] = FMatrix4::FromTransform(
+            {distribution(random), distribution(random), distribution(random)},
+            rotation, {positive(random), positive(random), positive(random)});
+        matricesB[i] = Transpose(matricesA[i]);
+    }
+
+    struct FKernel {
+        const char* name;
+        size_t elements;
+        size_t columns;
+        std::function<void(FStreams&, EMathBackend)> run;
+        std::function<std::vector<float>(FStreams&)> flatten;
+    };
+
+    std::vector<FMatrix4> matrixOutput(matricesA.size());
+    const auto flattenStreams = [](FStreams& output) {
+        return output.Flatten();
+    };
+    const auto flattenMatrices = [&](FStreams&) {
+        std::vector<float> values;
+        for (const FMatrix4& result : matrixOutput) {
+            values.insert(values.end(), &result.m[0][0],
+                          &result.m[0][0] + 16);
+        }
+        return values;
+    };
+
+    const FKernel kernels[] = {
+        {"points", elementCount, 3,
+         [&](FStreams& output, EMathBackend backend) {
+             FMathBatch::TransformPoints(matrix, GetPoints(input),
+                                         GetPoints(output), backend);
+         },
+         flattenStreams},
+        {"bounds", elementCount, 6,
+         [&](FStreams& output, EMathBackend backend) {
+             FMathBatch::TransformBounds(matrix, GetBounds(input),
+                                         GetBounds(output), backend);
+         },
+         flattenStreams},
+        {"spheres", elementCount, 4,
+         [&](FStreams& output, EMathBackend backend) {
+             FMathBatch::TransformSpheres(matrix, GetSpheres(input),
+                                          GetSpheres(output), backend);
+         },
+         flattenStreams},
+        {"matrices", matricesA.size(), 0,
+         [&](FStreams&, EMathBackend backend) {
+             FMathBatch::MultiplyMatrices(matricesA.data(), matricesB.data(),
+                                          matrixOutput.data(),
+                                          matrixOutput.size(), backend);
+         },
+         flattenMatrices},
+    };
+
+    std::cout << "Math backend " << FMathBatch::GetNativeBackendName() << ", "
+              << FMathBatch::GetNativeWidth() << " lanes" << std::endl;
+
+    for (const FKernel& kernel : kernels) {
+        FStreams output(kernel.columns, elementCount);
+
+        kernel.run(output, EMathBackend::Scalar);
+        const std::vector<float> reference = kernel.flatten(output);
+        kernel.run(output, EMathBackend::Native);
+        const float maxError = GetMaxError(reference, kernel.flatten(output));
+
+        if (maxError > Tolerance) {
+            throw std::runtime_error(
+                std::string(FMathBatch::GetNativeBackendName()) + " " +
+                kernel.name + " differ from the scalar path by " +
+                std::to_string(maxError));
+        }
+
+        double times[2] = {};
+        const EMathBackend backends[2] = {EMathBackend::Scalar,
+                                          EMathBackend::Native};
+        for (size_t b = 0; b < 2; b++) {
+            for (uint32_t i = 0; i < warmupIterations; i++) {
+                kernel.run(output, backends[b]);
+            }
+
+            const auto begin = Clock::now();
+            for (uint32_t i = 0; i < measuredIterations; i++) {
+                kernel.run(output, backends[b]);
+            }
+            const auto end = Clock::now();
+
+            times[b] = std::chrono::duration<double, std::nano>(end - begin)
+                           .count() /
+                       std::max<double>(
+                           static_cast<double>(measuredIterations) *
+                               static_cast<double>(kernel.elements),
+                           1.0);
+        }
+
+        report.AddRow(kernel.name)
+            .Set("elements", static_cast<double>(kernel.elements))
+            .Set("scalar_ns_per_element", times[0])
+            .Set("native_ns_per_element", times[1])
+            .Set("speedup", times[1] > 0.0 ? times[0] / times[1] : 0.0)
+            .Set("max_relative_error", maxError);
+
+        std::cout << kernel.name << ": scalar " << times[0] << " ns, "
+                  << FMathBatch::GetNativeBackendName() << " " << times[1]
+                  << " ns per element" << std::endl;
+    }
+}
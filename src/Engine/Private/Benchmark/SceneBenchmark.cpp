@@ -0,0 +1,207 @@
+#include "Benchmark/SceneBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "Core/EntityWorld.h"
+#include "Core/SceneComponents.h"
+#include "Core/ThreadPool.h"
+#include "VulkanRHI/InstanceData.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanRHI.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Only the moving entities have one, so the scene spans two archetypes
+struct FVelocity {
+    float linear[3];
+    float padding;
+};
+
+constexpr float TimeStep = 1.0f / 60.0f;
+
+void PopulateWorld(FEntityWorld& world, uint32_t count)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> speed(-0.2f, 0.2f);
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(count));
+
+    for (uint32_t i = 0; i < count; i++) {
+        const FTransform transform = {
+            .position = {position(random), position(random), 0.0f},
+            .scale = scale,
+            .rotation = {0.0f, 0.0f, 0.0f, 1.0f},
+        };
+        const FRenderData renderData = {
+            .mesh = 0,
+            .material = i % 4,
+            .localRadius = 1.0f,
+            .flags = 0,
+        };
+
+        if (i % 4 == 0) {
+            world.Create(transform, FBounds{}, renderData);
+        } else {
+            const FVelocity velocity = {
+                .linear = {speed(random), speed(random), 0.0f},
+                .padding = 0.0f,
+            };
+            world.Create(transform, FBounds{}, renderData, velocity);
+        }
+    }
+}
+
+template <typename... Ts, typename Fn>
+void RunChunks(const FEntityWorld& world, bool bParallel, Fn&& fn)
+{
+    if (bParallel) {
+        world.ParallelForEachChunk<Ts...>(FThreadPool::Get(), fn);
+    } else {
+        world.ForEachChunk<Ts...>(fn);
+    }
+}
+
+// Moves along the velocity and bounces off the edges of the view
+void Simulate(const FEntityWorld& world, bool bParallel)
+{
+    RunChunks<FTransform, const FVelocity>(
+        world, bParallel,
+        [](size_t, size_t count, FTransform* transforms,
+           const FVelocity* velocities) {
+            for (size_t i = 0; i < count; i++) {
+                for (size_t axis = 0; axis < 2; axis++) {
+                    float& position = transforms[i].position[axis];
+                    position += velocities[i].linear[axis] * TimeStep;
+                    position = std::clamp(position, -1.0f, 1.0f);
+                }
+            }
+        });
+}
+
+void UpdateBounds(const FEntityWorld& world, bool bParallel)
+{
+    RunChunks<const FTransform, const FRenderData, FBounds>(
+        world, bParallel,
+        [](size_t, size_t count, const FTransform* transforms,
+           const FRenderData* renderData, FBounds* bounds) {
+            for (size_t i = 0; i < count; i++) {
+                bounds[i] = {
+                    .center = {transforms[i].position[0],
+                               transforms[i].position[1],
+                               transforms[i].position[2]},
+                    .radius = transforms[i].scale * renderData[i].localRadius,
+                };
+            }
+        });
+}
+
+// Each chunk writes the instances from its first matching index on
+void GatherInstances(const FEntityWorld& world, bool bParallel,
+                     std::vector<FInstanceData>& instances)
+{
+    instances.resize(world.Count<const FBounds, const FRenderData>());
+
+    RunChunks<const FBounds, const FRenderData>(
+        world, bParallel,
+        [&instances](size_t first, size_t count, const FBounds* bounds,
+                     const FRenderData*) {
+            for (size_t i = 0; i < count; i++) {
+                instances[first + i] = {
+                    .offset = {bounds[i].center[0], bounds[i].center[1]},
+                    .scale = bounds[i].radius,
+                    .padding = 0.0f,
+                };
+            }
+        });
+}
+
+} // namespace
+
+FSceneBenchmark::FSceneBenchmark(FVulkanRHI* rhi)
+    : rhi(rhi),
+      entityCount(
+          static_cast<uint32_t>(FCommandLine::GetInt("entities", 500'000))),
+      warmupFrames(static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredFrames(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FSceneBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    FVulkanDevice* device =
+        rhi->GetInstance()->GetPhysicalDevice()->GetLogicalDevice();
+
+    FEntityWorld world;
+    PopulateWorld(world, entityCount);
+
+    std::vector<FInstanceData> instances;
+
+    for (const bool bParallel : {false, true}) {
+        double simulateTotal = 0.0;
+        double boundsTotal = 0.0;
+        double gatherTotal = 0.0;
+        double drawTotal = 0.0;
+
+        for (uint32_t frame = 0; frame < warmupFrames + measuredFrames;
+             frame++) {
+            if (!rhi->PollEvents()) {
+                return;
+            }
+
+            const auto begin = Clock::now();
+            Simulate(world, bParallel);
+            const auto simulated = Clock::now();
+            UpdateBounds(world, bParallel);
+            const auto bounded = Clock::now();
+            GatherInstances(world, bParallel, instances);
+            const auto gathered = Clock::now();
+
+            device->SetInstanceData(instances);
+            rhi->Draw();
+            const auto drawn = Clock::now();
+
+            if (frame < warmupFrames) {
+                continue;
+            }
+            simulateTotal += Milliseconds(simulated - begin).count();
+            boundsTotal += Milliseconds(bounded - simulated).count();
+            gatherTotal += Milliseconds(gathered - bounded).count();
+            drawTotal += Milliseconds(drawn - gathered).count();
+        }
+
+        const double frameCount = std::max(measuredFrames, 1u);
+        const double updateTime =
+            (simulateTotal + boundsTotal + gatherTotal) / frameCount;
+        const double entities =
+            static_cast<double>(std::max<size_t>(world.GetEntityCount(), 1));
+
+        report.AddRow(bParallel ? "parallel" : "serial")
+            .Set("entities", static_cast<double>(world.GetEntityCount()))
+            .Set("archetypes", static_cast<double>(world.GetArchetypeCount()))
+            .Set("chunks", static_cast<double>(world.GetChunkCount()))
+            .Set("simulate_ms", simulateTotal / frameCount)
+            .Set("bounds_ms", boundsTotal / frameCount)
+            .Set("gather_ms", gatherTotal / frameCount)
+            .Set("draw_ms", drawTotal / frameCount)
+            .Set("update_ns_per_entity", updateTime * 1e6 / entities);
+
+        std::cout << (bParallel ? "Parallel" : "Serial") << " update of "
+                  << world.GetEntityCount() << " entities: " << updateTime
+                  << " ms" << std::endl;
+    }
+}
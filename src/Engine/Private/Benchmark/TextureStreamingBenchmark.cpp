@@ -0,0 +1,150 @@
+#include "Benchmark/TextureStreamingBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "VulkanRHI/Ktx2TextureSource.h"
+#include "VulkanRHI/TextureSource.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanRHI.h"
+#include "VulkanRHI/VulkanTextureStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+FTextureStreamingBenchmark::FTextureStreamingBenchmark(FVulkanRHI* rhi)
+    : rhi(rhi),
+      textureCount(static_cast<uint32_t>(
+          std::max<int64_t>(FCommandLine::GetInt("textures", 64), 1))),
+      textureSize(static_cast<uint32_t>(
+          std::max<int64_t>(FCommandLine::GetInt("texturesize", 2048), 1))),
+      textureFile(FCommandLine::GetString("texturefile", "")),
+      warmupFrames(static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredFrames(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 600)))
+{
+}
+
+void FTextureStreamingBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+
+    FVulkanDevice* device =
+        rhi->GetInstance()->GetPhysicalDevice()->GetLogicalDevice();
+    FVulkanTextureStreamer* streamer = device->GetTextureStreamer();
+
+    std::vector<FTextureHandle> handles;
+    vk::DeviceSize totalBytes = 0;
+    vk::DeviceSize tailBytes = 0;
+
+    for (uint32_t i = 0; i < textureCount; i++) {
+        std::unique_ptr<FTextureSource> source;
+        if (textureFile.empty()) {
+            source = std::make_unique<FProceduralTextureSource>(
+                vk::Extent2D{textureSize, textureSize}, i);
+        } else {
+            source = std::make_unique<FKtx2TextureSource>(
+                textureFile, *device->GetPhysicalDevice());
+        }
+
+        for (uint32_t mip = 0; mip < source->GetMipCount(); mip++) {
+            const vk::Extent2D extent = source->GetMipExtent(mip);
+            totalBytes += source->GetMipSize(mip);
+            if (std::max(extent.width, extent.height) <= 64) {
+                tailBytes += source->GetMipSize(mip);
+            }
+        }
+
+        handles.push_back(streamer->AddTexture(std::move(source)));
+    }
+
+    const vk::DeviceSize budgetBytes = streamer->GetStats().budgetBytes;
+    std::cout << "Streaming " << (totalBytes >> 20)
+              << " MiB of textures with a " << (budgetBytes >> 20)
+              << " MiB budget" << std::endl;
+
+    // The texture under the focus covers the whole screen height, its
+    // neighbours get smaller with the distance
+    const float screenHeight =
+        static_cast<float>(device->GetSwapChain()->GetExtent().height);
+
+    const auto requestFrame = [&](uint32_t frame, uint32_t frameCount) {
+        const float focus = static_cast<float>(textureCount) *
+                            static_cast<float>(frame) /
+                            static_cast<float>(std::max(frameCount, 1u));
+
+        for (uint32_t i = 0; i < textureCount; i++) {
+            const float distance = std::abs(static_cast<float>(i) - focus);
+            streamer->RequestScreenSize(handles[i],
+                                        screenHeight / (1.0f + distance));
+        }
+    };
+
+    for (uint32_t i = 0; i < warmupFrames; i++) {
+        if (!rhi->PollEvents()) {
+            return;
+        }
+        requestFrame(0, measuredFrames);
+        rhi->Draw();
+    }
+
+    const FTextureStreamingStats startStats = streamer->GetStats();
+
+    uint32_t frames = 0;
+    double cpuTotal = 0.0;
+    double starvedTotal = 0.0;
+    vk::DeviceSize peakCommitted = 0;
+
+    for (; frames < measuredFrames; frames++) {
+        if (!rhi->PollEvents()) {
+            break;
+        }
+
+        requestFrame(frames, measuredFrames);
+
+        const auto begin = Clock::now();
+        rhi->Draw();
+        const auto end = Clock::now();
+
+        cpuTotal +=
+            std::chrono::duration<double, std::milli>(end - begin).count();
+
+        const FTextureStreamingStats& stats = streamer->GetStats();
+        starvedTotal += stats.starvedTextures;
+        peakCommitted = std::max(peakCommitted, stats.committedBytes);
+    }
+
+    const FTextureStreamingStats& stats = streamer->GetStats();
+    const double frameCount = std::max(frames, 1u);
+    constexpr double MiB = 1024.0 * 1024.0;
+
+    report.AddRow("sweep")
+        .Set("frames", frames)
+        .Set("textures", textureCount)
+        .Set("cpu_ms", cpuTotal / frameCount)
+        .Set("budget_mib", budgetBytes / MiB)
+        .Set("peak_committed_mib", peakCommitted / MiB)
+        .Set("peak_resident_mib", stats.peakResidentBytes / MiB)
+        .Set("streamed_mips",
+             static_cast<double>(stats.streamedMips - startStats.streamedMips))
+        .Set("evicted_mips",
+             static_cast<double>(stats.evictedMips - startStats.evictedMips))
+        .Set("starved_textures_per_frame", starvedTotal / frameCount);
+
+    for (FTextureHandle handle : handles) {
+        streamer->RemoveTexture(handle);
+    }
+
+    if (peakCommitted > budgetBytes + tailBytes) {
+        throw std::runtime_error(
+            "Texture streaming committed " +
+            std::to_string(peakCommitted >> 20) + " MiB, budget is " +
+            std::to_string(budgetBytes >> 20) + " MiB");
+    }
+}
@@ -0,0 +1,160 @@
+#include "Benchmark/TransformBenchmark.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Core/CommandLine.h"
+#include "Core/ThreadPool.h"
+#include "Core/TransformHierarchy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t RootCount = 256;
+
+FLocalTransform GetAnimatedTransform(uint32_t node, uint32_t iteration)
+{
+    const float angle = static_cast<float>(node % 7 + iteration) * 0.1f;
+    return {
+        .position = {static_cast<float>(node % 13), 1.0f, 0.0f},
+        .rotation = FQuaternion::FromAxisAngle({0.0f, 1.0f, 0.0f}, angle),
+        .scale = {1.0f, 1.0f, 1.0f},
+    };
+}
+
+} // namespace
+
+FTransformBenchmark::FTransformBenchmark()
+    : nodeCount(static_cast<uint32_t>(
+          FCommandLine::GetInt("transformnodes", 1'000'000))),
+      animatedCount(static_cast<uint32_t>(
+          FCommandLine::GetInt("animatednodes", 1'000))),
+      warmupIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("warmup", 10))),
+      measuredIterations(
+          static_cast<uint32_t>(FCommandLine::GetInt("frames", 100)))
+{
+}
+
+void FTransformBenchmark::Run(FBenchmarkReport& report)
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+    // Parents come from the first half of the nodes before, which gives
+    // subtrees of all sizes about six levels deep
+    FTransformHierarchy hierarchy;
+    std::vector<uint32_t> nodes;
+    nodes.reserve(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const uint32_t parent =
+            i < RootCount
+                ? InvalidTransformNode
+                : nodes[std::uniform_int_distribution<uint32_t>(
+                      0, i / 2)(random)];
+        const FLocalTransform local = {
+            .position = {offset(random), offset(random), offset(random)},
+            .rotation = FQuaternion::FromAxisAngle({0.0f, 0.0f, 1.0f},
+                                                   offset(random)),
+            .scale = {1.0f, 1.0f, 1.0f},
+        };
+        nodes.push_back(hierarchy.Add(parent, local));
+    }
+    hierarchy.Update();
+
+    std::vector<uint32_t> animated(std::min(animatedCount, nodeCount));
+    for (uint32_t& node : animated) {
+        node = nodes[std::uniform_int_distribution<uint32_t>(
+            0, nodeCount - 1)(random)];
+    }
+
+    struct FCase {
+        const char* name;
+        bool bAnimated;
+        bool bParallel;
+    };
+    const FCase cases[] = {
+        {"full_serial", false, false},
+        {"full_parallel", false, true},
+        {"animated_serial", true, false},
+        {"animated_parallel", true, true},
+    };
+
+    uint32_t iteration = 0;
+    for (const FCase& benchmarkCase : cases) {
+        double total = 0.0;
+        size_t updated = 0;
+
+        for (uint32_t i = 0; i < warmupIterations + measuredIterations;
+             i++, iteration++) {
+            const auto begin = Clock::now();
+
+            if (benchmarkCase.bAnimated) {
+                for (const uint32_t node : animated) {
+                    hierarchy.SetLocal(node,
+                                       GetAnimatedTransform(node, iteration));
+                }
+            } else {
+                for (uint32_t root = 0; root < RootCount; root++) {
+                    hierarchy.SetLocal(nodes[root],
+                                       GetAnimatedTransform(root, iteration));
+                }
+            }
+
+            if (benchmarkCase.bParallel) {
+                hierarchy.ParallelUpdate(FThreadPool::Get());
+            } else {
+                hierarchy.Update();
+            }
+
+            if (i >= warmupIterations) {
+                total += Milliseconds(Clock::now() - begin).count();
+                updated += hierarchy.GetUpdatedCount();
+            }
+        }
+
+        const double iterations = std::max(measuredIterations, 1u);
+        report.AddRow(benchmarkCase.name)
+            .Set("nodes", static_cast<double>(hierarchy.GetNodeCount()))
+            .Set("levels", static_cast<double>(hierarchy.GetLevelCount()))
+            .Set("updated_nodes", static_cast<double>(updated) / iterations)
+            .Set("update_ms", total / iterations)
+            .Set("ns_per_updated_node",
+                 total * 1e6 / std::max<double>(static_cast<double>(updated),
+                                                1.0));
+
+        std::cout << benchmarkCase.name << ": "
+                  << static_cast<double>(updated) / iterations
+                  << " nodes updated in " << total / iterations << " ms"
+                  << std::endl;
+    }
+
+    // The incremental updates have to end where a full update does
+    std::vector<FMatrix4> incremental(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        incremental[i] = hierarchy.GetWorld(nodes[i]);
+    }
+    for (uint32_t root = 0; root < std::min(RootCount, nodeCount); root++) {
+        hierarchy.SetLocal(nodes[root], hierarchy.GetLocal(nodes[root]));
+    }
+    hierarchy.Update();
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (std::memcmp(&incremental[i], &hierarchy.GetWorld(nodes[i]),
+                        sizeof(FMatrix4)) != 0) {
+            throw std::runtime_error("Incremental transform of node " +
+                                     std::to_string(nodes[i]) +
+                                     " differs from a full update");
+        }
+    }
+}
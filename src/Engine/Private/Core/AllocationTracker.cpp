@@ -0,0 +1,229 @@
+#include "Core/AllocationTracker.h"
+
+#include "Definition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct FAtomicStats {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytesAllocated{0};
+    std::atomic<uint64_t> bytesFreed{0};
+
+    FAllocationStats Load() const
+    {
+        return {
+            .allocations = allocations.load(std::memory_order_relaxed),
+            .frees = frees.load(std::memory_order_relaxed),
+            .bytesAllocated = bytesAllocated.load(std::memory_order_relaxed),
+            .bytesFreed = bytesFreed.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+struct FTagSlot {
+    std::atomic<const char*> tag{nullptr};
+    FAtomicStats stats;
+};
+
+// Zero initialized, so usable before any static constructor has run
+FAtomicStats GlobalStats;
+FTagSlot TagSlots[FAllocationTracker::MaxTags];
+
+thread_local FAllocationStats ThreadStats;
+thread_local const char* ThreadTag = nullptr;
+
+[[maybe_unused]] FAtomicStats* FindTagStats(const char* tag)
+{
+    if (tag == nullptr) {
+        return nullptr;
+    }
+
+    for (FTagSlot& slot : TagSlots) {
+        const char* current = slot.tag.load(std::memory_order_acquire);
+        if (current == tag) {
+            return &slot.stats;
+        }
+
+        if (current == nullptr) {
+            const char* expected = nullptr;
+            if (slot.tag.compare_exchange_strong(expected, tag) ||
+                expected == tag) {
+                return &slot.stats;
+            }
+        }
+    }
+
+    // Table full, the allocation is still counted globally
+    return nullptr;
+}
+
+#if WITH_ALLOCATION_TRACKING
+
+// Stored in front of every block so delete knows the size and the tag
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FAllocationHeader {
+    void* base;
+    size_t size;
+    FAtomicStats* tagStats;
+};
+
+void RecordAllocation(FAtomicStats* tagStats, size_t size)
+{
+    GlobalStats.allocations.fetch_add(1, std::memory_order_relaxed);
+    GlobalStats.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+    ThreadStats.allocations += 1;
+    ThreadStats.bytesAllocated += size;
+
+    if (tagStats != nullptr) {
+        tagStats->allocations.fetch_add(1, std::memory_order_relaxed);
+        tagStats->bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void RecordFree(FAtomicStats* tagStats, size_t size)
+{
+    GlobalStats.frees.fetch_add(1, std::memory_order_relaxed);
+    GlobalStats.bytesFreed.fetch_add(size, std::memory_order_relaxed);
+
+    ThreadStats.frees += 1;
+    ThreadStats.bytesFreed += size;
+
+    if (tagStats != nullptr) {
+        tagStats->frees.fetch_add(1, std::memory_order_relaxed);
+        tagStats->bytesFreed.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void* TrackedAllocate(size_t size, size_t alignment, bool bNoThrow)
+{
+    alignment = std::max(alignment, alignof(FAllocationHeader));
+
+    const size_t total = size + alignment + sizeof(FAllocationHeader);
+
+    void* base = std::malloc(total);
+    if (base == nullptr) {
+        if (bNoThrow) {
+            return nullptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    const uintptr_t first =
+        reinterpret_cast<uintptr_t>(base) + sizeof(FAllocationHeader);
+    const uintptr_t aligned = (first + alignment - 1) & ~(alignment - 1);
+
+    FAtomicStats* tagStats = FindTagStats(ThreadTag);
+
+    FAllocationHeader* header =
+        reinterpret_cast<FAllocationHeader*>(aligned) - 1;
+    header->base = base;
+    header->size = size;
+    header->tagStats = tagStats;
+
+    RecordAllocation(tagStats, size);
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+void TrackedFree(void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    FAllocationHeader* header = static_cast<FAllocationHeader*>(ptr) - 1;
+    RecordFree(header->tagStats, header->size);
+
+    std::free(header->base);
+}
+
+#endif
+} // namespace
+
+#if WITH_ALLOCATION_TRACKING
+
+// Array and nothrow forms forward to these by default
+void* operator new(size_t size)
+{
+    return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, false);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return TrackedAllocate(size, static_cast<size_t>(alignment), false);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, true);
+}
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    TrackedFree(ptr);
+}
+
+#endif
+
+bool FAllocationTracker::IsEnabled() { return WITH_ALLOCATION_TRACKING; }
+
+FAllocationStats FAllocationTracker::GetThreadStats() { return ThreadStats; }
+
+FAllocationStats FAllocationTracker::GetGlobalStats()
+{
+    return GlobalStats.Load();
+}
+
+FAllocationStats FAllocationTracker::GetTagStats(const char* tag)
+{
+    for (const FTagSlot& slot : TagSlots) {
+        if (slot.tag.load(std::memory_order_acquire) == tag) {
+            return slot.stats.Load();
+        }
+    }
+    return {};
+}
+
+std::vector<std::pair<std::string, FAllocationStats>>
+FAllocationTracker::GetAllTagStats()
+{
+    std::vector<std::pair<std::string, FAllocationStats>> result;
+
+    for (const FTagSlot& slot : TagSlots) {
+        const char* tag = slot.tag.load(std::memory_order_acquire);
+        if (tag == nullptr) {
+            break;
+        }
+        result.emplace_back(tag, slot.stats.Load());
+    }
+
+    return result;
+}
+
+const char* FAllocationTracker::GetCurrentTag() { return ThreadTag; }
+
+FScopedAllocationTag::FScopedAllocationTag(const char* tag)
+    : previousTag(ThreadTag)
+{
+    ThreadTag = tag;
+}
+
+FScopedAllocationTag::~FScopedAllocationTag() { ThreadTag = previousTag; }
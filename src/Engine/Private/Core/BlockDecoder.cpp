@@ -0,0 +1,189 @@
+#include "Core/BlockDecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace
+{
+
+using FBlockTexels = std::array<std::array<uint8_t, 4>, 16>;
+
+uint64_t ReadLittleEndian(const uint8_t* data, uint32_t bytes)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (i * 8);
+    }
+    return value;
+}
+
+std::array<uint8_t, 4> Expand565(uint16_t color)
+{
+    const uint32_t r = (color >> 11) & 0x1f;
+    const uint32_t g = (color >> 5) & 0x3f;
+    const uint32_t b = color & 0x1f;
+
+    return {static_cast<uint8_t>((r << 3) | (r >> 2)),
+            static_cast<uint8_t>((g << 2) | (g >> 4)),
+            static_cast<uint8_t>((b << 3) | (b >> 2)), 255};
+}
+
+// BC2 and BC3 always use four colors, BC1 switches to three colors and
+// transparent black when color0 <= color1
+void DecodeColorBlock(const uint8_t* block, bool bAllowPunchThrough,
+                      FBlockTexels& texels)
+{
+    const uint16_t color0 = static_cast<uint16_t>(ReadLittleEndian(block, 2));
+    const uint16_t color1 =
+        static_cast<uint16_t>(ReadLittleEndian(block + 2, 2));
+
+    std::array<std::array<uint8_t, 4>, 4> palette;
+    palette[0] = Expand565(color0);
+    palette[1] = Expand565(color1);
+
+    const bool bFourColors = !bAllowPunchThrough || color0 > color1;
+
+    for (uint32_t c = 0; c < 3; c++) {
+        const uint32_t a = palette[0][c];
+        const uint32_t b = palette[1][c];
+        if (bFourColors) {
+            palette[2][c] = static_cast<uint8_t>((2 * a + b) / 3);
+            palette[3][c] = static_cast<uint8_t>((a + 2 * b) / 3);
+        } else {
+            palette[2][c] = static_cast<uint8_t>((a + b) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = bFourColors ? 255 : 0;
+
+    const uint32_t indices =
+        static_cast<uint32_t>(ReadLittleEndian(block + 4, 4));
+    for (uint32_t i = 0; i < 16; i++) {
+        texels[i] = palette[(indices >> (i * 2)) & 3];
+    }
+}
+
+// BC3 alpha, BC4 and BC5 channels: two endpoints and 3-bit indices
+void DecodeChannelBlock(const uint8_t* block, uint32_t channel,
+                        FBlockTexels& texels)
+{
+    const uint32_t value0 = block[0];
+    const uint32_t value1 = block[1];
+
+    std::array<uint8_t, 8> palette;
+    palette[0] = static_cast<uint8_t>(value0);
+    palette[1] = static_cast<uint8_t>(value1);
+
+    if (value0 > value1) {
+        for (uint32_t i = 1; i < 7; i++) {
+            palette[i + 1] =
+                static_cast<uint8_t>(((7 - i) * value0 + i * value1) / 7);
+        }
+    } else {
+        for (uint32_t i = 1; i < 5; i++) {
+            palette[i + 1] =
+                static_cast<uint8_t>(((5 - i) * value0 + i * value1) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    const uint64_t indices = ReadLittleEndian(block + 2, 6);
+    for (uint32_t i = 0; i < 16; i++) {
+        texels[i][channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+void DecodeExplicitAlpha(const uint8_t* block, FBlockTexels& texels)
+{
+    const uint64_t alpha = ReadLittleEndian(block, 8);
+    for (uint32_t i = 0; i < 16; i++) {
+        texels[i][3] = static_cast<uint8_t>(((alpha >> (i * 4)) & 0xf) * 17);
+    }
+}
+
+} // namespace
+
+uint32_t FBlockDecoder::GetBlockBytes(EBlockFormat format)
+{
+    return format == EBlockFormat::BC1 || format == EBlockFormat::BC4 ? 8 : 16;
+}
+
+uint32_t FBlockDecoder::GetChannelCount(EBlockFormat format)
+{
+    switch (format) {
+    case EBlockFormat::BC4:
+        return 1;
+    case EBlockFormat::BC5:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+void FBlockDecoder::Decode(EBlockFormat format,
+                           std::span<const uint8_t> blocks, uint32_t width,
+                           uint32_t height, std::span<uint8_t> output)
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t blockBytes = GetBlockBytes(format);
+    const uint32_t channels = GetChannelCount(format);
+
+    if (blocks.size() < static_cast<size_t>(blocksX) * blocksY * blockBytes) {
+        throw std::runtime_error("Block compressed data is truncated");
+    }
+    if (output.size() < static_cast<size_t>(width) * height * channels) {
+        throw std::runtime_error("Block decode output is too small");
+    }
+
+    FBlockTexels texels = {};
+
+    for (uint32_t by = 0; by < blocksY; by++) {
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            const uint8_t* block =
+                blocks.data() +
+                (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+
+            switch (format) {
+            case EBlockFormat::BC1:
+                DecodeColorBlock(block, true, texels);
+                break;
+            case EBlockFormat::BC2:
+                DecodeColorBlock(block + 8, false, texels);
+                DecodeExplicitAlpha(block, texels);
+                break;
+            case EBlockFormat::BC3:
+                DecodeColorBlock(block + 8, false, texels);
+                DecodeChannelBlock(block, 3, texels);
+                break;
+            case EBlockFormat::BC4:
+                DecodeChannelBlock(block, 0, texels);
+                break;
+            case EBlockFormat::BC5:
+                DecodeChannelBlock(block, 0, texels);
+                DecodeChannelBlock(block + 8, 1, texels);
+                break;
+            }
+
+            const uint32_t maxX = std::min(4u, width - bx * 4);
+            const uint32_t maxY = std::min(4u, height - by * 4);
+
+            for (uint32_t y = 0; y < maxY; y++) {
+                uint8_t* row = output.data() +
+                               ((static_cast<size_t>(by) * 4 + y) * width +
+                                bx * 4) *
+                                   channels;
+                for (uint32_t x = 0; x < maxX; x++) {
+                    for (uint32_t c = 0; c < channels; c++) {
+                        row[x * channels + c] = texels[y * 4 + x][c];
+                    }
+                }
+            }
+        }
+    }
+}
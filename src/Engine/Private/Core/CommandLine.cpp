@@ -0,0 +1,81 @@
+#include "Core/CommandLine.h"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+std::unordered_map<std::string, std::string> FCommandLine::params;
+
+void FCommandLine::Init(int argc, const char* const* argv)
+{
+    params.clear();
+
+    // Skip the executable path
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        const size_t nameBegin = arg.find_first_not_of('-');
+        if (nameBegin == 0 || nameBegin == std::string::npos) {
+            continue;
+        }
+
+        const size_t separator = arg.find('=', nameBegin);
+        if (separator == std::string::npos) {
+            params[arg.substr(nameBegin)] = "";
+        } else {
+            params[arg.substr(nameBegin, separator - nameBegin)] =
+                arg.substr(separator + 1);
+        }
+    }
+}
+
+bool FCommandLine::HasParam(const std::string& name)
+{
+    return params.contains(name);
+}
+
+std::optional<std::string> FCommandLine::GetValue(const std::string& name)
+{
+    const auto it = params.find(name);
+    if (it == params.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::string FCommandLine::GetString(const std::string& name,
+                                    const std::string& defaultValue)
+{
+    const auto value = GetValue(name);
+    return value.has_value() && !value->empty() ? *value : defaultValue;
+}
+
+int64_t FCommandLine::GetInt(const std::string& name, int64_t defaultValue)
+{
+    const auto value = GetValue(name);
+    if (!value.has_value() || value->empty()) {
+        return defaultValue;
+    }
+
+    try {
+        return std::stoll(*value);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid integer for -" + name + ": " +
+                                 *value);
+    }
+}
+
+double FCommandLine::GetFloat(const std::string& name, double defaultValue)
+{
+    const auto value = GetValue(name);
+    if (!value.has_value() || value->empty()) {
+        return defaultValue;
+    }
+
+    try {
+        return std::stod(*value);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid number for -" + name + ": " +
+                                 *value);
+    }
+}
@@ -0,0 +1,148 @@
+#include "Core/DrawQueue.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+namespace
+{
+
+constexpr size_t KeyBytes = sizeof(uint64_t);
+constexpr size_t DigitCount = 256;
+
+// Fewer items are insertion sorted, which is stable and does not allocate
+// unlike std::stable_sort
+constexpr size_t MinRadixItems = 256;
+// Items per block of the parallel histogram and scatter
+constexpr size_t BlockSize = 64 * 1024;
+
+uint32_t GetDigit(uint64_t key, size_t byte)
+{
+    return static_cast<uint32_t>(key >> (byte * 8)) & 0xff;
+}
+
+} // namespace
+
+uint64_t FDrawKey::Make(uint32_t pass, uint32_t pipeline, uint32_t material,
+                        uint32_t depth)
+{
+    const uint64_t passMask = (1u << PassBits) - 1;
+    const uint64_t pipelineMask = (1u << PipelineBits) - 1;
+    const uint64_t materialMask = (1u << MaterialBits) - 1;
+
+    return (pass & passMask) << (64 - PassBits) |
+           (pipeline & pipelineMask) << (MaterialBits + DepthBits) |
+           (material & materialMask) << DepthBits | depth;
+}
+
+uint32_t FDrawKey::EncodeDepth(float viewDepth, bool bBackToFront)
+{
+    // The bits of non-negative floats sort like the floats themselves
+    const uint32_t bits = std::bit_cast<uint32_t>(std::max(viewDepth, 0.0f));
+    return bBackToFront ? ~bits : bits;
+}
+
+std::span<const FDrawItem> FDrawQueue::Sort(FThreadPool* pool)
+{
+    const size_t count = items.size();
+
+    if (count < MinRadixItems) {
+        for (size_t i = 1; i < count; i++) {
+            const FDrawItem item = items[i];
+            size_t j = i;
+            for (; j > 0 && items[j - 1].key > item.key; j--) {
+                items[j] = items[j - 1];
+            }
+            items[j] = item;
+        }
+        return items;
+    }
+
+    const size_t blockCount = (count + BlockSize - 1) / BlockSize;
+    const auto forEachBlock = [&](auto&& fn) {
+        const auto blocks = [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; block++) {
+                fn(block, block * BlockSize,
+                   std::min(block * BlockSize + BlockSize, count));
+            }
+        };
+        if (pool != nullptr) {
+            pool->ParallelFor(blockCount, 1, blocks);
+        } else {
+            blocks(0, blockCount);
+        }
+    };
+
+    // One read counts the digits of every byte, later passes only need the
+    // counts of their own byte per block
+    histograms.assign(blockCount * KeyBytes * DigitCount, 0);
+    forEachBlock([&](size_t block, size_t begin, size_t end) {
+        uint32_t* counts = histograms.data() + block * KeyBytes * DigitCount;
+        for (size_t i = begin; i < end; i++) {
+            for (size_t byte = 0; byte < KeyBytes; byte++) {
+                counts[byte * DigitCount + GetDigit(items[i].key, byte)]++;
+            }
+        }
+    });
+
+    scratch.resize(count);
+    bool bMoved = false;
+
+    for (size_t byte = 0; byte < KeyBytes; byte++) {
+        uint32_t totals[DigitCount] = {};
+        for (size_t block = 0; block < blockCount; block++) {
+            const uint32_t* counts = histograms.data() +
+                                     (block * KeyBytes + byte) * DigitCount;
+            for (size_t digit = 0; digit < DigitCount; digit++) {
+                totals[digit] += counts[digit];
+            }
+        }
+
+        // Every key has the same digit, the order would not change
+        if (std::find(std::begin(totals), std::end(totals), count) !=
+            std::end(totals)) {
+            continue;
+        }
+
+        // The first read counted the original order, once the items moved
+        // the blocks have to be counted again
+        if (bMoved) {
+            forEachBlock([&](size_t block, size_t begin, size_t end) {
+                uint32_t* counts = histograms.data() +
+                                   (block * KeyBytes + byte) * DigitCount;
+                std::fill(counts, counts + DigitCount, 0);
+                for (size_t i = begin; i < end; i++) {
+                    counts[GetDigit(items[i].key, byte)]++;
+                }
+            });
+        }
+
+        // Block b writes digit d after all smaller digits and after the
+        // blocks before it, which keeps the sort stable
+        uint32_t offset = 0;
+        for (size_t digit = 0; digit < DigitCount; digit++) {
+            for (size_t block = 0; block < blockCount; block++) {
+                uint32_t& slot =
+                    histograms[(block * KeyBytes + byte) * DigitCount + digit];
+                const uint32_t digitCount = slot;
+                slot = offset;
+                offset += digitCount;
+            }
+        }
+
+        forEachBlock([&](size_t block, size_t begin, size_t end) {
+            uint32_t* offsets = histograms.data() +
+                                (block * KeyBytes + byte) * DigitCount;
+            for (size_t i = begin; i < end; i++) {
+                scratch[offsets[GetDigit(items[i].key, byte)]++] = items[i];
+            }
+        });
+
+        std::swap(items, scratch);
+        bMoved = true;
+    }
+
+    return items;
+}
@@ -0,0 +1,62 @@
+#include "Core/DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Aim below the budget so regular frame to frame noise does not miss it
+constexpr double TargetFraction = 0.9;
+// Only grow when comfortably under the target
+constexpr double GrowThreshold = 0.8;
+constexpr float MaxGrowPerFrame = 0.02f;
+// Smoothing factor of the exponential moving average
+constexpr double Smoothing = 0.25;
+// Scales are snapped so tiny changes do not move the viewport every frame
+constexpr float ScaleStep = 1.0f / 64.0f;
+
+} // namespace
+
+FDynamicResolution::FDynamicResolution(double budgetMilliseconds,
+                                       float minScale, float maxScale)
+    : budget(budgetMilliseconds), minScale(std::min(minScale, maxScale)),
+      maxScale(maxScale), scale(maxScale)
+{
+}
+
+float FDynamicResolution::Update(double gpuMilliseconds, float measuredScale)
+{
+    if (gpuMilliseconds <= 0.0 || measuredScale <= 0.0f) {
+        return scale;
+    }
+
+    const double cost =
+        gpuMilliseconds / (static_cast<double>(measuredScale) * measuredScale);
+
+    // A frame over budget is reacted to immediately, not averaged away
+    if (!fullResolutionTime.has_value() || gpuMilliseconds > budget) {
+        fullResolutionTime = cost;
+    } else {
+        fullResolutionTime =
+            *fullResolutionTime + (cost - *fullResolutionTime) * Smoothing;
+    }
+
+    const double target = budget * TargetFraction;
+    float desired =
+        static_cast<float>(std::sqrt(target / *fullResolutionTime));
+
+    if (desired > scale) {
+        const double predicted =
+            *fullResolutionTime * static_cast<double>(scale) * scale;
+        if (predicted > target * GrowThreshold) {
+            return scale;
+        }
+        desired = std::min(desired, scale + MaxGrowPerFrame);
+    }
+
+    desired = std::round(desired / ScaleStep) * ScaleStep;
+    scale = std::clamp(desired, minScale, maxScale);
+
+    return scale;
+}
@@ -0,0 +1,265 @@
+#include "Core/EntityWorld.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+std::mutex componentTypesMutex;
+std::vector<FComponentTypes::FInfo> componentTypes;
+
+uint32_t AlignUp(uint32_t offset, uint32_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+uint32_t FComponentTypes::Register(uint32_t size, uint32_t alignment)
+{
+    std::lock_guard<std::mutex> lock(componentTypesMutex);
+
+    if (componentTypes.size() >= MaxComponentTypes) {
+        throw std::runtime_error("More than " +
+                                 std::to_string(MaxComponentTypes) +
+                                 " component types");
+    }
+
+    componentTypes.push_back({.size = size, .alignment = alignment});
+    return static_cast<uint32_t>(componentTypes.size() - 1);
+}
+
+FComponentTypes::FInfo FComponentTypes::Get(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(componentTypesMutex);
+    return componentTypes[id];
+}
+
+FArchetype::FArchetype(FComponentMask mask)
+    : mask(mask), offsets(), sizes(), entityOffset(0), capacity(0),
+      entityCount(0)
+{
+    for (FComponentMask bits = mask; bits != 0; bits &= bits - 1) {
+        componentIds.push_back(static_cast<uint32_t>(std::countr_zero(bits)));
+    }
+
+    std::vector<FComponentTypes::FInfo> infos;
+    uint32_t entityBytes = sizeof(FEntity);
+    for (const uint32_t id : componentIds) {
+        infos.push_back(FComponentTypes::Get(id));
+        sizes[id] = infos.back().size;
+        entityBytes += infos.back().size;
+    }
+
+    // Arrays go from the largest alignment down so only the first padding
+    // depends on the capacity
+    std::vector<size_t> order(componentIds.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return infos[a].alignment > infos[b].alignment;
+    });
+
+    const auto layout = [&](uint32_t count) {
+        uint32_t offset = 0;
+        for (const size_t i : order) {
+            offset = AlignUp(offset, infos[i].alignment);
+            offsets[componentIds[i]] = offset;
+            offset += infos[i].size * count;
+        }
+        entityOffset = AlignUp(offset, alignof(FEntity));
+        return entityOffset + static_cast<uint32_t>(sizeof(FEntity)) * count;
+    };
+
+    capacity = static_cast<uint32_t>(EntityChunkSize / entityBytes);
+    while (capacity > 0 && layout(capacity) > EntityChunkSize) {
+        capacity--;
+    }
+    if (capacity == 0) {
+        throw std::runtime_error("Components of an archetype exceed a chunk");
+    }
+    layout(capacity);
+}
+
+void* FArchetype::GetComponent(uint32_t id, uint32_t row) const
+{
+    assert(mask & (FComponentMask{1} << id));
+
+    std::byte* data = chunks[row / capacity]->data;
+    return data + offsets[id] + (row % capacity) * sizes[id];
+}
+
+FEntity FArchetype::GetEntity(uint32_t row) const
+{
+    return GetArray<const FEntity>(row / capacity)[row % capacity];
+}
+
+uint32_t FArchetype::AddRow(FEntity entity)
+{
+    const uint32_t row = entityCount;
+    if (row / capacity == chunks.size()) {
+        chunks.push_back(std::make_unique<FEntityChunk>());
+    }
+    entityCount++;
+
+    for (const uint32_t id : componentIds) {
+        std::memset(GetComponent(id, row), 0, sizes[id]);
+    }
+    GetArray<FEntity>(row / capacity)[row % capacity] = entity;
+    return row;
+}
+
+FEntity FArchetype::RemoveRow(uint32_t row)
+{
+    assert(row < entityCount);
+
+    const uint32_t last = entityCount - 1;
+    FEntity moved;
+
+    if (row != last) {
+        for (const uint32_t id : componentIds) {
+            std::memcpy(GetComponent(id, row), GetComponent(id, last),
+                        sizes[id]);
+        }
+        moved = GetEntity(last);
+        GetArray<FEntity>(row / capacity)[row % capacity] = moved;
+    }
+
+    entityCount--;
+
+    // Keep one spare chunk so an entity moving back and forth across a chunk
+    // boundary does not reallocate
+    if (chunks.size() > GetChunkCount() + 1) {
+        chunks.pop_back();
+    }
+
+    return moved;
+}
+
+FEntityWorld::FEntityWorld() : entityCount(0) {}
+
+FEntityWorld::~FEntityWorld() {}
+
+FArchetype& FEntityWorld::FindOrCreateArchetype(FComponentMask mask)
+{
+    const auto found = archetypesByMask.find(mask);
+    if (found != archetypesByMask.end()) {
+        return *found->second;
+    }
+
+    archetypes.push_back(std::make_unique<FArchetype>(mask));
+    archetypesByMask.emplace(mask, archetypes.back().get());
+    return *archetypes.back();
+}
+
+FEntity FEntityWorld::CreateEntity(FComponentMask mask)
+{
+    FArchetype& archetype = FindOrCreateArchetype(mask);
+
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.push_back({.archetype = nullptr, .row = 0, .generation = 0});
+    }
+
+    FEntitySlot& slot = slots[index];
+    const FEntity entity = {.index = index, .generation = slot.generation};
+
+    slot.archetype = &archetype;
+    slot.row = archetype.AddRow(entity);
+    entityCount++;
+
+    return entity;
+}
+
+void FEntityWorld::Destroy(FEntity entity)
+{
+    if (!IsAlive(entity)) {
+        return;
+    }
+
+    FEntitySlot& slot = slots[entity.index];
+
+    const FEntity moved = slot.archetype->RemoveRow(slot.row);
+    if (moved.index != UINT32_MAX) {
+        slots[moved.index].row = slot.row;
+    }
+
+    slot.archetype = nullptr;
+    slot.generation++;
+    freeSlots.push_back(entity.index);
+    entityCount--;
+}
+
+bool FEntityWorld::IsAlive(FEntity entity) const
+{
+    return entity.index < slots.size() &&
+           slots[entity.index].generation == entity.generation &&
+           slots[entity.index].archetype != nullptr;
+}
+
+FComponentMask FEntityWorld::GetEntityMask(FEntity entity) const
+{
+    if (!IsAlive(entity)) {
+        throw std::runtime_error("Entity is not alive");
+    }
+    return slots[entity.index].archetype->GetMask();
+}
+
+void* FEntityWorld::GetComponent(FEntity entity, uint32_t id) const
+{
+    if (!IsAlive(entity)) {
+        return nullptr;
+    }
+
+    const FEntitySlot& slot = slots[entity.index];
+    if ((slot.archetype->GetMask() & (FComponentMask{1} << id)) == 0) {
+        return nullptr;
+    }
+    return slot.archetype->GetComponent(id, slot.row);
+}
+
+void FEntityWorld::ChangeArchetype(FEntity entity, FComponentMask mask)
+{
+    FEntitySlot& slot = slots[entity.index];
+    FArchetype& source = *slot.archetype;
+    if (source.GetMask() == mask) {
+        return;
+    }
+
+    FArchetype& target = FindOrCreateArchetype(mask);
+    const uint32_t row = target.AddRow(entity);
+
+    for (const uint32_t id : source.GetComponentIds()) {
+        if (mask & (FComponentMask{1} << id)) {
+            std::memcpy(target.GetComponent(id, row),
+                        source.GetComponent(id, slot.row),
+                        source.GetComponentSize(id));
+        }
+    }
+
+    const FEntity moved = source.RemoveRow(slot.row);
+    if (moved.index != UINT32_MAX) {
+        slots[moved.index].row = slot.row;
+    }
+
+    slot.archetype = &target;
+    slot.row = row;
+}
+
+size_t FEntityWorld::GetChunkCount() const
+{
+    size_t count = 0;
+    for (const std::unique_ptr<FArchetype>& archetype : archetypes) {
+        count += archetype->GetChunkCount();
+    }
+    return count;
+}
@@ -1,17 +1,61 @@
 
 #include "Core/FileManager.h"
+#include "Core/ThreadPool.h"
+#include <exception>
 #include <fstream>
+#include <iostream>
 #include <stdexcept>
 #include <stdint.h>
+#include <string>
+#include <utility>
 #include <vector>
 
+#if defined(PLATFORM_WINDOWS)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 FileBlob::FileBlob(const std::vector<char>& inBlob) : blob(inBlob) {}
 
-size_t FileBlob::GetFileSize() const { return blob.size(); }
+FileBlob::FileBlob(std::vector<char>&& inBlob) : blob(std::move(inBlob)) {}
+
+size_t FileBlob::GetFileSize() const
+{
+    return mapping != nullptr ? mappedSize : blob.size();
+}
 
 const uint32_t* FileBlob::GetData() const
 {
-    return reinterpret_cast<const uint32_t*>(blob.data());
+    return reinterpret_cast<const uint32_t*>(GetBytes());
+}
+
+const char* FileBlob::GetBytes() const
+{
+    return mapping != nullptr ? mapping.get() : blob.data();
+}
+
+FileBlob FileBlob::Slice(size_t offset, size_t size) const
+{
+    if (offset > GetFileSize() || size > GetFileSize() - offset) {
+        throw std::runtime_error("File slice is out of range");
+    }
+
+    if (mapping == nullptr) {
+        return FileBlob(std::vector<char>(blob.begin() + offset,
+                                          blob.begin() + offset + size));
+    }
+
+    FileBlob slice;
+    slice.mapping =
+        std::shared_ptr<const char>(mapping, mapping.get() + offset);
+    slice.mappedSize = size;
+    return slice;
 }
 
 FileBlob FileManager::ReadFile(const std::string& filename)
@@ -32,3 +76,131 @@ FileBlob FileManager::ReadFile(const std::string& filename)
 
     return buffer;
 }
+
+FileBlob FileManager::ReadFile(const std::string& filename, uint64_t offset,
+                               uint64_t size)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    std::vector<char> buffer(size);
+
+    file.seekg(offset);
+    file.read(buffer.data(), size);
+
+    if (!file) {
+        throw std::runtime_error("Failed to read " + std::to_string(size) +
+                                 " bytes at " + std::to_string(offset) +
+                                 " from " + filename);
+    }
+
+    return FileBlob(std::move(buffer));
+}
+
+FileBlob FileManager::MapFile(const std::string& filename)
+{
+    FileBlob file;
+
+#if defined(PLATFORM_WINDOWS)
+    const HANDLE handle =
+        CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(handle, &size);
+
+    if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return file;
+    }
+
+    // The view keeps the file open on its own
+    const HANDLE fileMapping =
+        CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (fileMapping == nullptr) {
+        throw std::runtime_error("Failed to map file " + filename);
+    }
+
+    const void* data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(fileMapping);
+    if (data == nullptr) {
+        throw std::runtime_error("Failed to map file " + filename);
+    }
+
+    file.mappedSize = static_cast<size_t>(size.QuadPart);
+    file.mapping = std::shared_ptr<const char>(
+        static_cast<const char*>(data),
+        [](const char* view) { UnmapViewOfFile(view); });
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    struct stat status = {};
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to read the size of " + filename);
+    }
+
+    if (status.st_size == 0) {
+        close(fd);
+        return file;
+    }
+
+    const size_t size = static_cast<size_t>(status.st_size);
+
+    // The mapping keeps the file referenced on its own
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file " + filename);
+    }
+
+    file.mappedSize = size;
+    file.mapping = std::shared_ptr<const char>(
+        static_cast<const char*>(data), [size](const char* view) {
+            munmap(const_cast<char*>(view), size);
+        });
+#endif
+
+    return file;
+}
+
+void FileManager::ReadFileAsync(const std::string& filename, uint64_t offset,
+                                uint64_t size, FReadCallback onComplete)
+{
+    FThreadPool::Get().Enqueue([filename, offset, size,
+                                onComplete = std::move(onComplete)]() {
+        std::optional<FileBlob> blob;
+        try {
+            blob = ReadFile(filename, offset, size);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        onComplete(std::move(blob));
+    });
+}
+
+void FileManager::WriteFile(const std::string& filename, const void* data,
+                            size_t size)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    file.write(static_cast<const char*>(data), size);
+
+    if (!file) {
+        throw std::runtime_error("Failed to write file " + filename);
+    }
+}
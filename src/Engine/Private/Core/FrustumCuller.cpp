@@ -0,0 +1,95 @@
+#include "Core/FrustumCuller.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+template <typename Fn>
+std::span<const uint32_t> FFrustumCuller::Cull(size_t count, FThreadPool* pool,
+                                               Fn&& cullChunk)
+{
+    const size_t chunkCount = (count + ChunkSize - 1) / ChunkSize;
+
+    chunkVisible.resize(count);
+    chunkCounts.resize(chunkCount);
+    chunkOffsets.resize(chunkCount + 1);
+
+    const auto cullChunks = [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            const size_t first = chunk * ChunkSize;
+            chunkCounts[chunk] = static_cast<uint32_t>(
+                cullChunk(first, std::min(first + ChunkSize, count),
+                          chunkVisible.data() + first));
+        }
+    };
+
+    const auto packChunks = [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            const uint32_t* source = chunkVisible.data() + chunk * ChunkSize;
+            std::copy(source, source + chunkCounts[chunk],
+                      visible.data() + chunkOffsets[chunk]);
+        }
+    };
+
+    if (pool != nullptr) {
+        pool->ParallelFor(chunkCount, 1, cullChunks);
+    } else {
+        cullChunks(0, chunkCount);
+    }
+
+    chunkOffsets[0] = 0;
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        chunkOffsets[chunk + 1] = chunkOffsets[chunk] + chunkCounts[chunk];
+    }
+    visible.resize(chunkOffsets[chunkCount]);
+
+    if (pool != nullptr) {
+        pool->ParallelFor(chunkCount, 1, packChunks);
+    } else {
+        packChunks(0, chunkCount);
+    }
+
+    return visible;
+}
+
+std::span<const uint32_t>
+FFrustumCuller::CullSpheres(const FFrustum& frustum,
+                            const FSphereArrays& spheres, FThreadPool* pool,
+                            EMathBackend backend)
+{
+    return Cull(spheres.count, pool,
+                [&](size_t begin, size_t end, uint32_t* output) {
+                    const FSphereArrays chunk = {
+                        .centerX = spheres.centerX + begin,
+                        .centerY = spheres.centerY + begin,
+                        .centerZ = spheres.centerZ + begin,
+                        .radius = spheres.radius + begin,
+                        .count = end - begin,
+                    };
+                    return FMathBatch::CullSpheres(
+                        frustum, chunk, static_cast<uint32_t>(begin), output,
+                        backend);
+                });
+}
+
+std::span<const uint32_t>
+FFrustumCuller::CullBounds(const FFrustum& frustum,
+                           const FBoundsArrays& bounds, FThreadPool* pool,
+                           EMathBackend backend)
+{
+    return Cull(bounds.count, pool,
+                [&](size_t begin, size_t end, uint32_t* output) {
+                    const FBoundsArrays chunk = {
+                        .centerX = bounds.centerX + begin,
+                        .centerY = bounds.centerY + begin,
+                        .centerZ = bounds.centerZ + begin,
+                        .extentX = bounds.extentX + begin,
+                        .extentY = bounds.extentY + begin,
+                        .extentZ = bounds.extentZ + begin,
+                        .count = end - begin,
+                    };
+                    return FMathBatch::CullBounds(
+                        frustum, chunk, static_cast<uint32_t>(begin), output,
+                        backend);
+                });
+}
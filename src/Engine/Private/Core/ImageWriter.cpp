@@ -0,0 +1,213 @@
+#include "Core/ImageWriter.h"
+
+#include "Core/FileManager.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t MaxStoredBlockSize = 65535;
+
+const std::array<uint32_t, 256>& GetCrcTable()
+{
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> result = {};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            result[i] = c;
+        }
+        return result;
+    }();
+    return table;
+}
+
+uint32_t UpdateCrc(uint32_t crc, const uint8_t* data, size_t size)
+{
+    const std::array<uint32_t, 256>& table = GetCrcTable();
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Deferred modulo, 5552 is the largest run that cannot overflow 32 bits
+void UpdateAdler(uint32_t& a, uint32_t& b, const uint8_t* data, size_t size)
+{
+    while (size > 0) {
+        const size_t run = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < run; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += run;
+        size -= run;
+    }
+}
+
+void PutBigEndian(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Writes the length and type, returns the offset of the type to compute the
+// chunk CRC from once the data has been appended
+size_t BeginChunk(std::vector<uint8_t>& out, const char* type, uint32_t size)
+{
+    PutBigEndian(out, size);
+    const size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    return typeOffset;
+}
+
+void EndChunk(std::vector<uint8_t>& out, size_t typeOffset)
+{
+    const uint32_t crc = UpdateCrc(0xffffffffu, out.data() + typeOffset,
+                                   out.size() - typeOffset);
+    PutBigEndian(out, crc ^ 0xffffffffu);
+}
+
+} // namespace
+
+std::vector<uint8_t> FImageWriter::EncodePng(const FImageData& image)
+{
+    assert(image.pixels != nullptr);
+    assert(image.rowPitch >= image.width * 4);
+
+    // Each row is prefixed with filter type 0 (none)
+    const size_t rowSize = static_cast<size_t>(image.width) * 4;
+    const size_t rawSize = (rowSize + 1) * image.height;
+    const size_t blockCount =
+        std::max<size_t>((rawSize + MaxStoredBlockSize - 1) / MaxStoredBlockSize,
+                         1);
+    const size_t zlibSize = 2 + rawSize + blockCount * 5 + 4;
+
+    std::vector<uint8_t> out;
+    out.reserve(8 + 25 + 12 + zlibSize + 12);
+
+    static const uint8_t signature[] = {0x89, 'P',  'N',  'G',
+                                        '\r', '\n', 0x1a, '\n'};
+    out.insert(out.end(), std::begin(signature), std::end(signature));
+
+    const size_t headerType = BeginChunk(out, "IHDR", 13);
+    PutBigEndian(out, image.width);
+    PutBigEndian(out, image.height);
+    out.push_back(8); // bit depth
+    out.push_back(6); // color type RGBA
+    out.push_back(0); // compression
+    out.push_back(0); // filter
+    out.push_back(0); // interlace
+    EndChunk(out, headerType);
+
+    const size_t dataType =
+        BeginChunk(out, "IDAT", static_cast<uint32_t>(zlibSize));
+
+    // zlib header, deflate with a 32K window and no preset dictionary
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+
+    std::vector<uint8_t> row(rowSize + 1);
+    size_t blockRemaining = 0;
+    size_t rawRemaining = rawSize;
+
+    // Rows are streamed into stored blocks, a row may span two blocks
+    auto emit = [&](const uint8_t* data, size_t size) {
+        while (size > 0) {
+            if (blockRemaining == 0) {
+                blockRemaining = std::min(rawRemaining, MaxStoredBlockSize);
+                const uint16_t length = static_cast<uint16_t>(blockRemaining);
+                const bool bFinal = rawRemaining == blockRemaining;
+                out.push_back(bFinal ? 1 : 0);
+                out.push_back(static_cast<uint8_t>(length));
+                out.push_back(static_cast<uint8_t>(length >> 8));
+                out.push_back(static_cast<uint8_t>(~length));
+                out.push_back(static_cast<uint8_t>(~length >> 8));
+            }
+
+            const size_t run = std::min(size, blockRemaining);
+            out.insert(out.end(), data, data + run);
+            data += run;
+            size -= run;
+            blockRemaining -= run;
+            rawRemaining -= run;
+        }
+    };
+
+    if (rawSize == 0) {
+        // Empty final stored block
+        out.insert(out.end(), {1, 0, 0, 0xff, 0xff});
+    }
+
+    for (uint32_t y = 0; y < image.height; y++) {
+        const uint8_t* source =
+            image.pixels + static_cast<size_t>(y) * image.rowPitch;
+
+        row[0] = 0;
+        if (image.bBGRA) {
+            for (uint32_t x = 0; x < image.width; x++) {
+                uint8_t* pixel = &row[1 + x * 4];
+                pixel[0] = source[x * 4 + 2];
+                pixel[1] = source[x * 4 + 1];
+                pixel[2] = source[x * 4 + 0];
+                pixel[3] = source[x * 4 + 3];
+            }
+        } else {
+            std::memcpy(&row[1], source, rowSize);
+        }
+
+        UpdateAdler(adlerA, adlerB, row.data(), row.size());
+        emit(row.data(), row.size());
+    }
+
+    PutBigEndian(out, (adlerB << 16) | adlerA);
+    EndChunk(out, dataType);
+
+    const size_t endType = BeginChunk(out, "IEND", 0);
+    EndChunk(out, endType);
+
+    return out;
+}
+
+void FImageWriter::WritePng(const std::string& filename,
+                            const FImageData& image)
+{
+    const std::vector<uint8_t> png = EncodePng(image);
+    FileManager::WriteFile(filename, png.data(), png.size());
+}
+
+void FImageWriter::WriteRaw(const std::string& filename,
+                            const FImageData& image)
+{
+    const size_t rowSize = static_cast<size_t>(image.width) * 4;
+
+    if (image.rowPitch == rowSize) {
+        FileManager::WriteFile(filename, image.pixels, rowSize * image.height);
+        return;
+    }
+
+    std::vector<uint8_t> packed(rowSize * image.height);
+    for (uint32_t y = 0; y < image.height; y++) {
+        std::memcpy(&packed[y * rowSize],
+                    image.pixels + static_cast<size_t>(y) * image.rowPitch,
+                    rowSize);
+    }
+
+    FileManager::WriteFile(filename, packed.data(), packed.size());
+}
@@ -0,0 +1,380 @@
+#include "Core/Inflate.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace
+{
+
+constexpr uint32_t MaxCodeBits = 15;
+constexpr uint32_t MaxLiteralCodes = 288;
+constexpr uint32_t MaxDistanceCodes = 30;
+
+constexpr std::array<uint16_t, 29> LengthBase = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> LengthExtra = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> DistanceBase = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> DistanceExtra = {
+    0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Canonical Huffman code as counts per length and symbols in code order,
+// decoded one bit at a time
+struct FHuffman {
+    std::array<uint16_t, MaxCodeBits + 1> counts = {};
+    std::array<uint16_t, MaxLiteralCodes> symbols = {};
+
+    void Build(const uint8_t* lengths, uint32_t count)
+    {
+        counts.fill(0);
+        for (uint32_t i = 0; i < count; i++) {
+            counts[lengths[i]] += 1;
+        }
+        counts[0] = 0;
+
+        // Over-subscribed codes are invalid, incomplete ones are allowed
+        int32_t left = 1;
+        for (uint32_t bits = 1; bits <= MaxCodeBits; bits++) {
+            left = (left << 1) - counts[bits];
+            if (left < 0) {
+                throw std::runtime_error("Invalid deflate Huffman code");
+            }
+        }
+
+        std::array<uint16_t, MaxCodeBits + 1> offsets = {};
+        for (uint32_t bits = 1; bits < MaxCodeBits; bits++) {
+            offsets[bits + 1] = offsets[bits] + counts[bits];
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (lengths[i] != 0) {
+                symbols[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+    }
+};
+
+class FInflater
+{
+  public:
+    FInflater(std::span<const uint8_t> input, std::span<uint8_t> output)
+        : input(input), output(output), inputPos(0), outputPos(0),
+          bitBuffer(0), bitCount(0)
+    {
+    }
+
+    void Run()
+    {
+        bool bLast = false;
+        while (!bLast) {
+            bLast = ReadBits(1) != 0;
+
+            switch (ReadBits(2)) {
+            case 0:
+                StoredBlock();
+                break;
+            case 1:
+                FixedBlock();
+                break;
+            case 2:
+                DynamicBlock();
+                break;
+            default:
+                throw std::runtime_error("Invalid deflate block type");
+            }
+        }
+
+        if (outputPos != output.size()) {
+            throw std::runtime_error("Deflate stream is shorter than expected");
+        }
+    }
+
+    // Bytes consumed, the rest of a partial byte included
+    size_t GetInputPosition() const { return inputPos; }
+
+  private:
+    std::span<const uint8_t> input;
+    std::span<uint8_t> output;
+    size_t inputPos;
+    size_t outputPos;
+
+    uint32_t bitBuffer;
+    uint32_t bitCount;
+
+    uint32_t ReadBits(uint32_t count)
+    {
+        while (bitCount < count) {
+            if (inputPos >= input.size()) {
+                throw std::runtime_error("Deflate stream is truncated");
+            }
+            bitBuffer |= static_cast<uint32_t>(input[inputPos++]) << bitCount;
+            bitCount += 8;
+        }
+
+        const uint32_t value = bitBuffer & ((1u << count) - 1);
+        bitBuffer >>= count;
+        bitCount -= count;
+        return value;
+    }
+
+    uint32_t Decode(const FHuffman& huffman)
+    {
+        int32_t code = 0;
+        int32_t first = 0;
+        int32_t index = 0;
+
+        for (uint32_t bits = 1; bits <= MaxCodeBits; bits++) {
+            code |= static_cast<int32_t>(ReadBits(1));
+            const int32_t count = huffman.counts[bits];
+            if (code - count < first) {
+                return huffman.symbols[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+
+        throw std::runtime_error("Invalid deflate code");
+    }
+
+    void StoredBlock()
+    {
+        // Stored blocks start at a byte boundary
+        bitBuffer = 0;
+        bitCount = 0;
+
+        if (inputPos + 4 > input.size()) {
+            throw std::runtime_error("Deflate stream is truncated");
+        }
+
+        const uint32_t length = input[inputPos] | (input[inputPos + 1] << 8);
+        const uint32_t inverse =
+            input[inputPos + 2] | (input[inputPos + 3] << 8);
+        inputPos += 4;
+
+        if (length != (~inverse & 0xffffu)) {
+            throw std::runtime_error("Invalid deflate stored block length");
+        }
+        if (inputPos + length > input.size()) {
+            throw std::runtime_error("Deflate stream is truncated");
+        }
+        if (outputPos + length > output.size()) {
+            throw std::runtime_error("Deflate stream is longer than expected");
+        }
+
+        // An empty output may have no storage to copy to
+        if (length > 0) {
+            std::memcpy(output.data() + outputPos, input.data() + inputPos,
+                        length);
+        }
+        inputPos += length;
+        outputPos += length;
+    }
+
+    void FixedBlock()
+    {
+        std::array<uint8_t, MaxLiteralCodes + MaxDistanceCodes> lengths;
+
+        uint32_t symbol = 0;
+        for (; symbol < 144; symbol++) {
+            lengths[symbol] = 8;
+        }
+        for (; symbol < 256; symbol++) {
+            lengths[symbol] = 9;
+        }
+        for (; symbol < 280; symbol++) {
+            lengths[symbol] = 7;
+        }
+        for (; symbol < MaxLiteralCodes; symbol++) {
+            lengths[symbol] = 8;
+        }
+        for (uint32_t i = 0; i < MaxDistanceCodes; i++) {
+            lengths[MaxLiteralCodes + i] = 5;
+        }
+
+        FHuffman literals;
+        FHuffman distances;
+        literals.Build(lengths.data(), MaxLiteralCodes);
+        distances.Build(lengths.data() + MaxLiteralCodes, MaxDistanceCodes);
+
+        Codes(literals, distances);
+    }
+
+    void DynamicBlock()
+    {
+        constexpr std::array<uint8_t, 19> CodeLengthOrder = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        const uint32_t literalCount = ReadBits(5) + 257;
+        const uint32_t distanceCount = ReadBits(5) + 1;
+        const uint32_t codeLengthCount = ReadBits(4) + 4;
+
+        if (literalCount > 286 || distanceCount > MaxDistanceCodes) {
+            throw std::runtime_error("Invalid deflate code counts");
+        }
+
+        std::array<uint8_t, MaxLiteralCodes + MaxDistanceCodes> lengths = {};
+
+        for (uint32_t i = 0; i < codeLengthCount; i++) {
+            lengths[CodeLengthOrder[i]] = static_cast<uint8_t>(ReadBits(3));
+        }
+
+        FHuffman codeLengths;
+        codeLengths.Build(lengths.data(), 19);
+
+        uint32_t index = 0;
+        while (index < literalCount + distanceCount) {
+            const uint32_t symbol = Decode(codeLengths);
+
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t repeated = 0;
+            uint32_t repeat = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    throw std::runtime_error("Invalid deflate length repeat");
+                }
+                repeated = lengths[index - 1];
+                repeat = 3 + ReadBits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + ReadBits(3);
+            } else {
+                repeat = 11 + ReadBits(7);
+            }
+
+            if (index + repeat > literalCount + distanceCount) {
+                throw std::runtime_error("Invalid deflate length repeat");
+            }
+            while (repeat-- > 0) {
+                lengths[index++] = repeated;
+            }
+        }
+
+        if (lengths[256] == 0) {
+            throw std::runtime_error("Deflate block has no end code");
+        }
+
+        FHuffman literals;
+        FHuffman distances;
+        literals.Build(lengths.data(), literalCount);
+        distances.Build(lengths.data() + literalCount, distanceCount);
+
+        Codes(literals, distances);
+    }
+
+    void Codes(const FHuffman& literals, const FHuffman& distances)
+    {
+        for (;;) {
+            uint32_t symbol = Decode(literals);
+
+            if (symbol < 256) {
+                if (outputPos >= output.size()) {
+                    throw std::runtime_error(
+                        "Deflate stream is longer than expected");
+                }
+                output[outputPos++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            if (symbol == 256) {
+                return;
+            }
+
+            symbol -= 257;
+            if (symbol >= LengthBase.size()) {
+                throw std::runtime_error("Invalid deflate length code");
+            }
+            const uint32_t length =
+                LengthBase[symbol] + ReadBits(LengthExtra[symbol]);
+
+            const uint32_t distanceSymbol = Decode(distances);
+            if (distanceSymbol >= DistanceBase.size()) {
+                throw std::runtime_error("Invalid deflate distance code");
+            }
+            const uint32_t distance = DistanceBase[distanceSymbol] +
+                                      ReadBits(DistanceExtra[distanceSymbol]);
+
+            if (distance > outputPos) {
+                throw std::runtime_error("Deflate distance is too far back");
+            }
+            if (outputPos + length > output.size()) {
+                throw std::runtime_error(
+                    "Deflate stream is longer than expected");
+            }
+
+            // Copies may overlap their own output, byte by byte on purpose
+            for (uint32_t i = 0; i < length; i++) {
+                output[outputPos] = output[outputPos - distance];
+                outputPos++;
+            }
+        }
+    }
+};
+
+} // namespace
+
+void FInflate::Decompress(std::span<const uint8_t> input,
+                          std::span<uint8_t> output)
+{
+    FInflater(input, output).Run();
+}
+
+void FInflate::DecompressZlib(std::span<const uint8_t> input,
+                              std::span<uint8_t> output)
+{
+    if (input.size() < 6) {
+        throw std::runtime_error("Zlib stream is truncated");
+    }
+
+    const uint32_t header = (input[0] << 8) | input[1];
+    if ((input[0] & 0x0f) != 8 || header % 31 != 0) {
+        throw std::runtime_error("Invalid zlib header");
+    }
+    if (input[1] & 0x20) {
+        throw std::runtime_error("Zlib preset dictionaries are not supported");
+    }
+
+    FInflater inflater(input.subspan(2), output);
+    inflater.Run();
+
+    const size_t trailer = 2 + inflater.GetInputPosition();
+    if (trailer + 4 > input.size()) {
+        throw std::runtime_error("Zlib stream is truncated");
+    }
+
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t offset = 0; offset < output.size(); offset += 5552) {
+        const size_t end = std::min<size_t>(offset + 5552, output.size());
+        for (size_t i = offset; i < end; i++) {
+            a += output[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+
+    const uint32_t expected =
+        (static_cast<uint32_t>(input[trailer]) << 24) |
+        (static_cast<uint32_t>(input[trailer + 1]) << 16) |
+        (static_cast<uint32_t>(input[trailer + 2]) << 8) |
+        static_cast<uint32_t>(input[trailer + 3]);
+
+    if (((b << 16) | a) != expected) {
+        throw std::runtime_error("Zlib Adler-32 mismatch");
+    }
+}
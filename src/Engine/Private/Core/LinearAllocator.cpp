@@ -0,0 +1,62 @@
+#include "Core/LinearAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace
+{
+size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+FLinearAllocator::FLinearAllocator(size_t initialCapacity)
+    : current{.memory = std::make_unique<std::byte[]>(initialCapacity),
+              .size = initialCapacity},
+      offset(0), capacity(initialCapacity), usedBytes(0)
+{
+}
+
+FLinearAllocator::~FLinearAllocator() {}
+
+void* FLinearAllocator::Allocate(size_t size, size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    const uintptr_t base = reinterpret_cast<uintptr_t>(current.memory.get());
+    const size_t alignedOffset = AlignUp(base + offset, alignment) - base;
+
+    if (alignedOffset + size > current.size) {
+        // Keep the exhausted block alive until Reset and continue in a new one
+        const size_t blockSize =
+            std::max(current.size * 2, AlignUp(size + alignment, 16));
+
+        overflowBlocks.push_back(std::move(current));
+        current = {.memory = std::make_unique<std::byte[]>(blockSize),
+                   .size = blockSize};
+        offset = 0;
+        capacity += blockSize;
+
+        return Allocate(size, alignment);
+    }
+
+    offset = alignedOffset + size;
+    usedBytes += size;
+
+    return current.memory.get() + alignedOffset;
+}
+
+void FLinearAllocator::Reset()
+{
+    if (!overflowBlocks.empty()) {
+        // Grow to the total peak so the next frame fits in one block
+        overflowBlocks.clear();
+        current = {.memory = std::make_unique<std::byte[]>(capacity),
+                   .size = capacity};
+    }
+
+    offset = 0;
+    usedBytes = 0;
+}
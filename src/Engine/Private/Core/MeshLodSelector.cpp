@@ -0,0 +1,41 @@
+#include "Core/MeshLodSelector.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+// A coarser LOD has to project this much below the threshold to be picked
+constexpr float Hysteresis = 0.25f;
+
+} // namespace
+
+FMeshLodSelector::FMeshLodSelector(std::vector<float> lodErrors,
+                                   float pixelThreshold)
+    : errors(std::move(lodErrors)), threshold(pixelThreshold)
+{
+    if (errors.empty()) {
+        errors.push_back(0.0f);
+    }
+
+    // The search below relies on errors growing with the LOD
+    for (size_t i = 1; i < errors.size(); i++) {
+        errors[i] = std::max(errors[i], errors[i - 1]);
+    }
+}
+
+uint32_t FMeshLodSelector::Select(float radiusPixels,
+                                  uint32_t currentLod) const
+{
+    uint32_t lod = std::min(currentLod, GetLodCount() - 1);
+
+    while (lod > 0 && errors[lod] * radiusPixels > threshold) {
+        lod--;
+    }
+    while (lod + 1 < GetLodCount() &&
+           errors[lod + 1] * radiusPixels <= threshold * (1.0f - Hysteresis)) {
+        lod++;
+    }
+    return lod;
+}
@@ -0,0 +1,227 @@
+#include "Core/TaskGraph.h"
+
+#include "Core/ThreadPool.h"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+double ToMilliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // namespace
+
+FTaskGraph::FTaskGraph(const std::string& name) : name(name) {}
+
+FTaskGraph::FTaskId FTaskGraph::AddTask(const std::string& taskName,
+                                        std::function<void()> function,
+                                        std::initializer_list<FTaskId> dependencies,
+                                        bool bMainThread)
+{
+    const FTaskId id = static_cast<FTaskId>(tasks.size());
+
+    for (const FTaskId dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::runtime_error("Task " + taskName +
+                                     " depends on an unknown task");
+        }
+        tasks[dependency].dependents.push_back(id);
+    }
+
+    tasks.push_back({
+        .name = taskName,
+        .function = std::move(function),
+        .dependencies = dependencies,
+        .dependents = {},
+        .bMainThread = bMainThread,
+        .pendingDependencies = static_cast<uint32_t>(dependencies.size()),
+        .bRanOnCaller = false,
+        .start = {},
+        .end = {},
+    });
+
+    return id;
+}
+
+void FTaskGraph::Run(FThreadPool& pool)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    // Ready tasks the calling thread picks up, main thread tasks only go here
+    std::vector<FTaskId> callerQueue;
+    size_t remaining = tasks.size();
+    std::exception_ptr error;
+
+    const std::thread::id callerThread = std::this_thread::get_id();
+
+    // Declared before use so Execute and Schedule can refer to each other
+    std::function<void(FTaskId)> schedule;
+
+    const auto execute = [&](FTaskId id) {
+        FTask& task = tasks[id];
+
+        bool bSkip;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bSkip = error != nullptr;
+        }
+
+        task.bRanOnCaller = std::this_thread::get_id() == callerThread;
+        task.start = Clock::now();
+
+        if (!bSkip) {
+            try {
+                task.function();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (error == nullptr) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        task.end = Clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const FTaskId dependent : task.dependents) {
+            if (--tasks[dependent].pendingDependencies == 0) {
+                schedule(dependent);
+            }
+        }
+
+        remaining -= 1;
+        condition.notify_all();
+    };
+
+    // Called with the mutex held
+    schedule = [&](FTaskId id) {
+        if (tasks[id].bMainThread) {
+            callerQueue.push_back(id);
+        } else {
+            pool.Enqueue([&execute, id]() { execute(id); });
+        }
+    };
+
+    runStart = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (FTaskId id = 0; id < tasks.size(); id++) {
+            if (tasks[id].pendingDependencies == 0) {
+                schedule(id);
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (remaining > 0) {
+        if (!callerQueue.empty()) {
+            const FTaskId id = callerQueue.back();
+            callerQueue.pop_back();
+
+            lock.unlock();
+            execute(id);
+            lock.lock();
+            continue;
+        }
+
+        // Help the pool so nested graphs on worker threads cannot starve
+        lock.unlock();
+        const bool bRanTask = pool.TryRunPendingTask();
+        lock.lock();
+
+        if (!bRanTask && remaining > 0 && callerQueue.empty()) {
+            condition.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    runEnd = Clock::now();
+
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+double FTaskGraph::GetTotalMilliseconds() const
+{
+    return ToMilliseconds(runEnd - runStart);
+}
+
+std::vector<FTaskGraph::FTaskId> FTaskGraph::GetCriticalPath() const
+{
+    std::vector<FTaskId> path;
+    if (tasks.empty()) {
+        return path;
+    }
+
+    // The path ends at the task finishing last and walks back through the
+    // dependency that released each task
+    FTaskId current = 0;
+    for (FTaskId id = 1; id < tasks.size(); id++) {
+        if (tasks[id].end > tasks[current].end) {
+            current = id;
+        }
+    }
+
+    while (true) {
+        path.insert(path.begin(), current);
+
+        const FTask& task = tasks[current];
+        if (task.dependencies.empty()) {
+            break;
+        }
+
+        FTaskId latest = task.dependencies.front();
+        for (const FTaskId dependency : task.dependencies) {
+            if (tasks[dependency].end > tasks[latest].end) {
+                latest = dependency;
+            }
+        }
+        current = latest;
+    }
+
+    return path;
+}
+
+void FTaskGraph::PrintReport(std::ostream& stream) const
+{
+    stream << "Startup report: " << name << " (" << std::fixed
+           << std::setprecision(2) << GetTotalMilliseconds() << " ms)"
+           << std::endl;
+
+    stream << '\t' << std::left << std::setw(28) << "phase" << std::right
+           << std::setw(10) << "start ms" << std::setw(12) << "duration ms"
+           << "  thread" << std::endl;
+
+    for (const FTask& task : tasks) {
+        stream << '\t' << std::left << std::setw(28) << task.name << std::right
+               << std::setw(10) << ToMilliseconds(task.start - runStart)
+               << std::setw(12) << ToMilliseconds(task.end - task.start)
+               << "  " << (task.bRanOnCaller ? "caller" : "worker")
+               << std::endl;
+    }
+
+    const std::vector<FTaskId> path = GetCriticalPath();
+
+    double pathDuration = 0.0;
+    stream << "\tcritical path: ";
+    for (size_t i = 0; i < path.size(); i++) {
+        const FTask& task = tasks[path[i]];
+        pathDuration += ToMilliseconds(task.end - task.start);
+        stream << (i == 0 ? "" : " -> ") << task.name;
+    }
+    stream << " (" << pathDuration << " ms busy)" << std::endl;
+
+    stream << std::defaultfloat;
+}
@@ -0,0 +1,106 @@
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+FThreadPool::FThreadPool(uint32_t numThreads)
+    : queue(64), queueHead(0), queueSize(0), bStopping(false)
+{
+    workers.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++) {
+        workers.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+FThreadPool::~FThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        bStopping = true;
+    }
+    queueCondition.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+FThreadPool& FThreadPool::Get()
+{
+    static FThreadPool pool(
+        std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
+void FThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        if (queueSize == queue.size()) {
+            std::vector<std::function<void()>> grown(queue.size() * 2);
+            for (size_t i = 0; i < queueSize; i++) {
+                grown[i] = std::move(queue[(queueHead + i) % queue.size()]);
+            }
+            queue = std::move(grown);
+            queueHead = 0;
+        }
+
+        queue[(queueHead + queueSize) % queue.size()] = std::move(task);
+        queueSize += 1;
+    }
+
+    queueCondition.notify_one();
+}
+
+bool FThreadPool::PopTask(std::function<void()>& task)
+{
+    if (queueSize == 0) {
+        return false;
+    }
+
+    task = std::move(queue[queueHead]);
+    queue[queueHead] = nullptr;
+    queueHead = (queueHead + 1) % queue.size();
+    queueSize -= 1;
+
+    return true;
+}
+
+bool FThreadPool::TryRunPendingTask()
+{
+    std::function<void()> task;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!PopTask(task)) {
+            return false;
+        }
+    }
+
+    task();
+    return true;
+}
+
+void FThreadPool::WorkerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock,
+                                [this]() { return bStopping || queueSize > 0; });
+
+            if (!PopTask(task)) {
+                // Stopping with an empty queue
+                return;
+            }
+        }
+
+        task();
+    }
+}
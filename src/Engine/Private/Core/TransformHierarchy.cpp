@@ -0,0 +1,329 @@
+#include "Core/TransformHierarchy.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+
+// Nodes per batch of a parallel level, one matrix product each
+constexpr size_t ParallelBatchSize = 1024;
+
+} // namespace
+
+FTransformHierarchy::FTransformHierarchy()
+    : bLayoutDirty(false), levelOffsets{0}, updatedCount(0)
+{
+}
+
+uint32_t FTransformHierarchy::Add(uint32_t parent, const FLocalTransform& local)
+{
+    assert(parent == InvalidTransformNode || IsAlive(parent));
+
+    uint32_t node;
+    if (!freeSlots.empty()) {
+        node = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        node = static_cast<uint32_t>(slots.size());
+        slots.push_back({});
+    }
+
+    slots[node] = {
+        .position = static_cast<uint32_t>(locals.size()),
+        .parent = parent,
+        .bAlive = true,
+        .bDirty = false,
+    };
+    locals.push_back(local);
+    worlds.push_back(FMatrix4::Identity());
+
+    MarkDirty(node);
+    bLayoutDirty = true;
+    return node;
+}
+
+void FTransformHierarchy::Remove(uint32_t node)
+{
+    assert(IsAlive(node));
+
+    // Descendants are no longer reachable and get freed by the rebuild.
+    // Until then the slot stays taken so they cannot attach to a new node.
+    slots[node].bAlive = false;
+    bLayoutDirty = true;
+}
+
+bool FTransformHierarchy::IsAlive(uint32_t node) const
+{
+    if (node >= slots.size() || !slots[node].bAlive) {
+        return false;
+    }
+    // Removing an ancestor removes the node too
+    for (uint32_t parent = slots[node].parent; parent != InvalidTransformNode;
+         parent = slots[parent].parent) {
+        if (!slots[parent].bAlive) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FTransformHierarchy::SetParent(uint32_t node, uint32_t parent)
+{
+    assert(IsAlive(node));
+    assert(parent == InvalidTransformNode || IsAlive(parent));
+
+    for (uint32_t ancestor = parent; ancestor != InvalidTransformNode;
+         ancestor = slots[ancestor].parent) {
+        if (ancestor == node) {
+            throw std::runtime_error(
+                "Transform node parented to its own descendant");
+        }
+    }
+
+    slots[node].parent = parent;
+    MarkDirty(node);
+    bLayoutDirty = true;
+}
+
+void FTransformHierarchy::SetLocal(uint32_t node, const FLocalTransform& local)
+{
+    assert(IsAlive(node));
+
+    locals[slots[node].position] = local;
+    MarkDirty(node);
+}
+
+void FTransformHierarchy::MarkDirty(uint32_t node)
+{
+    if (!slots[node].bDirty) {
+        slots[node].bDirty = true;
+        dirtyNodes.push_back(node);
+    }
+}
+
+void FTransformHierarchy::Rebuild()
+{
+    const uint32_t slotCount = static_cast<uint32_t>(slots.size());
+
+    // Children of every node in id order, by counting sort on the parent
+    std::vector<uint32_t> childOffsets(slotCount + 1, 0);
+    for (uint32_t node = 0; node < slotCount; node++) {
+        const FSlot& slot = slots[node];
+        if (slot.bAlive && slot.parent != InvalidTransformNode) {
+            childOffsets[slot.parent + 1]++;
+        }
+    }
+    for (uint32_t node = 0; node < slotCount; node++) {
+        childOffsets[node + 1] += childOffsets[node];
+    }
+
+    std::vector<uint32_t> children(childOffsets.back());
+    std::vector<uint32_t> cursors(childOffsets.begin(),
+                                  childOffsets.end() - 1);
+    for (uint32_t node = 0; node < slotCount; node++) {
+        const FSlot& slot = slots[node];
+        if (slot.bAlive && slot.parent != InvalidTransformNode) {
+            children[cursors[slot.parent]++] = node;
+        }
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(slotCount);
+    for (uint32_t node = 0; node < slotCount; node++) {
+        if (slots[node].bAlive && slots[node].parent == InvalidTransformNode) {
+            order.push_back(node);
+        }
+    }
+
+    const size_t rootCount = order.size();
+    firstChildren.resize(slotCount);
+    childCounts.resize(slotCount);
+    parents.assign(rootCount, InvalidTransformNode);
+    levelOffsets.assign({0});
+
+    size_t levelEnd = rootCount;
+    for (size_t head = 0; head < order.size(); head++) {
+        if (head == levelEnd) {
+            levelOffsets.push_back(static_cast<uint32_t>(head));
+            levelEnd = order.size();
+        }
+
+        const uint32_t node = order[head];
+        firstChildren[head] = static_cast<uint32_t>(order.size());
+        for (uint32_t i = childOffsets[node]; i < childOffsets[node + 1];
+             i++) {
+            order.push_back(children[i]);
+            parents.push_back(static_cast<uint32_t>(head));
+        }
+        childCounts[head] = static_cast<uint32_t>(order.size()) -
+                            firstChildren[head];
+    }
+    levelOffsets.push_back(static_cast<uint32_t>(order.size()));
+    if (order.empty()) {
+        levelOffsets.assign({0});
+    }
+
+    firstChildren.resize(order.size());
+    childCounts.resize(order.size());
+
+    std::vector<FLocalTransform> sortedLocals(order.size());
+    std::vector<FMatrix4> sortedWorlds(order.size());
+    for (size_t position = 0; position < order.size(); position++) {
+        FSlot& slot = slots[order[position]];
+        sortedLocals[position] = locals[slot.position];
+        sortedWorlds[position] = worlds[slot.position];
+        slot.position = static_cast<uint32_t>(position);
+    }
+    locals = std::move(sortedLocals);
+    worlds = std::move(sortedWorlds);
+
+    // Whatever was not reached is a removed node or one of its descendants
+    std::vector<bool> reached(slotCount, false);
+    for (const uint32_t node : order) {
+        reached[node] = true;
+    }
+    freeSlots.clear();
+    for (uint32_t node = slotCount; node-- > 0;) {
+        if (!reached[node]) {
+            slots[node] = {
+                .position = 0,
+                .parent = InvalidTransformNode,
+                .bAlive = false,
+                .bDirty = false,
+            };
+            freeSlots.push_back(node);
+        }
+    }
+
+    ids = std::move(order);
+    bLayoutDirty = false;
+}
+
+void FTransformHierarchy::Update() { UpdateDirty(nullptr); }
+
+void FTransformHierarchy::ParallelUpdate(FThreadPool& pool)
+{
+    UpdateDirty(&pool);
+}
+
+void FTransformHierarchy::UpdateDirty(FThreadPool* pool)
+{
+    if (bLayoutDirty) {
+        Rebuild();
+    }
+
+    // Dirty nodes under another dirty node are updated with its subtree
+    dirtyRoots.clear();
+    for (const uint32_t node : dirtyNodes) {
+        if (!slots[node].bAlive || !slots[node].bDirty) {
+            continue;
+        }
+
+        bool bCovered = false;
+        for (uint32_t parent = slots[node].parent;
+             parent != InvalidTransformNode && !bCovered;
+             parent = slots[parent].parent) {
+            bCovered = slots[parent].bDirty;
+        }
+        if (!bCovered) {
+            dirtyRoots.push_back(slots[node].position);
+        }
+    }
+    for (const uint32_t node : dirtyNodes) {
+        slots[node].bDirty = false;
+    }
+    dirtyNodes.clear();
+
+    // Positions grow with depth, so the roots come up level by level
+    std::sort(dirtyRoots.begin(), dirtyRoots.end());
+
+    updatedCount = 0;
+    level.clear();
+    size_t nextRoot = 0;
+    size_t depth = 0;
+
+    while (!level.empty() || nextRoot < dirtyRoots.size()) {
+        if (level.empty()) {
+            depth = static_cast<size_t>(
+                std::upper_bound(levelOffsets.begin(), levelOffsets.end(),
+                                 dirtyRoots[nextRoot]) -
+                levelOffsets.begin() - 1);
+        }
+        for (; nextRoot < dirtyRoots.size() &&
+               dirtyRoots[nextRoot] < levelOffsets[depth + 1];
+             nextRoot++) {
+            level.push_back({dirtyRoots[nextRoot], dirtyRoots[nextRoot] + 1});
+        }
+
+        UpdateLevel(pool);
+
+        // Children of consecutive ranges are consecutive too, merge them
+        nextLevel.clear();
+        for (const FRange& range : level) {
+            const FRange childRange = {
+                firstChildren[range.begin],
+                firstChildren[range.end - 1] + childCounts[range.end - 1],
+            };
+            if (childRange.begin == childRange.end) {
+                continue;
+            }
+            if (!nextLevel.empty() &&
+                nextLevel.back().end == childRange.begin) {
+                nextLevel.back().end = childRange.end;
+            } else {
+                nextLevel.push_back(childRange);
+            }
+        }
+        std::swap(level, nextLevel);
+        depth++;
+    }
+}
+
+void FTransformHierarchy::UpdateLevel(FThreadPool* pool)
+{
+    // Ranges can be anything from one node to a whole level, the batches
+    // split their concatenation
+    levelPrefix.resize(level.size() + 1);
+    levelPrefix[0] = 0;
+    for (size_t i = 0; i < level.size(); i++) {
+        levelPrefix[i + 1] = levelPrefix[i] + level[i].end - level[i].begin;
+    }
+    const size_t count = levelPrefix.back();
+    updatedCount += count;
+
+    const auto updateBatch = [this](size_t begin, size_t end) {
+        size_t range = static_cast<size_t>(
+            std::upper_bound(levelPrefix.begin(), levelPrefix.end(), begin) -
+            levelPrefix.begin() - 1);
+
+        for (size_t i = begin; i < end; range++) {
+            const size_t rangeEnd =
+                std::min<size_t>(levelPrefix[range + 1], end);
+            const uint32_t offset = level[range].begin - levelPrefix[range];
+            for (; i < rangeEnd; i++) {
+                UpdateNode(static_cast<uint32_t>(i) + offset);
+            }
+        }
+    };
+
+    if (pool != nullptr) {
+        pool->ParallelFor(count, ParallelBatchSize, updateBatch);
+    } else {
+        updateBatch(0, count);
+    }
+}
+
+void FTransformHierarchy::UpdateNode(uint32_t position)
+{
+    const FLocalTransform& local = locals[position];
+    const FMatrix4 matrix =
+        FMatrix4::FromTransform(local.position, local.rotation, local.scale);
+
+    const uint32_t parent = parents[position];
+    worlds[position] =
+        parent == InvalidTransformNode ? matrix : worlds[parent] * matrix;
+}
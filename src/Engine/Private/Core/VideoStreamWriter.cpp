@@ -0,0 +1,99 @@
+#include "Core/VideoStreamWriter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if !defined(PLATFORM_WINDOWS)
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+bool StartsWith(const std::string& value, const char* prefix)
+{
+    return value.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+#if !defined(PLATFORM_WINDOWS)
+std::FILE* ConnectUnixSocket(const std::string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Unix socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create Unix socket");
+    }
+
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to connect to " + path);
+    }
+
+    return fdopen(fd, "wb");
+}
+#endif
+
+} // namespace
+
+FVideoStreamWriter::FVideoStreamWriter(const std::string& destination)
+    : file(nullptr)
+{
+#if defined(PLATFORM_WINDOWS)
+    if (StartsWith(destination, "fd:") || StartsWith(destination, "unix:")) {
+        throw std::runtime_error("Unsupported video destination on Windows: " +
+                                 destination);
+    }
+#else
+    // A consumer that goes away must fail the write, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (StartsWith(destination, "fd:")) {
+        file = fdopen(std::stoi(destination.substr(3)), "wb");
+    } else if (StartsWith(destination, "unix:")) {
+        file = ConnectUnixSocket(destination.substr(5));
+    }
+#endif
+
+    if (file == nullptr && !StartsWith(destination, "fd:") &&
+        !StartsWith(destination, "unix:")) {
+        file = std::fopen(destination.c_str(), "wb");
+    }
+
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to open video destination " +
+                                 destination);
+    }
+}
+
+FVideoStreamWriter::~FVideoStreamWriter()
+{
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+void FVideoStreamWriter::WriteFrame(const FVideoFrameHeader& header,
+                                    const void* payload)
+{
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(payload, 1, header.payloadSize, file) !=
+            header.payloadSize) {
+        throw std::runtime_error("Failed to write video frame");
+    }
+
+    // Frames are complete units for the consumer, do not hold one back
+    std::fflush(file);
+}
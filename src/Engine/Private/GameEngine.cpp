@@ -1,10 +1,60 @@
 #include "GameEngine.h"
 
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include "Benchmark/BenchmarkReport.h"
+#include "Benchmark/CullingBenchmark.h"
+#include "Benchmark/DrawSortBenchmark.h"
+#include "Benchmark/FrameLoopBenchmark.h"
+#include "Benchmark/InstanceBenchmark.h"
+#include "Benchmark/MathBenchmark.h"
+#include "Benchmark/SceneBenchmark.h"
+#include "Benchmark/TextureStreamingBenchmark.h"
+#include "Benchmark/TransformBenchmark.h"
+#include "Core/CommandLine.h"
 #include "Definition.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanInstance.h"
+#include "VulkanRHI/VulkanMemoryBudget.h"
 #include "VulkanRHI/VulkanRHI.h"
 
+namespace
+{
+
+// One row per heap with what the run left allocated and its peak
+void AddMemoryRows(FBenchmarkReport& report, const FVulkanMemoryBudget& budget)
+{
+    constexpr double MiB = 1024.0 * 1024.0;
+
+    const std::vector<FMemoryHeapBudget> heaps = budget.GetHeaps();
+    for (size_t i = 0; i < heaps.size(); i++) {
+        const FMemoryHeapBudget& heap = heaps[i];
+
+        FBenchmarkReport::FRow& row =
+            report.AddRow("memory_heap_" + std::to_string(i))
+                .Set("device_local", heap.bDeviceLocal ? 1.0 : 0.0)
+                .Set("driver_budget", budget.HasDriverBudget() ? 1.0 : 0.0)
+                .Set("heap_mib", heap.size / MiB)
+                .Set("budget_mib", heap.budget / MiB)
+                .Set("usage_mib", heap.usage / MiB)
+                .Set("allocated_mib", heap.allocated / MiB)
+                .Set("peak_allocated_mib", heap.peakAllocated / MiB);
+
+        for (size_t category = 0; category < heap.categories.size();
+             category++) {
+            const std::string name = GetMemoryCategoryName(
+                static_cast<EMemoryCategory>(category));
+            row.Set(name + "_mib", heap.categories[category] / MiB);
+        }
+    }
+}
+
+} // namespace
+
 GameEngine::GameEngine() {}
 
 GameEngine::~GameEngine() {}
@@ -12,7 +62,13 @@ GameEngine::~GameEngine() {}
 void GameEngine::run()
 {
     init();
-    tick();
+
+    if (FCommandLine::HasParam("benchmark")) {
+        benchmark();
+    } else {
+        tick();
+    }
+
     cleanup();
 }
 
@@ -25,4 +81,42 @@ void GameEngine::init()
 
 void GameEngine::tick() { RHI->Render(); }
 
+void GameEngine::benchmark()
+{
+    const std::string name = FCommandLine::GetString("benchmark", "instances");
+
+    FBenchmarkReport report(name);
+
+    if (name == "instances") {
+        FInstanceBenchmark(RHI.get()).Run(report);
+    } else if (name == "frameloop") {
+        FFrameLoopBenchmark(RHI.get()).Run(report);
+    } else if (name == "texturestreaming") {
+        FTextureStreamingBenchmark(RHI.get()).Run(report);
+    } else if (name == "scene") {
+        FSceneBenchmark(RHI.get()).Run(report);
+    } else if (name == "math") {
+        FMathBenchmark().Run(report);
+    } else if (name == "transforms") {
+        FTransformBenchmark().Run(report);
+    } else if (name == "culling") {
+        FCullingBenchmark().Run(report);
+    } else if (name == "drawsort") {
+        FDrawSortBenchmark().Run(report);
+    } else {
+        throw std::runtime_error("Unknown benchmark: " + name);
+    }
+
+    RHI->WaitIdle();
+
+    AddMemoryRows(report, RHI->GetInstance()
+                              ->GetPhysicalDevice()
+                              ->GetLogicalDevice()
+                              ->GetMemoryBudget());
+
+    report.Print();
+    report.WriteJson(FCommandLine::GetString("benchmarkout",
+                                             "benchmark_" + name + ".json"));
+}
+
 void GameEngine::cleanup() { RHI->Destroy(); }
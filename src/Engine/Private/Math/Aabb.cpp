@@ -0,0 +1,24 @@
+#include "Math/Aabb.h"
+
+#include <cmath>
+
+FAabb Transform(const FMatrix4& matrix, const FAabb& box)
+{
+    if (box.IsEmpty()) {
+        return box;
+    }
+
+    // The extent along each world axis is the sum of the absolute matrix
+    // entries times the local extents
+    const FVector3 center = TransformPoint(matrix, box.GetCenter());
+    const FVector3 extent = box.GetExtent();
+
+    FVector3 worldExtent;
+    for (int row = 0; row < 3; row++) {
+        worldExtent[row] = std::abs(matrix.m[0][row]) * extent.x +
+                           std::abs(matrix.m[1][row]) * extent.y +
+                           std::abs(matrix.m[2][row]) * extent.z;
+    }
+
+    return FAabb::FromCenterExtent(center, worldExtent);
+}
@@ -0,0 +1,70 @@
+#include "Math/Frustum.h"
+
+namespace
+{
+
+FVector4 GetRow(const FMatrix4& matrix, int row)
+{
+    return {matrix.m[0][row], matrix.m[1][row], matrix.m[2][row],
+            matrix.m[3][row]};
+}
+
+FVector4 NormalizePlane(const FVector4& plane)
+{
+    const float length = Length(plane.XYZ());
+    if (length == 0.0f) {
+        return plane;
+    }
+    const float scale = 1.0f / length;
+    return {plane.x * scale, plane.y * scale, plane.z * scale,
+            plane.w * scale};
+}
+
+FVector4 AddRows(const FVector4& a, const FVector4& b, float sign)
+{
+    return {a.x + b.x * sign, a.y + b.y * sign, a.z + b.z * sign,
+            a.w + b.w * sign};
+}
+
+} // namespace
+
+FFrustum FFrustum::FromMatrix(const FMatrix4& viewProjection)
+{
+    // Gribb and Hartmann, clip space is -w <= x, y <= w and 0 <= z <= w with
+    // y pointing down
+    const FVector4 x = GetRow(viewProjection, 0);
+    const FVector4 y = GetRow(viewProjection, 1);
+    const FVector4 z = GetRow(viewProjection, 2);
+    const FVector4 w = GetRow(viewProjection, 3);
+
+    FFrustum frustum;
+    frustum.planes[Left] = NormalizePlane(AddRows(w, x, 1.0f));
+    frustum.planes[Right] = NormalizePlane(AddRows(w, x, -1.0f));
+    frustum.planes[Top] = NormalizePlane(AddRows(w, y, 1.0f));
+    frustum.planes[Bottom] = NormalizePlane(AddRows(w, y, -1.0f));
+    frustum.planes[Near] = NormalizePlane(z);
+    frustum.planes[Far] = NormalizePlane(AddRows(w, z, -1.0f));
+    return frustum;
+}
+
+bool FFrustum::IntersectsSphere(const FVector3& center, float radius) const
+{
+    for (const FVector4& plane : planes) {
+        if (Dot(plane.XYZ(), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FFrustum::IntersectsBox(const FVector3& center,
+                             const FVector3& extent) const
+{
+    for (const FVector4& plane : planes) {
+        const float radius = Dot(Abs(plane.XYZ()), extent);
+        if (Dot(plane.XYZ(), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
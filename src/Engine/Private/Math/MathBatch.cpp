@@ -0,0 +1,321 @@
+#include "Math/MathBatch.h"
+
+#include "Math/SimdFloat.h"
+
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+
+// Rows of the upper 3x4 of a matrix splatted into every lane
+template <typename FFloat> struct TMatrixLanes {
+    FFloat m[4][3];
+
+    explicit TMatrixLanes(const FMatrix4& matrix)
+    {
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 3; row++) {
+                m[column][row] = FFloat::Splat(matrix.m[column][row]);
+            }
+        }
+    }
+
+    FFloat TransformPoint(int row, FFloat x, FFloat y, FFloat z) const
+    {
+        return MulAdd(m[2][row], z, MulAdd(m[1][row], y, MulAdd(m[0][row], x,
+                                                                m[3][row])));
+    }
+};
+
+// Every kernel handles the elements from first on in steps of the lane width
+// and returns where it stopped, the tail goes through FFloat1
+template <typename FFloat>
+size_t TransformPointsKernel(const FMatrix4& matrix, const FPointArrays& input,
+                             const FPointArrays& output, size_t first)
+{
+    const TMatrixLanes<FFloat> lanes(matrix);
+
+    size_t i = first;
+    for (; i + FFloat::Width <= input.count; i += FFloat::Width) {
+        const FFloat x = FFloat::Load(input.x + i);
+        const FFloat y = FFloat::Load(input.y + i);
+        const FFloat z = FFloat::Load(input.z + i);
+
+        lanes.TransformPoint(0, x, y, z).Store(output.x + i);
+        lanes.TransformPoint(1, x, y, z).Store(output.y + i);
+        lanes.TransformPoint(2, x, y, z).Store(output.z + i);
+    }
+    return i;
+}
+
+template <typename FFloat>
+size_t TransformBoundsKernel(const FMatrix4& matrix,
+                             const FBoundsArrays& input,
+                             const FBoundsArrays& output, size_t first)
+{
+    const TMatrixLanes<FFloat> lanes(matrix);
+
+    FFloat absolute[3][3];
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            absolute[column][row] = Abs(lanes.m[column][row]);
+        }
+    }
+
+    float* const centers[3] = {output.centerX, output.centerY, output.centerZ};
+    float* const extents[3] = {output.extentX, output.extentY, output.extentZ};
+
+    size_t i = first;
+    for (; i + FFloat::Width <= input.count; i += FFloat::Width) {
+        const FFloat x = FFloat::Load(input.centerX + i);
+        const FFloat y = FFloat::Load(input.centerY + i);
+        const FFloat z = FFloat::Load(input.centerZ + i);
+        const FFloat ex = FFloat::Load(input.extentX + i);
+        const FFloat ey = FFloat::Load(input.extentY + i);
+        const FFloat ez = FFloat::Load(input.extentZ + i);
+
+        for (int row = 0; row < 3; row++) {
+            lanes.TransformPoint(row, x, y, z).Store(centers[row] + i);
+            MulAdd(absolute[2][row], ez,
+                   MulAdd(absolute[1][row], ey, absolute[0][row] * ex))
+                .Store(extents[row] + i);
+        }
+    }
+    return i;
+}
+
+template <typename FFloat>
+size_t TransformSpheresKernel(const FMatrix4& matrix,
+                              const FSphereArrays& input,
+                              const FSphereArrays& output, size_t first)
+{
+    const TMatrixLanes<FFloat> lanes(matrix);
+    const FFloat scale = FFloat::Splat(GetMaxScale(matrix));
+
+    size_t i = first;
+    for (; i + FFloat::Width <= input.count; i += FFloat::Width) {
+        const FFloat x = FFloat::Load(input.centerX + i);
+        const FFloat y = FFloat::Load(input.centerY + i);
+        const FFloat z = FFloat::Load(input.centerZ + i);
+
+        lanes.TransformPoint(0, x, y, z).Store(output.centerX + i);
+        lanes.TransformPoint(1, x, y, z).Store(output.centerY + i);
+        lanes.TransformPoint(2, x, y, z).Store(output.centerZ + i);
+        (FFloat::Load(input.radius + i) * scale).Store(output.radius + i);
+    }
+    return i;
+}
+
+// Frustum planes splatted into every lane
+template <typename FFloat> struct TFrustumLanes {
+    FFloat planes[FFrustum::PlaneCount][4];
+
+    explicit TFrustumLanes(const FFrustum& frustum)
+    {
+        for (int plane = 0; plane < FFrustum::PlaneCount; plane++) {
+            for (int axis = 0; axis < 4; axis++) {
+                planes[plane][axis] =
+                    FFloat::Splat(frustum.planes[plane][axis]);
+            }
+        }
+    }
+
+    FFloat GetDistance(int plane, FFloat x, FFloat y, FFloat z) const
+    {
+        const FFloat(&p)[4] = planes[plane];
+        return MulAdd(p[2], z, MulAdd(p[1], y, MulAdd(p[0], x, p[3])));
+    }
+};
+
+// Appends the set bits of the lane mask as indices
+inline size_t WriteVisible(uint32_t mask, uint32_t index, uint32_t* visible,
+                           size_t count)
+{
+    for (; mask != 0; mask &= mask - 1) {
+        visible[count++] =
+            index + static_cast<uint32_t>(std::countr_zero(mask));
+    }
+    return count;
+}
+
+template <typename FFloat>
+size_t CullSpheresKernel(const FFrustum& frustum, const FSphereArrays& spheres,
+                         uint32_t firstIndex, uint32_t* visible, size_t first,
+                         size_t& visibleCount)
+{
+    const TFrustumLanes<FFloat> lanes(frustum);
+    const FFloat zero = FFloat::Splat(0.0f);
+    constexpr uint32_t allLanes = (1u << FFloat::Width) - 1;
+
+    size_t i = first;
+    for (; i + FFloat::Width <= spheres.count; i += FFloat::Width) {
+        const FFloat x = FFloat::Load(spheres.centerX + i);
+        const FFloat y = FFloat::Load(spheres.centerY + i);
+        const FFloat z = FFloat::Load(spheres.centerZ + i);
+        const FFloat radius = FFloat::Load(spheres.radius + i);
+
+        uint32_t mask = allLanes;
+        for (int plane = 0; plane < FFrustum::PlaneCount && mask != 0;
+             plane++) {
+            mask &= CompareLessEqual(
+                zero, lanes.GetDistance(plane, x, y, z) + radius);
+        }
+        visibleCount =
+            WriteVisible(mask, firstIndex + static_cast<uint32_t>(i), visible,
+                         visibleCount);
+    }
+    return i;
+}
+
+template <typename FFloat>
+size_t CullBoundsKernel(const FFrustum& frustum, const FBoundsArrays& bounds,
+                        uint32_t firstIndex, uint32_t* visible, size_t first,
+                        size_t& visibleCount)
+{
+    const TFrustumLanes<FFloat> lanes(frustum);
+    const FFloat zero = FFloat::Splat(0.0f);
+    constexpr uint32_t allLanes = (1u << FFloat::Width) - 1;
+
+    FFloat absolute[FFrustum::PlaneCount][3];
+    for (int plane = 0; plane < FFrustum::PlaneCount; plane++) {
+        for (int axis = 0; axis < 3; axis++) {
+            absolute[plane][axis] = Abs(lanes.planes[plane][axis]);
+        }
+    }
+
+    size_t i = first;
+    for (; i + FFloat::Width <= bounds.count; i += FFloat::Width) {
+        const FFloat x = FFloat::Load(bounds.centerX + i);
+        const FFloat y = FFloat::Load(bounds.centerY + i);
+        const FFloat z = FFloat::Load(bounds.centerZ + i);
+        const FFloat ex = FFloat::Load(bounds.extentX + i);
+        const FFloat ey = FFloat::Load(bounds.extentY + i);
+        const FFloat ez = FFloat::Load(bounds.extentZ + i);
+
+        // The box reaches as far along the normal as its extent projects
+        uint32_t mask = allLanes;
+        for (int plane = 0; plane < FFrustum::PlaneCount && mask != 0;
+             plane++) {
+            const FFloat(&a)[3] = absolute[plane];
+            const FFloat radius =
+                MulAdd(a[2], ez, MulAdd(a[1], ey, a[0] * ex));
+            mask &= CompareLessEqual(
+                zero, lanes.GetDistance(plane, x, y, z) + radius);
+        }
+        visibleCount =
+            WriteVisible(mask, firstIndex + static_cast<uint32_t>(i), visible,
+                         visibleCount);
+    }
+    return i;
+}
+
+FMatrix4 MultiplyScalar(const FMatrix4& a, const FMatrix4& b)
+{
+    FMatrix4 result;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                sum += a.m[k][row] * b.m[column][k];
+            }
+            result.m[column][row] = sum;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+const char* FMathBatch::GetNativeBackendName() { return MATH_SIMD_NAME; }
+
+size_t FMathBatch::GetNativeWidth() { return FFloatNative::Width; }
+
+void FMathBatch::TransformPoints(const FMatrix4& matrix,
+                                 const FPointArrays& input,
+                                 const FPointArrays& output,
+                                 EMathBackend backend)
+{
+    assert(output.count >= input.count);
+
+    size_t i = 0;
+    if (backend == EMathBackend::Native) {
+        i = TransformPointsKernel<FFloatNative>(matrix, input, output, i);
+    }
+    TransformPointsKernel<FFloat1>(matrix, input, output, i);
+}
+
+void FMathBatch::TransformBounds(const FMatrix4& matrix,
+                                 const FBoundsArrays& input,
+                                 const FBoundsArrays& output,
+                                 EMathBackend backend)
+{
+    assert(output.count >= input.count);
+
+    size_t i = 0;
+    if (backend == EMathBackend::Native) {
+        i = TransformBoundsKernel<FFloatNative>(matrix, input, output, i);
+    }
+    TransformBoundsKernel<FFloat1>(matrix, input, output, i);
+}
+
+void FMathBatch::TransformSpheres(const FMatrix4& matrix,
+                                  const FSphereArrays& input,
+                                  const FSphereArrays& output,
+                                  EMathBackend backend)
+{
+    assert(output.count >= input.count);
+
+    size_t i = 0;
+    if (backend == EMathBackend::Native) {
+        i = TransformSpheresKernel<FFloatNative>(matrix, input, output, i);
+    }
+    TransformSpheresKernel<FFloat1>(matrix, input, output, i);
+}
+
+size_t FMathBatch::CullSpheres(const FFrustum& frustum,
+                               const FSphereArrays& spheres,
+                               uint32_t firstIndex, uint32_t* visible,
+                               EMathBackend backend)
+{
+    size_t visibleCount = 0;
+    size_t i = 0;
+    if (backend == EMathBackend::Native) {
+        i = CullSpheresKernel<FFloatNative>(frustum, spheres, firstIndex,
+                                            visible, i, visibleCount);
+    }
+    CullSpheresKernel<FFloat1>(frustum, spheres, firstIndex, visible, i,
+                               visibleCount);
+    return visibleCount;
+}
+
+size_t FMathBatch::CullBounds(const FFrustum& frustum,
+                              const FBoundsArrays& bounds, uint32_t firstIndex,
+                              uint32_t* visible, EMathBackend backend)
+{
+    size_t visibleCount = 0;
+    size_t i = 0;
+    if (backend == EMathBackend::Native) {
+        i = CullBoundsKernel<FFloatNative>(frustum, bounds, firstIndex,
+                                           visible, i, visibleCount);
+    }
+    CullBoundsKernel<FFloat1>(frustum, bounds, firstIndex, visible, i,
+                              visibleCount);
+    return visibleCount;
+}
+
+void FMathBatch::MultiplyMatrices(const FMatrix4* a, const FMatrix4* b,
+                                  FMatrix4* output, size_t count,
+                                  EMathBackend backend)
+{
+    if (backend == EMathBackend::Native) {
+        for (size_t i = 0; i < count; i++) {
+            output[i] = a[i] * b[i];
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            output[i] = MultiplyScalar(a[i], b[i]);
+        }
+    }
+}
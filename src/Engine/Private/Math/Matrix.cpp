@@ -0,0 +1,181 @@
+#include "Math/Matrix.h"
+
+#include "Math/SimdFloat.h"
+
+#include <algorithm>
+#include <cmath>
+
+FMatrix4 FMatrix4::Identity()
+{
+    FMatrix4 result;
+    for (int i = 0; i < 4; i++) {
+        result.m[i][i] = 1.0f;
+    }
+    return result;
+}
+
+FMatrix4 FMatrix4::FromTransform(const FVector3& translation,
+                                 const FQuaternion& rotation,
+                                 const FVector3& scale)
+{
+    const float x = rotation.x;
+    const float y = rotation.y;
+    const float z = rotation.z;
+    const float w = rotation.w;
+
+    FMatrix4 result;
+    result.m[0][0] = (1.0f - 2.0f * (y * y + z * z)) * scale.x;
+    result.m[0][1] = (2.0f * (x * y + w * z)) * scale.x;
+    result.m[0][2] = (2.0f * (x * z - w * y)) * scale.x;
+
+    result.m[1][0] = (2.0f * (x * y - w * z)) * scale.y;
+    result.m[1][1] = (1.0f - 2.0f * (x * x + z * z)) * scale.y;
+    result.m[1][2] = (2.0f * (y * z + w * x)) * scale.y;
+
+    result.m[2][0] = (2.0f * (x * z + w * y)) * scale.z;
+    result.m[2][1] = (2.0f * (y * z - w * x)) * scale.z;
+    result.m[2][2] = (1.0f - 2.0f * (x * x + y * y)) * scale.z;
+
+    result.m[3][0] = translation.x;
+    result.m[3][1] = translation.y;
+    result.m[3][2] = translation.z;
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+FMatrix4 FMatrix4::LookAt(const FVector3& eye, const FVector3& target,
+                          const FVector3& up)
+{
+    const FVector3 forward = Normalize(target - eye);
+    const FVector3 right = Normalize(Cross(forward, up));
+    const FVector3 cameraUp = Cross(right, forward);
+
+    FMatrix4 result = Identity();
+    for (int axis = 0; axis < 3; axis++) {
+        result.m[axis][0] = right[axis];
+        result.m[axis][1] = cameraUp[axis];
+        result.m[axis][2] = -forward[axis];
+    }
+    result.m[3][0] = -Dot(right, eye);
+    result.m[3][1] = -Dot(cameraUp, eye);
+    result.m[3][2] = Dot(forward, eye);
+    return result;
+}
+
+FMatrix4 FMatrix4::Perspective(float verticalFov, float aspectRatio,
+                               float nearPlane, float farPlane)
+{
+    const float focalLength = 1.0f / std::tan(verticalFov * 0.5f);
+
+    FMatrix4 result;
+    result.m[0][0] = focalLength / aspectRatio;
+    result.m[1][1] = -focalLength;
+    result.m[2][2] = farPlane / (nearPlane - farPlane);
+    result.m[2][3] = -1.0f;
+    result.m[3][2] = nearPlane * farPlane / (nearPlane - farPlane);
+    return result;
+}
+
+FMatrix4 operator*(const FMatrix4& a, const FMatrix4& b)
+{
+    FMatrix4 result;
+
+#if defined(MATH_HAS_FLOAT4)
+    const FFloat4 columns[4] = {
+        FFloat4::Load(a.m[0]),
+        FFloat4::Load(a.m[1]),
+        FFloat4::Load(a.m[2]),
+        FFloat4::Load(a.m[3]),
+    };
+
+    for (int column = 0; column < 4; column++) {
+        FFloat4 sum = columns[0] * FFloat4::Splat(b.m[column][0]);
+        sum = MulAdd(columns[1], FFloat4::Splat(b.m[column][1]), sum);
+        sum = MulAdd(columns[2], FFloat4::Splat(b.m[column][2]), sum);
+        sum = MulAdd(columns[3], FFloat4::Splat(b.m[column][3]), sum);
+        sum.Store(result.m[column]);
+    }
+#else
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            result.m[column][row] = a.m[0][row] * b.m[column][0] +
+                                    a.m[1][row] * b.m[column][1] +
+                                    a.m[2][row] * b.m[column][2] +
+                                    a.m[3][row] * b.m[column][3];
+        }
+    }
+#endif
+
+    return result;
+}
+
+FMatrix4 Transpose(const FMatrix4& matrix)
+{
+    FMatrix4 result;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            result.m[column][row] = matrix.m[row][column];
+        }
+    }
+    return result;
+}
+
+FMatrix4 AffineInverse(const FMatrix4& matrix)
+{
+    const FVector3 x = matrix.GetColumn(0);
+    const FVector3 y = matrix.GetColumn(1);
+    const FVector3 z = matrix.GetColumn(2);
+
+    // Rows of the inverse of the upper 3x3 are the cross products of its
+    // columns over the determinant
+    const FVector3 yz = Cross(y, z);
+    const FVector3 zx = Cross(z, x);
+    const FVector3 xy = Cross(x, y);
+    const float determinant = Dot(x, yz);
+    const float inverseDeterminant =
+        determinant != 0.0f ? 1.0f / determinant : 0.0f;
+
+    const FVector3 rows[3] = {yz * inverseDeterminant, zx * inverseDeterminant,
+                              xy * inverseDeterminant};
+
+    FMatrix4 result = FMatrix4::Identity();
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result.m[column][row] = rows[row][column];
+        }
+        result.m[3][row] = -Dot(rows[row], matrix.GetTranslation());
+    }
+    return result;
+}
+
+FVector3 TransformPoint(const FMatrix4& matrix, const FVector3& point)
+{
+    return matrix.GetColumn(0) * point.x + matrix.GetColumn(1) * point.y +
+           matrix.GetColumn(2) * point.z + matrix.GetColumn(3);
+}
+
+FVector3 TransformVector(const FMatrix4& matrix, const FVector3& vector)
+{
+    return matrix.GetColumn(0) * vector.x + matrix.GetColumn(1) * vector.y +
+           matrix.GetColumn(2) * vector.z;
+}
+
+FVector4 Transform(const FMatrix4& matrix, const FVector4& vector)
+{
+    FVector4 result;
+    for (int row = 0; row < 4; row++) {
+        result[row] = matrix.m[0][row] * vector.x +
+                      matrix.m[1][row] * vector.y +
+                      matrix.m[2][row] * vector.z +
+                      matrix.m[3][row] * vector.w;
+    }
+    return result;
+}
+
+float GetMaxScale(const FMatrix4& matrix)
+{
+    const FVector3 x = matrix.GetColumn(0);
+    const FVector3 y = matrix.GetColumn(1);
+    const FVector3 z = matrix.GetColumn(2);
+    return std::sqrt(std::max({Dot(x, x), Dot(y, y), Dot(z, z)}));
+}
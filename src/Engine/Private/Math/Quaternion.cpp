@@ -0,0 +1,75 @@
+#include "Math/Quaternion.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Below this angle between the rotations slerp degenerates, lerp is exact
+// enough
+constexpr float SlerpLerpThreshold = 0.9995f;
+
+} // namespace
+
+FQuaternion FQuaternion::FromAxisAngle(const FVector3& axis, float angle)
+{
+    const float s = std::sin(angle * 0.5f);
+    return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+}
+
+FQuaternion operator*(const FQuaternion& a, const FQuaternion& b)
+{
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
+
+FQuaternion Normalize(const FQuaternion& q)
+{
+    const float length =
+        std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length == 0.0f) {
+        return FQuaternion::Identity();
+    }
+
+    const float scale = 1.0f / length;
+    return {q.x * scale, q.y * scale, q.z * scale, q.w * scale};
+}
+
+FVector3 Rotate(const FQuaternion& q, const FVector3& v)
+{
+    // v + 2w (u x v) + 2 u x (u x v), with u the vector part
+    const FVector3 u = {q.x, q.y, q.z};
+    const FVector3 t = Cross(u, v) * 2.0f;
+    return v + t * q.w + Cross(u, t);
+}
+
+FQuaternion Slerp(const FQuaternion& a, const FQuaternion& b, float t)
+{
+    float cosine = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+
+    FQuaternion target = b;
+    if (cosine < 0.0f) {
+        cosine = -cosine;
+        target = {-b.x, -b.y, -b.z, -b.w};
+    }
+
+    float weightA = 1.0f - t;
+    float weightB = t;
+    if (cosine < SlerpLerpThreshold) {
+        const float angle = std::acos(cosine);
+        const float inverseSine = 1.0f / std::sin(angle);
+        weightA = std::sin((1.0f - t) * angle) * inverseSine;
+        weightB = std::sin(t * angle) * inverseSine;
+    }
+
+    return Normalize({
+        a.x * weightA + target.x * weightB,
+        a.y * weightA + target.y * weightB,
+        a.z * weightA + target.z * weightB,
+        a.w * weightA + target.w * weightB,
+    });
+}
@@ -0,0 +1,275 @@
+#include "VulkanRHI/Ktx2TextureSource.h"
+
+#include "Core/BlockDecoder.h"
+#include "Core/FileManager.h"
+#include "Core/Inflate.h"
+#include "Core/ThreadPool.h"
+#include "VulkanRHI/VulkanGPU.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#if defined(WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace
+{
+
+constexpr uint8_t Ktx2Identifier[12] = {0xab, 'K',  'T',  'X', ' ',  '2',
+                                        '0',  0xbb, '\r', '\n', 0x1a, '\n'};
+
+struct FKtx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+static_assert(sizeof(FKtx2Header) == 80, "KTX2 header layout");
+
+// BC1 to BC5 are decoded to the matching 8-bit format, nothing else has a
+// CPU path
+struct FFallback {
+    EBlockFormat blockFormat;
+    vk::Format format;
+};
+
+std::optional<FFallback> GetFallback(vk::Format format)
+{
+    switch (format) {
+    case vk::Format::eBc1RgbUnormBlock:
+    case vk::Format::eBc1RgbaUnormBlock:
+        return FFallback{EBlockFormat::BC1, vk::Format::eR8G8B8A8Unorm};
+    case vk::Format::eBc1RgbSrgbBlock:
+    case vk::Format::eBc1RgbaSrgbBlock:
+        return FFallback{EBlockFormat::BC1, vk::Format::eR8G8B8A8Srgb};
+    case vk::Format::eBc2UnormBlock:
+        return FFallback{EBlockFormat::BC2, vk::Format::eR8G8B8A8Unorm};
+    case vk::Format::eBc2SrgbBlock:
+        return FFallback{EBlockFormat::BC2, vk::Format::eR8G8B8A8Srgb};
+    case vk::Format::eBc3UnormBlock:
+        return FFallback{EBlockFormat::BC3, vk::Format::eR8G8B8A8Unorm};
+    case vk::Format::eBc3SrgbBlock:
+        return FFallback{EBlockFormat::BC3, vk::Format::eR8G8B8A8Srgb};
+    case vk::Format::eBc4UnormBlock:
+        return FFallback{EBlockFormat::BC4, vk::Format::eR8Unorm};
+    case vk::Format::eBc5UnormBlock:
+        return FFallback{EBlockFormat::BC5, vk::Format::eR8G8Unorm};
+    default:
+        return std::nullopt;
+    }
+}
+
+void Decompress(EKtx2Supercompression scheme, std::span<const uint8_t> input,
+                std::span<uint8_t> output)
+{
+    switch (scheme) {
+    case EKtx2Supercompression::Zlib:
+        FInflate::DecompressZlib(input, output);
+        return;
+#if defined(WITH_ZSTD)
+    case EKtx2Supercompression::Zstandard: {
+        const size_t result = ZSTD_decompress(output.data(), output.size(),
+                                              input.data(), input.size());
+        if (ZSTD_isError(result) || result != output.size()) {
+            throw std::runtime_error("Invalid Zstandard mip data");
+        }
+        return;
+    }
+#endif
+    default:
+        throw std::runtime_error("Unsupported KTX2 supercompression");
+    }
+}
+
+} // namespace
+
+FKtx2TextureSource::FKtx2TextureSource(const std::string& filename,
+                                       const FVulkanGpu& gpu)
+    : filename(filename), file(FileManager::MapFile(filename))
+{
+    FKtx2Header header;
+    if (file.GetFileSize() < sizeof(header)) {
+        throw std::runtime_error(filename + " is not a KTX2 file");
+    }
+    std::memcpy(&header, file.GetBytes(), sizeof(header));
+
+    if (std::memcmp(header.identifier, Ktx2Identifier,
+                    sizeof(Ktx2Identifier)) != 0) {
+        throw std::runtime_error(filename + " is not a KTX2 file");
+    }
+
+    storedFormat = static_cast<vk::Format>(header.vkFormat);
+    extent = {.width = header.pixelWidth, .height = header.pixelHeight};
+    supercompression =
+        static_cast<EKtx2Supercompression>(header.supercompressionScheme);
+
+    if (storedFormat == vk::Format::eUndefined) {
+        throw std::runtime_error(
+            filename + ": Basis Universal textures are not supported");
+    }
+    if (header.pixelDepth > 1 || header.layerCount > 1 ||
+        header.faceCount != 1 || extent.width == 0 || extent.height == 0) {
+        throw std::runtime_error(filename + ": only 2D textures are supported");
+    }
+
+    switch (supercompression) {
+    case EKtx2Supercompression::None:
+    case EKtx2Supercompression::Zlib:
+        break;
+#if defined(WITH_ZSTD)
+    case EKtx2Supercompression::Zstandard:
+        break;
+#endif
+    default:
+        throw std::runtime_error(
+            filename + ": unsupported supercompression scheme " +
+            std::to_string(header.supercompressionScheme));
+    }
+
+    // A level count of 0 asks for mips to be generated, only the base is
+    // stored
+    const uint32_t levelCount = std::max(header.levelCount, 1u);
+    if (levelCount > GetFullMipCount(extent)) {
+        throw std::runtime_error(filename + ": too many mip levels");
+    }
+
+    const size_t indexEnd = sizeof(header) + levelCount * sizeof(FLevel);
+    if (file.GetFileSize() < indexEnd) {
+        throw std::runtime_error(filename + ": truncated level index");
+    }
+
+    // GetImageSize throws for formats the streamer cannot size
+    levels.resize(levelCount);
+    for (uint32_t mip = 0; mip < levelCount; mip++) {
+        FLevel& level = levels[mip];
+        std::memcpy(&level,
+                    file.GetBytes() + sizeof(header) + mip * sizeof(FLevel),
+                    sizeof(FLevel));
+
+        if (level.byteOffset > file.GetFileSize() ||
+            level.byteLength > file.GetFileSize() - level.byteOffset) {
+            throw std::runtime_error(filename + ": mip " + std::to_string(mip) +
+                                     " is out of bounds");
+        }
+
+        if (supercompression == EKtx2Supercompression::None) {
+            level.uncompressedByteLength = level.byteLength;
+        }
+
+        if (level.uncompressedByteLength !=
+            GetImageSize(storedFormat, GetMipExtent(mip))) {
+            throw std::runtime_error(filename + ": mip " + std::to_string(mip) +
+                                     " has an unexpected size");
+        }
+    }
+
+    uploadFormat = storedFormat;
+
+    if (!IsFormatSupported(gpu, storedFormat)) {
+        const std::optional<FFallback> decoded = GetFallback(storedFormat);
+        if (!decoded.has_value() ||
+            !IsFormatSupported(gpu, decoded->format)) {
+            throw std::runtime_error(filename + ": " +
+                                     vk::to_string(storedFormat) +
+                                     " is not supported by the GPU");
+        }
+
+        fallback = decoded->blockFormat;
+        uploadFormat = decoded->format;
+
+        std::cout << filename << ": " << vk::to_string(storedFormat)
+                  << " is not supported, decoding to "
+                  << vk::to_string(uploadFormat) << std::endl;
+    }
+}
+
+size_t FKtx2TextureSource::GetMipSize(uint32_t mip) const
+{
+    return GetImageSize(uploadFormat, GetMipExtent(mip));
+}
+
+void FKtx2TextureSource::ReadMip(uint32_t mip,
+                                 FileManager::FReadCallback onComplete) const
+{
+    const FLevel& level = levels[mip];
+    const vk::Extent2D mipExtent = GetMipExtent(mip);
+    const size_t mipSize = GetMipSize(mip);
+
+    // Stored blocks are uploaded from the mapping without a copy
+    FileBlob stored = file.Slice(level.byteOffset, level.byteLength);
+    if (supercompression == EKtx2Supercompression::None &&
+        !fallback.has_value()) {
+        onComplete(std::move(stored));
+        return;
+    }
+
+    FThreadPool::Get().Enqueue([stored = std::move(stored), level, mipExtent,
+                                mipSize, scheme = supercompression,
+                                fallback = fallback, filename = filename,
+                                onComplete = std::move(onComplete)]() {
+        std::optional<FileBlob> result;
+
+        try {
+            std::span<const uint8_t> blocks(
+                reinterpret_cast<const uint8_t*>(stored.GetBytes()),
+                stored.GetFileSize());
+
+            std::vector<uint8_t> decompressed;
+            if (scheme != EKtx2Supercompression::None) {
+                decompressed.resize(level.uncompressedByteLength);
+                Decompress(scheme, blocks, decompressed);
+                blocks = decompressed;
+            }
+
+            std::vector<char> pixels(mipSize);
+            if (fallback.has_value()) {
+                FBlockDecoder::Decode(
+                    *fallback, blocks, mipExtent.width, mipExtent.height,
+                    {reinterpret_cast<uint8_t*>(pixels.data()), pixels.size()});
+            } else {
+                std::memcpy(pixels.data(), blocks.data(), pixels.size());
+            }
+
+            result = FileBlob(std::move(pixels));
+        } catch (const std::exception& e) {
+            std::cerr << filename << ": " << e.what() << std::endl;
+        }
+
+        onComplete(std::move(result));
+    });
+}
+
+bool FKtx2TextureSource::IsFormatSupported(const FVulkanGpu& gpu,
+                                           vk::Format format)
+{
+    const vk::FormatFeatureFlags required =
+        vk::FormatFeatureFlagBits::eSampledImage |
+        vk::FormatFeatureFlagBits::eTransferSrc |
+        vk::FormatFeatureFlagBits::eTransferDst;
+
+    return (gpu.GetFormatProperties(format).optimalTilingFeatures &
+            required) == required;
+}
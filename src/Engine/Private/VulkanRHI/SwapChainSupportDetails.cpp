@@ -9,18 +9,13 @@
 
 #include "VulkanRHI/VulkanCommon.h"
 
-FSwapChainSupportDetails::FSwapChainSupportDetails(vk::PhysicalDevice device,
-                                                   vk::SurfaceKHR surface)
-    : device(device), surface(surface)
+FSwapChainSupportDetails::FSwapChainSupportDetails(
+    vk::SurfaceKHR surface, const vk::SurfaceCapabilitiesKHR& capabilities,
+    const std::vector<vk::SurfaceFormatKHR>& formats,
+    const std::vector<vk::PresentModeKHR>& presentModes)
+    : capabilities(capabilities), formats(formats), presentModes(presentModes),
+      surface(surface)
 {
-    VERIFY_VULKAN_RESULT(
-        device.getSurfaceCapabilitiesKHR(surface, &capabilities));
-
-    // Get the number of formats supported by the surface
-    formats = device.getSurfaceFormatsKHR(surface);
-
-    // Get the number of present modes supported by the surface
-    presentModes = device.getSurfacePresentModesKHR(surface);
 }
 
 vk::SurfaceFormatKHR FSwapChainSupportDetails::GetRequiredSurfaceFormat() const
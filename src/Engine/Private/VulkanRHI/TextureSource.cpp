@@ -0,0 +1,200 @@
+#include "VulkanRHI/TextureSource.h"
+
+#include "Core/FileManager.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+vk::Extent2D FTextureSource::GetMipExtent(uint32_t mip) const
+{
+    const vk::Extent2D extent = GetExtent();
+
+    return {
+        .width = std::max(extent.width >> mip, 1u),
+        .height = std::max(extent.height >> mip, 1u),
+    };
+}
+
+uint32_t FTextureSource::GetFullMipCount(vk::Extent2D extent)
+{
+    return static_cast<uint32_t>(
+        std::bit_width(std::max(extent.width, extent.height)));
+}
+
+FTextureBlockInfo FTextureSource::GetBlockInfo(vk::Format format)
+{
+    switch (format) {
+    case vk::Format::eR8Unorm:
+        return {.width = 1, .height = 1, .bytes = 1};
+    case vk::Format::eR8G8Unorm:
+        return {.width = 1, .height = 1, .bytes = 2};
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+        return {.width = 1, .height = 1, .bytes = 4};
+    case vk::Format::eR16G16B16A16Sfloat:
+        return {.width = 1, .height = 1, .bytes = 8};
+    case vk::Format::eR32G32B32A32Sfloat:
+        return {.width = 1, .height = 1, .bytes = 16};
+
+    case vk::Format::eBc1RgbUnormBlock:
+    case vk::Format::eBc1RgbSrgbBlock:
+    case vk::Format::eBc1RgbaUnormBlock:
+    case vk::Format::eBc1RgbaSrgbBlock:
+    case vk::Format::eBc4UnormBlock:
+    case vk::Format::eBc4SnormBlock:
+    case vk::Format::eEtc2R8G8B8UnormBlock:
+    case vk::Format::eEtc2R8G8B8SrgbBlock:
+    case vk::Format::eEtc2R8G8B8A1UnormBlock:
+    case vk::Format::eEtc2R8G8B8A1SrgbBlock:
+    case vk::Format::eEacR11UnormBlock:
+    case vk::Format::eEacR11SnormBlock:
+        return {.width = 4, .height = 4, .bytes = 8};
+    case vk::Format::eBc2UnormBlock:
+    case vk::Format::eBc2SrgbBlock:
+    case vk::Format::eBc3UnormBlock:
+    case vk::Format::eBc3SrgbBlock:
+    case vk::Format::eBc5UnormBlock:
+    case vk::Format::eBc5SnormBlock:
+    case vk::Format::eBc6HUfloatBlock:
+    case vk::Format::eBc6HSfloatBlock:
+    case vk::Format::eBc7UnormBlock:
+    case vk::Format::eBc7SrgbBlock:
+    case vk::Format::eEtc2R8G8B8A8UnormBlock:
+    case vk::Format::eEtc2R8G8B8A8SrgbBlock:
+    case vk::Format::eEacR11G11UnormBlock:
+    case vk::Format::eEacR11G11SnormBlock:
+        return {.width = 4, .height = 4, .bytes = 16};
+
+    // Every ASTC block is 16 bytes
+    case vk::Format::eAstc4x4UnormBlock:
+    case vk::Format::eAstc4x4SrgbBlock:
+        return {.width = 4, .height = 4, .bytes = 16};
+    case vk::Format::eAstc5x4UnormBlock:
+    case vk::Format::eAstc5x4SrgbBlock:
+        return {.width = 5, .height = 4, .bytes = 16};
+    case vk::Format::eAstc5x5UnormBlock:
+    case vk::Format::eAstc5x5SrgbBlock:
+        return {.width = 5, .height = 5, .bytes = 16};
+    case vk::Format::eAstc6x5UnormBlock:
+    case vk::Format::eAstc6x5SrgbBlock:
+        return {.width = 6, .height = 5, .bytes = 16};
+    case vk::Format::eAstc6x6UnormBlock:
+    case vk::Format::eAstc6x6SrgbBlock:
+        return {.width = 6, .height = 6, .bytes = 16};
+    case vk::Format::eAstc8x5UnormBlock:
+    case vk::Format::eAstc8x5SrgbBlock:
+        return {.width = 8, .height = 5, .bytes = 16};
+    case vk::Format::eAstc8x6UnormBlock:
+    case vk::Format::eAstc8x6SrgbBlock:
+        return {.width = 8, .height = 6, .bytes = 16};
+    case vk::Format::eAstc8x8UnormBlock:
+    case vk::Format::eAstc8x8SrgbBlock:
+        return {.width = 8, .height = 8, .bytes = 16};
+    case vk::Format::eAstc10x5UnormBlock:
+    case vk::Format::eAstc10x5SrgbBlock:
+        return {.width = 10, .height = 5, .bytes = 16};
+    case vk::Format::eAstc10x6UnormBlock:
+    case vk::Format::eAstc10x6SrgbBlock:
+        return {.width = 10, .height = 6, .bytes = 16};
+    case vk::Format::eAstc10x8UnormBlock:
+    case vk::Format::eAstc10x8SrgbBlock:
+        return {.width = 10, .height = 8, .bytes = 16};
+    case vk::Format::eAstc10x10UnormBlock:
+    case vk::Format::eAstc10x10SrgbBlock:
+        return {.width = 10, .height = 10, .bytes = 16};
+    case vk::Format::eAstc12x10UnormBlock:
+    case vk::Format::eAstc12x10SrgbBlock:
+        return {.width = 12, .height = 10, .bytes = 16};
+    case vk::Format::eAstc12x12UnormBlock:
+    case vk::Format::eAstc12x12SrgbBlock:
+        return {.width = 12, .height = 12, .bytes = 16};
+
+    default:
+        throw std::runtime_error("Unsupported texture format " +
+                                 vk::to_string(format));
+    }
+}
+
+size_t FTextureSource::GetImageSize(vk::Format format, vk::Extent2D extent)
+{
+    const FTextureBlockInfo block = GetBlockInfo(format);
+
+    const size_t blocksX = (extent.width + block.width - 1) / block.width;
+    const size_t blocksY = (extent.height + block.height - 1) / block.height;
+    return blocksX * blocksY * block.bytes;
+}
+
+FRawTextureSource::FRawTextureSource(const std::string& filename,
+                                     vk::Format format, vk::Extent2D extent,
+                                     uint32_t mipCount)
+    : filename(filename), format(format), extent(extent),
+      mipCount(std::clamp(mipCount, 1u, GetFullMipCount(extent)))
+{
+    uint64_t offset = 0;
+    for (uint32_t mip = 0; mip < this->mipCount; mip++) {
+        mipOffsets.push_back(offset);
+        offset += GetMipSize(mip);
+    }
+}
+
+size_t FRawTextureSource::GetMipSize(uint32_t mip) const
+{
+    return GetImageSize(format, GetMipExtent(mip));
+}
+
+void FRawTextureSource::ReadMip(uint32_t mip,
+                                FileManager::FReadCallback onComplete) const
+{
+    FileManager::ReadFileAsync(filename, mipOffsets[mip], GetMipSize(mip),
+                               std::move(onComplete));
+}
+
+FProceduralTextureSource::FProceduralTextureSource(vk::Extent2D extent,
+                                                   uint32_t seed)
+    : extent(extent), mipCount(GetFullMipCount(extent)), seed(seed)
+{
+}
+
+size_t FProceduralTextureSource::GetMipSize(uint32_t mip) const
+{
+    const vk::Extent2D mipExtent = GetMipExtent(mip);
+    return static_cast<size_t>(mipExtent.width) * mipExtent.height * 4;
+}
+
+void FProceduralTextureSource::ReadMip(
+    uint32_t mip, FileManager::FReadCallback onComplete) const
+{
+    const vk::Extent2D mipExtent = GetMipExtent(mip);
+    const uint32_t color = (seed * 0x9e3779b9u) ^ (mip * 0x85ebca6bu);
+
+    FThreadPool::Get().Enqueue([mipExtent, color,
+                                onComplete = std::move(onComplete)]() {
+        std::vector<char> pixels(static_cast<size_t>(mipExtent.width) *
+                                 mipExtent.height * 4);
+
+        // 8x8 checker cells at every level
+        for (uint32_t y = 0; y < mipExtent.height; y++) {
+            for (uint32_t x = 0; x < mipExtent.width; x++) {
+                const bool bLight = ((x >> 3) ^ (y >> 3)) & 1;
+                const size_t offset =
+                    (static_cast<size_t>(y) * mipExtent.width + x) * 4;
+
+                pixels[offset + 0] = static_cast<char>(bLight ? color : 0);
+                pixels[offset + 1] = static_cast<char>(bLight ? color >> 8 : 0);
+                pixels[offset + 2] =
+                    static_cast<char>(bLight ? color >> 16 : 0);
+                pixels[offset + 3] = static_cast<char>(0xff);
+            }
+        }
+
+        onComplete(FileBlob(std::move(pixels)));
+    });
+}
@@ -0,0 +1,89 @@
+#include "VulkanRHI/VulkanBuffer.h"
+
+#include "VulkanRHI/VulkanCommon.h"
+#include "VulkanRHI/VulkanDevice.h"
+
+#include <cassert>
+#include <cstring>
+#include <vulkan/vulkan.hpp>
+
+FVulkanBuffer::FVulkanBuffer(FVulkanDevice* device, vk::DeviceSize size,
+                             vk::BufferUsageFlags usage,
+                             vk::MemoryPropertyFlags properties)
+    : device(device), size(size), mappedData(nullptr)
+{
+    auto vk_device = device->GetDevice();
+
+    const vk::BufferCreateInfo createInfo = {
+        .sType = vk::StructureType::eBufferCreateInfo,
+        .size = size,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive,
+    };
+
+    VERIFY_VULKAN_RESULT(vk_device.createBuffer(&createInfo, nullptr, &buffer));
+
+    const vk::MemoryRequirements requirements =
+        vk_device.getBufferMemoryRequirements(buffer);
+
+    // Buffers that are only copied from hold uploads
+    const EMemoryCategory category =
+        usage == vk::BufferUsageFlagBits::eTransferSrc
+            ? EMemoryCategory::Staging
+            : EMemoryCategory::Buffer;
+    memory = device->AllocateMemory(requirements, properties, category);
+
+    vk_device.bindBufferMemory(buffer, memory, 0);
+}
+
+FVulkanBuffer::~FVulkanBuffer()
+{
+    auto vk_device = device->GetDevice();
+
+    Unmap();
+
+    vk_device.destroyBuffer(buffer);
+    device->FreeMemory(memory);
+
+    device = VK_NULL_HANDLE;
+}
+
+void* FVulkanBuffer::Map()
+{
+    if (mappedData == nullptr) {
+        auto vk_device = device->GetDevice();
+        VERIFY_VULKAN_RESULT(
+            vk_device.mapMemory(memory, 0, VK_WHOLE_SIZE, {}, &mappedData));
+    }
+
+    return mappedData;
+}
+
+void FVulkanBuffer::Unmap()
+{
+    if (mappedData != nullptr) {
+        device->GetDevice().unmapMemory(memory);
+        mappedData = nullptr;
+    }
+}
+
+void FVulkanBuffer::Invalidate()
+{
+    const vk::MappedMemoryRange range = {
+        .sType = vk::StructureType::eMappedMemoryRange,
+        .memory = memory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    VERIFY_VULKAN_RESULT(
+        device->GetDevice().invalidateMappedMemoryRanges(1, &range));
+}
+
+void FVulkanBuffer::Upload(const void* data, vk::DeviceSize dataSize,
+                           vk::DeviceSize offset)
+{
+    assert(offset + dataSize <= size);
+
+    std::memcpy(static_cast<char*>(Map()) + offset, data, dataSize);
+}
@@ -0,0 +1,220 @@
+#include "VulkanRHI/VulkanCommandList.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+FVulkanCommandList::FVulkanCommandList(vk::CommandBuffer commandBuffer)
+    : commandBuffer(commandBuffer)
+{
+    InvalidateState();
+}
+
+void FVulkanCommandList::InvalidateState()
+{
+    bindPoints = {};
+    vertexBindings = {};
+    indexBuffer = nullptr;
+    indexOffset = 0;
+    indexType = vk::IndexType::eUint16;
+    bViewportSet = false;
+    viewport = vk::Viewport{};
+    bScissorSet = false;
+    scissor = vk::Rect2D{};
+    pushConstantLayout = nullptr;
+    pushConstantsSet = {};
+}
+
+bool FVulkanCommandList::Filter(bool bRedundant)
+{
+    if (bRedundant) {
+        stats.filtered++;
+    } else {
+        stats.issued++;
+    }
+    return bRedundant;
+}
+
+FVulkanCommandList::FBindPointState&
+FVulkanCommandList::GetBindPoint(vk::PipelineBindPoint bindPoint)
+{
+    assert(bindPoint == vk::PipelineBindPoint::eGraphics ||
+           bindPoint == vk::PipelineBindPoint::eCompute);
+    return bindPoints[bindPoint == vk::PipelineBindPoint::eCompute ? 1 : 0];
+}
+
+void FVulkanCommandList::BeginRenderPass(const vk::RenderPassBeginInfo& info,
+                                         vk::SubpassContents contents)
+{
+    stats.issued++;
+    commandBuffer.beginRenderPass(&info, contents);
+}
+
+void FVulkanCommandList::NextSubpass(vk::SubpassContents contents)
+{
+    stats.issued++;
+    commandBuffer.nextSubpass(contents);
+}
+
+void FVulkanCommandList::EndRenderPass()
+{
+    stats.issued++;
+    commandBuffer.endRenderPass();
+}
+
+void FVulkanCommandList::BindPipeline(vk::PipelineBindPoint bindPoint,
+                                      vk::Pipeline pipeline)
+{
+    FBindPointState& state = GetBindPoint(bindPoint);
+    if (Filter(state.pipeline == pipeline)) {
+        return;
+    }
+
+    state.pipeline = pipeline;
+    commandBuffer.bindPipeline(bindPoint, pipeline);
+}
+
+void FVulkanCommandList::BindDescriptorSets(
+    vk::PipelineBindPoint bindPoint, vk::PipelineLayout layout,
+    uint32_t firstSet, std::span<const vk::DescriptorSet> sets,
+    std::span<const uint32_t> dynamicOffsets)
+{
+    assert(firstSet + sets.size() <= MaxDescriptorSets);
+
+    FBindPointState& state = GetBindPoint(bindPoint);
+
+    // Sets bound with another layout may be disturbed, only the same layout
+    // is known to keep them
+    if (state.descriptorLayout != layout) {
+        state.descriptorLayout = layout;
+        state.descriptorSets = {};
+    }
+
+    const bool bRedundant =
+        dynamicOffsets.empty() &&
+        std::equal(sets.begin(), sets.end(),
+                   state.descriptorSets.begin() + firstSet);
+    if (Filter(bRedundant)) {
+        return;
+    }
+
+    for (size_t i = 0; i < sets.size(); i++) {
+        // The offsets are not tracked, such sets count as unknown
+        state.descriptorSets[firstSet + i] =
+            dynamicOffsets.empty() ? sets[i] : vk::DescriptorSet{};
+    }
+    commandBuffer.bindDescriptorSets(
+        bindPoint, layout, firstSet, static_cast<uint32_t>(sets.size()),
+        sets.data(), static_cast<uint32_t>(dynamicOffsets.size()),
+        dynamicOffsets.data());
+}
+
+void FVulkanCommandList::BindVertexBuffers(
+    uint32_t firstBinding, std::span<const vk::Buffer> buffers,
+    std::span<const vk::DeviceSize> offsets)
+{
+    assert(buffers.size() == offsets.size());
+    assert(firstBinding + buffers.size() <= MaxVertexBindings);
+
+    bool bRedundant = true;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        const FVertexBinding& binding = vertexBindings[firstBinding + i];
+        bRedundant &=
+            binding.buffer == buffers[i] && binding.offset == offsets[i];
+    }
+    if (Filter(bRedundant)) {
+        return;
+    }
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        vertexBindings[firstBinding + i] = {buffers[i], offsets[i]};
+    }
+    commandBuffer.bindVertexBuffers(firstBinding,
+                                    static_cast<uint32_t>(buffers.size()),
+                                    buffers.data(), offsets.data());
+}
+
+void FVulkanCommandList::BindIndexBuffer(vk::Buffer buffer,
+                                         vk::DeviceSize offset,
+                                         vk::IndexType type)
+{
+    if (Filter(indexBuffer == buffer && indexOffset == offset &&
+               indexType == type)) {
+        return;
+    }
+
+    indexBuffer = buffer;
+    indexOffset = offset;
+    indexType = type;
+    commandBuffer.bindIndexBuffer(buffer, offset, type);
+}
+
+void FVulkanCommandList::SetViewport(const vk::Viewport& newViewport)
+{
+    if (Filter(bViewportSet && viewport == newViewport)) {
+        return;
+    }
+
+    bViewportSet = true;
+    viewport = newViewport;
+    commandBuffer.setViewport(0, 1, &viewport);
+}
+
+void FVulkanCommandList::SetScissor(const vk::Rect2D& newScissor)
+{
+    if (Filter(bScissorSet && scissor == newScissor)) {
+        return;
+    }
+
+    bScissorSet = true;
+    scissor = newScissor;
+    commandBuffer.setScissor(0, 1, &scissor);
+}
+
+void FVulkanCommandList::PushConstants(vk::PipelineLayout layout,
+                                       vk::ShaderStageFlags stageFlags,
+                                       uint32_t offset, uint32_t size,
+                                       const void* values)
+{
+    // Ranges past the tracked bytes are always pushed
+    const bool bTracked = offset + size <= MaxPushConstantBytes;
+
+    if (pushConstantLayout != layout) {
+        pushConstantLayout = layout;
+        pushConstantsSet = {};
+    }
+
+    const bool bRedundant =
+        bTracked &&
+        std::all_of(pushConstantsSet.begin() + offset,
+                    pushConstantsSet.begin() + offset + size,
+                    [](bool bSet) { return bSet; }) &&
+        std::memcmp(pushConstants.data() + offset, values, size) == 0;
+    if (Filter(bRedundant)) {
+        return;
+    }
+
+    if (bTracked) {
+        std::memcpy(pushConstants.data() + offset, values, size);
+        std::fill(pushConstantsSet.begin() + offset,
+                  pushConstantsSet.begin() + offset + size, true);
+    }
+    commandBuffer.pushConstants(layout, stageFlags, offset, size, values);
+}
+
+void FVulkanCommandList::Draw(uint32_t vertexCount, uint32_t instanceCount,
+                              uint32_t firstVertex, uint32_t firstInstance)
+{
+    stats.issued++;
+    commandBuffer.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void FVulkanCommandList::DrawIndexed(uint32_t indexCount,
+                                     uint32_t instanceCount,
+                                     uint32_t firstIndex, int32_t vertexOffset,
+                                     uint32_t firstInstance)
+{
+    stats.issued++;
+    commandBuffer.drawIndexed(indexCount, instanceCount, firstIndex,
+                              vertexOffset, firstInstance);
+}
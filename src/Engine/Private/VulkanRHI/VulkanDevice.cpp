@@ -1,47 +1,202 @@
 #include "VulkanRHI/VulkanDevice.h"
 
+#include "Core/CommandLine.h"
 #include "Core/FileManager.h"
+#include "Core/InlineVector.h"
+#include "Core/TaskGraph.h"
+#include "Core/ThreadPool.h"
+#include "Definition.h"
 #include "VulkanRHI/QueueFamilyIndices.h"
 #include "VulkanRHI/SwapChainSupportDetails.h"
+#include "VulkanRHI/VulkanBuffer.h"
 #include "VulkanRHI/VulkanCommon.h"
 #include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanGpuTimer.h"
+#include "VulkanRHI/VulkanImage.h"
+#include "VulkanRHI/VulkanInstance.h"
+#include "VulkanRHI/VulkanMesh.h"
 #include "VulkanRHI/VulkanShader.h"
 #include "VulkanRHI/VulkanSwapChain.h"
+#include "VulkanRHI/VulkanTextureStreamer.h"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
 #include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 FVulkanDevice::FVulkanDevice(vk::Device device, FVulkanGpu* physicalDevice)
     : physicalDevice(physicalDevice), device(device),
-      swapChainDetails(physicalDevice->GetSwapChainSupportDetails())
+      memoryBudget(physicalDevice), depthAttachmentIndex(0),
+      bDepthPrepass(FCommandLine::HasParam("depthprepass") &&
+                    !FCommandLine::GetString("mesh", "").empty()),
+      renderScale(1.0f), upscaleFilter(vk::Filter::eNearest), frameIndex(0),
+      completedFrameIndex(0), instanceCount(0),
+      cullingFrustum(FFrustum::FromMatrix(FMatrix4::Identity())),
+      bVisibilityDirty(false),
+      bMeshInput(!FCommandLine::GetString("mesh", "").empty()),
+      meshLodRanges(), bMeshLodsDirty(false), lastRecordTime(0.0),
+      lastFenceWaitTime(0.0),
+      swapChainDetails(physicalDevice->GetSwapChainSupportDetails(
+          physicalDevice->GetInstance()->GetSurface()))
 {
-    InitRenderPass();
-    InitPipeline();
-
-    InitCommandPool();
-
-    InitSwapChain();
-    InitDeviceQueue();
-
-    InitFences();
+    const uint32_t requestedSamples =
+        static_cast<uint32_t>(FCommandLine::GetInt("msaa", 1));
+    sampleCount =
+        physicalDevice->GetCapabilities().GetSampleCount(requestedSamples);
+
+    if (static_cast<uint32_t>(sampleCount) != requestedSamples) {
+        std::cout << "MSAA x" << requestedSamples << " is not supported, using x"
+                  << static_cast<uint32_t>(sampleCount) << std::endl;
+    }
+
+    depthFormat = ChooseDepthFormat();
+
+    // Triangles all sit at depth 0, a prepass would not reject anything
+    if (FCommandLine::HasParam("depthprepass") && !bDepthPrepass) {
+        std::cout << "-depthprepass needs -mesh, rendering without it"
+                  << std::endl;
+    }
+
+    if (FCommandLine::HasParam("drs")) {
+        InitDynamicResolution();
+    }
+
+    // Independent startup work overlaps, the pipeline waits for the render
+    // pass and both shader modules, the swapchain framebuffers for the render
+    // pass
+    FTaskGraph graph("Device");
+
+    FileBlob vertBlob;
+    FileBlob fragBlob;
+    std::shared_ptr<FVulkanShader> vertShader;
+    std::shared_ptr<FVulkanShader> fragShader;
+
+    const std::string meshFile = FCommandLine::GetString("mesh", "");
+
+    // A mesh only swaps the vertex shader, the fragment shader is shared
+    const auto readVert = graph.AddTask("ReadVertexShader", [&]() {
+        vertBlob = FileManager::ReadFile(bMeshInput
+                                             ? "shaders/mesh.vert.spv"
+                                             : "shaders/triangle.vert.spv");
+    });
+    const auto readFrag = graph.AddTask("ReadFragmentShader", [&]() {
+        fragBlob = FileManager::ReadFile("shaders/triangle.frag.spv");
+    });
+
+    const auto vertModule = graph.AddTask(
+        "CreateVertexModule",
+        [&]() {
+            vertShader = CreateShader(vertBlob, vk::ShaderStageFlagBits::eVertex);
+        },
+        {readVert});
+    const auto fragModule = graph.AddTask(
+        "CreateFragmentModule",
+        [&]() {
+            fragShader =
+                CreateShader(fragBlob, vk::ShaderStageFlagBits::eFragment);
+        },
+        {readFrag});
+
+    const auto renderPassTask =
+        graph.AddTask("InitRenderPass", [this]() { InitRenderPass(); });
+
+    graph.AddTask(
+        "InitPipeline", [&]() { InitPipeline(vertShader, fragShader); },
+        {renderPassTask, vertModule, fragModule});
+
+    const auto commandPoolTask =
+        graph.AddTask("InitCommandPool", [this]() { InitCommandPool(); });
+    graph.AddTask("InitSwapChain", [this]() { InitSwapChain(); },
+                  {renderPassTask});
+    const auto queueTask =
+        graph.AddTask("InitDeviceQueue", [this]() { InitDeviceQueue(); });
+
+    if (bMeshInput) {
+        graph.AddTask(
+            "LoadMesh",
+            [&]() { mesh = std::make_unique<FVulkanMesh>(this, meshFile); },
+            {commandPoolTask, queueTask});
+    }
+
+    const auto fenceTask =
+        graph.AddTask("InitFences", [this]() { InitFences(); });
+    graph.AddTask("InitInstanceData", [this]() { InitInstanceData(); },
+                  {fenceTask});
+
+    graph.AddTask("InitGpuTimer", [this]() {
+        gpuTimer = std::make_unique<FVulkanGpuTimer>(this);
+    });
+
+    graph.AddTask("InitTextureStreamer", [this]() {
+        const vk::DeviceSize budgetMiB = static_cast<vk::DeviceSize>(
+            std::max<int64_t>(FCommandLine::GetInt("texturebudget", 256), 0));
+        textureStreamer = std::make_unique<FVulkanTextureStreamer>(
+            this, budgetMiB << 20,
+            static_cast<uint32_t>(FCommandLine::GetInt("texturereads", 16)));
+
+        memoryBudget.AddPressureCallback([this](uint32_t, bool) {
+            textureStreamer->SetMemoryPressure(memoryBudget.IsUnderPressure(
+                vk::MemoryHeapFlagBits::eDeviceLocal));
+        });
+    });
+
+    graph.Run(FThreadPool::Get());
+    graph.PrintReport(std::cout);
 }
 
 FVulkanDevice::~FVulkanDevice()
 {
+    // Frames still in flight use the readback buffers and texture images
+    device.waitIdle();
+
+    if (readback != nullptr) {
+        // Deliver them before the buffers go away
+        readback->Retire(frameIndex);
+        readback.reset();
+    }
+
+    textureStreamer.reset();
+
+    gpuTimer.reset();
+    instanceBuffer.reset();
+    mesh.reset();
+
     device.destroyFence(inRenderFence);
 
     device.destroyCommandPool(commandPool);
 
-    device.destroyPipeline(graphicsPipeline);
+    for (const auto& [hash, bucket] : pipelineVariants) {
+        for (const FPipelineVariant& variant : bucket) {
+            device.destroyPipeline(variant.pipeline);
+        }
+    }
+    pipelineVariants.clear();
+    graphicsPipeline = nullptr;
+
+    if (depthPrepassPipeline) {
+        device.destroyPipeline(depthPrepassPipeline);
+    }
+
     device.destroyPipelineLayout(pipelineLayout);
 
-    swapChain.reset();
+    swapChains.clear();
 
     device.destroyRenderPass(renderPass);
 
+    vertexShader.reset();
+    fragmentShader.reset();
     shaders.clear();
 
     device.destroy();
@@ -54,8 +209,16 @@ FVulkanDevice::CreateShader(const std::string& filename,
 {
     const FileBlob blob = FileManager::ReadFile(filename);
 
+    return CreateShader(blob, stage);
+}
+
+std::shared_ptr<FVulkanShader>
+FVulkanDevice::CreateShader(const FileBlob& blob, vk::ShaderStageFlagBits stage)
+{
     auto _shader = std::make_shared<FVulkanShader>(this, blob, stage, "main");
 
+    // Shader modules are created from several startup tasks at once
+    std::lock_guard<std::mutex> lock(shaderMutex);
     shaders.push_back(_shader);
 
     return _shader;
@@ -63,6 +226,8 @@ FVulkanDevice::CreateShader(const std::string& filename,
 
 void FVulkanDevice::Render(vk::CommandBuffer* commandBuffer)
 {
+    const auto recordBegin = std::chrono::steady_clock::now();
+
     const vk::CommandBufferBeginInfo beginInfo = {
         .sType = vk::StructureType::eCommandBufferBeginInfo,
         .flags = {},
@@ -70,64 +235,454 @@ void FVulkanDevice::Render(vk::CommandBuffer* commandBuffer)
 
     VERIFY_VULKAN_RESULT(commandBuffer->begin(&beginInfo))
 
+    gpuTimer->Begin(commandBuffer);
+
+    textureStreamer->Record(commandBuffer, frameIndex);
+
     const std::array defaultClearColor = {0.0f, 0.0f, 0.0f, 1.0f};
     const vk::ClearColorValue colorValue = defaultClearColor;
 
-    const std::vector<vk::ClearValue> clearColors = {
-        colorValue,
-    };
+    // Indexed by attachment, the resolve target in between is not cleared
+    const std::span<vk::ClearValue> clearColors =
+        frameAllocator.AllocateArray<vk::ClearValue>(depthAttachmentIndex + 1);
+    clearColors[0].color = colorValue;
+    clearColors[depthAttachmentIndex].depthStencil =
+        vk::ClearDepthStencilValue{.depth = 1.0f, .stencil = 0};
 
-    const vk::RenderPassBeginInfo renderPassInfo = {
-        .sType = vk::StructureType::eRenderPassBeginInfo,
-        .renderPass = renderPass,
-        .framebuffer = swapChain->GetFrameBuffer(),
-        .renderArea = {.offset = {0, 0}, .extent = swapChain->GetExtent()},
-        .clearValueCount = static_cast<uint32_t>(clearColors.size()),
-        .pClearValues = clearColors.data(),
-    };
+    renderScale = GetResolutionScale();
+
+    CullInstances();
+    UpdateMeshLods();
+    BuildDrawQueue();
+
+    // Scene state is set through the command list, which drops what the
+    // previous window already set
+    FVulkanCommandList commandList(*commandBuffer);
+
+    // Every window gets its own render pass instance, they all end up in the
+    // same submit
+    for (const std::unique_ptr<FVulkanSwapChain>& swapChain : swapChains) {
+        const vk::Extent2D outputExtent = swapChain->GetExtent();
+
+        // With dynamic resolution only the top left part of the full size
+        // scene target is rendered
+        const vk::Extent2D extent = {
+            .width = std::max(1u, static_cast<uint32_t>(
+                                      outputExtent.width * renderScale)),
+            .height = std::max(1u, static_cast<uint32_t>(
+                                       outputExtent.height * renderScale)),
+        };
+
+        const vk::RenderPassBeginInfo renderPassInfo = {
+            .sType = vk::StructureType::eRenderPassBeginInfo,
+            .renderPass = renderPass,
+            .framebuffer = swapChain->GetFrameBuffer(),
+            .renderArea = {.offset = {0, 0}, .extent = extent},
+            .clearValueCount = static_cast<uint32_t>(clearColors.size()),
+            .pClearValues = clearColors.data(),
+        };
+
+        // VK_SUBPASS_CONTENTS_INLINE render pass will be embedded in the
+        // primary command buffer
+
+        // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS render pass will be
+        // executed from secondary command buffer
+
+        commandList.BeginRenderPass(renderPassInfo,
+                                    vk::SubpassContents::eInline);
+
+        vk::Viewport outputViewport = viewport;
+        outputViewport.width = static_cast<float>(extent.width);
+        outputViewport.height = static_cast<float>(extent.height);
+
+        const vk::Rect2D outputScissor = {.offset = {0, 0}, .extent = extent};
+
+        commandList.SetViewport(outputViewport);
+        commandList.SetScissor(outputScissor);
 
-    // VK_SUBPASS_CONTENTS_INLINE render pass will be embedded in the primary
-    // command buffer
+        // The mesh vertices take binding 0, the instances follow
+        const vk::Buffer vertexBuffers[] = {instanceBuffer->GetBuffer()};
+        const vk::DeviceSize vertexOffsets[] = {0};
+        commandList.BindVertexBuffers(bMeshInput ? 1 : 0, vertexBuffers,
+                                      vertexOffsets);
 
-    // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS render pass will be
-    // executed from secondary command buffer
+        if (bMeshInput) {
+            mesh->Bind(commandList);
 
-    commandBuffer->beginRenderPass(&renderPassInfo,
-                                   vk::SubpassContents::eInline);
+            const FMeshConstants constants = mesh->GetNormalizedConstants();
+            commandList.PushConstants(pipelineLayout,
+                                      vk::ShaderStageFlagBits::eVertex, 0,
+                                      sizeof(constants), &constants);
+        }
 
-    commandBuffer->bindPipeline(vk::PipelineBindPoint::eGraphics,
-                                graphicsPipeline);
+        // DRAW!
+        RecordDraws(commandList);
 
-    commandBuffer->setViewport(0, {viewport});
-    commandBuffer->setScissor(0, {scissor});
+        commandList.EndRenderPass();
 
-    // DRAW!
-    commandBuffer->draw(3, 1, 0, 0);
+        if (IsDynamicResolutionEnabled()) {
+            UpscaleSceneTarget(commandBuffer, *swapChain, extent);
+        }
+    }
 
-    commandBuffer->endRenderPass();
+    if (readback != nullptr) {
+        readback->Record(commandBuffer, *swapChains.front(), frameIndex);
+    }
+
+    lastCommandStats = commandList.GetStats();
+
+    gpuTimer->End(commandBuffer);
 
     commandBuffer->end();
+
+    lastRecordTime = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - recordBegin)
+                         .count();
 }
 
-void FVulkanDevice::Submit(vk::CommandBuffer* commandBuffer)
+void FVulkanDevice::DrawInstanced(FVulkanCommandList& commandList,
+                                  uint32_t vertexCount,
+                                  const FInstanceRange& range)
 {
-    const std::vector<vk::Semaphore> waitSemaphores = {
-        GetSwapChain()->GetImageAvailableSemaphore(),
-    };
+    assert(range.first + range.count <= instanceCount);
+
+    if (range.count == 0) {
+        return;
+    }
+
+    commandList.Draw(vertexCount, range.count, 0, range.first);
+}
+
+uint32_t FVulkanDevice::GetDrawPipelineId(vk::Pipeline pipeline)
+{
+    const auto found =
+        std::find(drawPipelines.begin(), drawPipelines.end(), pipeline);
+    if (found != drawPipelines.end()) {
+        return static_cast<uint32_t>(found - drawPipelines.begin());
+    }
+
+    if (drawPipelines.size() >= (1u << FDrawKey::PipelineBits)) {
+        throw std::runtime_error("Too many pipelines for the draw sort key");
+    }
+    drawPipelines.push_back(pipeline);
+    return static_cast<uint32_t>(drawPipelines.size() - 1);
+}
+
+void FVulkanDevice::BuildDrawQueue()
+{
+    sceneDraws.clear();
+    drawQueue.Reset();
+
+    // The depth prepass is subpass 0 when enabled
+    const uint32_t colorPass = bDepthPrepass ? 1 : 0;
+
+    for (uint32_t pass = 0; pass <= colorPass; pass++) {
+        const vk::Pipeline pipeline =
+            pass < colorPass ? depthPrepassPipeline : graphicsPipeline;
+        const uint32_t pipelineId = GetDrawPipelineId(pipeline);
+
+        const auto addDraw = [&](uint32_t lod, const FInstanceRange& range) {
+            if (range.count == 0) {
+                return;
+            }
+            // Material and depth stay zero until the scene has materials
+            drawQueue.Add(FDrawKey::Make(pass, pipelineId, 0, 0),
+                          static_cast<uint32_t>(sceneDraws.size()));
+            sceneDraws.push_back({.lod = lod, .range = range});
+        };
+
+        if (bMeshInput) {
+            for (uint32_t lod = 0; lod < meshLodSelector->GetLodCount();
+                 lod++) {
+                addDraw(lod, meshLodRanges[lod]);
+            }
+        } else {
+            addDraw(0, {.first = 0, .count = GetVisibleInstanceCount()});
+        }
+    }
+
+    drawQueue.Sort(&FThreadPool::Get());
+}
+
+void FVulkanDevice::RecordDraws(FVulkanCommandList& commandList)
+{
+    const uint32_t lastPass = bDepthPrepass ? 1 : 0;
+
+    // The command list skips a pipeline bound by the previous window or
+    // shared by two subpasses
+    uint32_t pass = 0;
+    std::optional<uint64_t> boundState;
+
+    for (const FDrawItem& item : drawQueue.GetItems()) {
+        const uint64_t state = FDrawKey::GetState(item.key);
+
+        if (state != boundState) {
+            // Pipelines are created for one subpass
+            for (; pass < FDrawKey::GetPass(item.key); pass++) {
+                commandList.NextSubpass(vk::SubpassContents::eInline);
+            }
+
+            commandList.BindPipeline(
+                vk::PipelineBindPoint::eGraphics,
+                drawPipelines[FDrawKey::GetPipeline(item.key)]);
+            // The pipeline layout has no descriptor sets yet, so a material
+            // change has nothing to bind
+
+            boundState = state;
+        }
+
+        const FSceneDraw& draw = sceneDraws[item.draw];
+        if (bMeshInput) {
+            mesh->DrawInstanced(commandList, draw.lod, draw.range);
+        } else {
+            DrawInstanced(commandList, 3, draw.range);
+        }
+    }
+
+    for (; pass < lastPass; pass++) {
+        commandList.NextSubpass(vk::SubpassContents::eInline);
+    }
+}
 
-    const std::vector<vk::Semaphore> signalSemaphores = {
-        GetSwapChain()->GetRenderFinishedSemaphore(),
+void FVulkanDevice::CullInstances()
+{
+    if (!bVisibilityDirty) {
+        return;
+    }
+    bVisibilityDirty = false;
+
+    const size_t count = sceneInstances.size();
+    float* spheres = instanceSpheres.data();
+    const FSphereArrays arrays = {
+        .centerX = spheres,
+        .centerY = spheres + count,
+        .centerZ = spheres + count * 2,
+        .radius = spheres + count * 3,
+        .count = count,
     };
+    const std::span<const uint32_t> visible =
+        culler.CullSpheres(cullingFrustum, arrays, &FThreadPool::Get());
+
+    if (bMeshInput) {
+        bMeshLodsDirty = true;
+        return;
+    }
+
+    // BeginNextFrame waited for the previous frame, nothing reads the buffer
+    auto* packed = static_cast<FInstanceData*>(instanceBuffer->Map());
+    for (size_t i = 0; i < visible.size(); i++) {
+        packed[i] = sceneInstances[visible[i]];
+    }
+}
+
+void FVulkanDevice::UpdateMeshLods()
+{
+    if (!bMeshInput) {
+        return;
+    }
+
+    if (!meshLodSelector.has_value()) {
+        const float radius = mesh->GetBoundingRadius();
+
+        std::vector<float> errors;
+        for (const FMeshLod& lod : mesh->GetLods()) {
+            errors.push_back(radius > 0.0f ? lod.error / radius : 0.0f);
+        }
+        meshLodSelector.emplace(
+            std::move(errors),
+            static_cast<float>(FCommandLine::GetFloat("lodpixels", 1.0)));
+    }
+
+    // The tallest window needs the finest LODs
+    float viewportHeight = 0.0f;
+    for (const std::unique_ptr<FVulkanSwapChain>& swapChain : swapChains) {
+        viewportHeight = std::max(
+            viewportHeight, swapChain->GetExtent().height * renderScale);
+    }
+
+    // mesh.vert scales the unit bounding sphere by the instance scale in clip
+    // space, which spans two units over the viewport
+    const float pixelsPerUnit = viewportHeight * 0.5f;
+
+    const std::span<const uint32_t> visible = culler.GetVisible();
+
+    bool bChanged = bMeshLodsDirty;
+    for (const uint32_t i : visible) {
+        const uint8_t lod = static_cast<uint8_t>(meshLodSelector->Select(
+            sceneInstances[i].scale * pixelsPerUnit, meshInstanceLods[i]));
+        bChanged |= lod != meshInstanceLods[i];
+        meshInstanceLods[i] = lod;
+    }
+
+    if (!bChanged) {
+        return;
+    }
+    bMeshLodsDirty = false;
+
+    // Counting sort into one instance range per LOD. BeginNextFrame waited
+    // for the previous frame, nothing reads the buffer now.
+    meshLodRanges = {};
+    for (const uint32_t i : visible) {
+        meshLodRanges[meshInstanceLods[i]].count++;
+    }
+    for (size_t lod = 1; lod < meshLodRanges.size(); lod++) {
+        meshLodRanges[lod].first =
+            meshLodRanges[lod - 1].first + meshLodRanges[lod - 1].count;
+    }
+
+    std::array<uint32_t, MaxMeshLodCount> cursors;
+    for (size_t lod = 0; lod < meshLodRanges.size(); lod++) {
+        cursors[lod] = meshLodRanges[lod].first;
+    }
+
+    auto* sorted = static_cast<FInstanceData*>(instanceBuffer->Map());
+    for (const uint32_t i : visible) {
+        sorted[cursors[meshInstanceLods[i]]++] = sceneInstances[i];
+    }
+}
+
+uint64_t FVulkanDevice::GetSceneTriangleCount() const
+{
+    if (!bMeshInput) {
+        return GetVisibleInstanceCount();
+    }
+
+    uint64_t triangles = 0;
+    for (size_t lod = 0; lod < mesh->GetLods().size(); lod++) {
+        triangles += static_cast<uint64_t>(meshLodRanges[lod].count) *
+                     (mesh->GetLods()[lod].indexCount / 3);
+    }
+    return triangles;
+}
+
+void FVulkanDevice::SetInstanceData(std::span<const FInstanceData> instances)
+{
+    const vk::DeviceSize requiredSize =
+        std::max<vk::DeviceSize>(instances.size_bytes(), sizeof(FInstanceData));
+
+    if (instanceBuffer == nullptr || instanceBuffer->GetSize() < requiredSize) {
+        // The previous frame may still be reading the instance buffer
+        VERIFY_VULKAN_RESULT(device.waitForFences(
+            {inRenderFence}, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+        instanceBuffer.reset();
+        instanceBuffer = std::make_unique<FVulkanBuffer>(
+            this, std::bit_ceil(requiredSize),
+            vk::BufferUsageFlagBits::eVertexBuffer,
+            vk::MemoryPropertyFlagBits::eHostVisible |
+                vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+
+    instanceCount = static_cast<uint32_t>(instances.size());
+    sceneInstances.assign(instances.begin(), instances.end());
+
+    // Both the triangle and the mesh fit into a sphere of the instance scale
+    // around the offset, the depth sits in the middle of the clip volume
+    const size_t count = instances.size();
+    instanceSpheres.resize(count * 4);
+    for (size_t i = 0; i < count; i++) {
+        instanceSpheres[i] = instances[i].offset[0];
+        instanceSpheres[count + i] = instances[i].offset[1];
+        instanceSpheres[count * 2 + i] = 0.5f;
+        instanceSpheres[count * 3 + i] = instances[i].scale;
+    }
+    bVisibilityDirty = true;
+
+    if (bMeshInput) {
+        meshInstanceLods.assign(instances.size(), 0);
+    }
+}
+
+void FVulkanDevice::SetCullingFrustum(const FFrustum& frustum)
+{
+    cullingFrustum = frustum;
+    bVisibilityDirty = true;
+}
+
+uint32_t FVulkanDevice::FindMemoryType(uint32_t typeBits,
+                                       vk::MemoryPropertyFlags properties) const
+{
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties =
+        physicalDevice->GetMemoryProperties();
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find a suitable memory type");
+}
 
-    constexpr vk::PipelineStageFlags pipelineFlags = {
-        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+bool FVulkanDevice::HasMemoryType(uint32_t typeBits,
+                                  vk::MemoryPropertyFlags properties) const
+{
+    const vk::PhysicalDeviceMemoryProperties& memoryProperties =
+        physicalDevice->GetMemoryProperties();
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+vk::DeviceMemory
+FVulkanDevice::AllocateMemory(const vk::MemoryRequirements& requirements,
+                              vk::MemoryPropertyFlags properties,
+                              EMemoryCategory category)
+{
+    const vk::MemoryAllocateInfo allocInfo = {
+        .sType = vk::StructureType::eMemoryAllocateInfo,
+        .allocationSize = requirements.size,
+        .memoryTypeIndex =
+            FindMemoryType(requirements.memoryTypeBits, properties),
     };
 
+    vk::DeviceMemory memory;
+    VERIFY_VULKAN_RESULT(device.allocateMemory(&allocInfo, nullptr, &memory));
+
+    memoryBudget.OnAllocate(memory, allocInfo.memoryTypeIndex,
+                            allocInfo.allocationSize, category);
+
+    return memory;
+}
+
+void FVulkanDevice::FreeMemory(vk::DeviceMemory memory)
+{
+    memoryBudget.OnFree(memory);
+    device.freeMemory(memory);
+}
+
+void FVulkanDevice::Submit(vk::CommandBuffer* commandBuffer)
+{
+    TInlineVector<vk::Semaphore, 4> waitSemaphores;
+    TInlineVector<vk::PipelineStageFlags, 4> waitStages;
+    TInlineVector<vk::Semaphore, 4> signalSemaphores;
+
+    for (const std::unique_ptr<FVulkanSwapChain>& swapChain : swapChains) {
+        waitSemaphores.push_back(swapChain->GetImageAvailableSemaphore());
+        // The upscale blit writes the swapchain image from the transfer stage
+        waitStages.push_back(
+            IsDynamicResolutionEnabled()
+                ? vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                      vk::PipelineStageFlagBits::eTransfer
+                : vk::PipelineStageFlags(
+                      vk::PipelineStageFlagBits::eColorAttachmentOutput));
+        signalSemaphores.push_back(swapChain->GetRenderFinishedSemaphore());
+    }
+
     const vk::SubmitInfo submitInfo = {
         .sType = vk::StructureType::eSubmitInfo,
         .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
         .pWaitSemaphores = waitSemaphores.data(),
-        .pWaitDstStageMask = &pipelineFlags,
+        .pWaitDstStageMask = waitStages.data(),
         .commandBufferCount = 1,
         .pCommandBuffers = commandBuffer,
         .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
@@ -139,28 +694,182 @@ void FVulkanDevice::Submit(vk::CommandBuffer* commandBuffer)
     graphicsQueue->submit({submitInfo}, inRenderFence);
 }
 
+void FVulkanDevice::Present()
+{
+    TInlineVector<vk::Semaphore, 4> waitSemaphores;
+    TInlineVector<vk::SwapchainKHR, 4> presentSwapChains;
+    TInlineVector<uint32_t, 4> imageIndices;
+
+    for (const std::unique_ptr<FVulkanSwapChain>& swapChain : swapChains) {
+        assert(swapChain->GetCurrentImage() !=
+               static_cast<uint32_t>(INDEX_NONE));
+
+        waitSemaphores.push_back(swapChain->GetRenderFinishedSemaphore());
+        presentSwapChains.push_back(swapChain->GetHandle());
+        imageIndices.push_back(swapChain->GetCurrentImage());
+    }
+
+    TInlineVector<vk::Result, 4> results;
+    results.resize(presentSwapChains.size());
+
+    const vk::PresentInfoKHR presentInfo = {
+        .sType = vk::StructureType::ePresentInfoKHR,
+        .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
+        .pWaitSemaphores = waitSemaphores.data(),
+        .swapchainCount = static_cast<uint32_t>(presentSwapChains.size()),
+        .pSwapchains = presentSwapChains.data(),
+        .pImageIndices = imageIndices.data(),
+        .pResults = results.data(),
+    };
+
+    // The overall result only reports the worst swapchain, the individual
+    // results tell which windows need to be recreated
+    const vk::Result presentResult = presentQueue.presentKHR(&presentInfo);
+
+    switch (presentResult) {
+    case vk::Result::eSuccess:
+    case vk::Result::eSuboptimalKHR:
+    case vk::Result::eErrorOutOfDateKHR:
+        break;
+    default:
+        VERIFY_VULKAN_RESULT(presentResult);
+    }
+
+    for (size_t i = 0; i < swapChains.size(); i++) {
+        swapChains[i]->OnPresentResult(results[i]);
+    }
+}
+
+FVulkanFrameReadback*
+FVulkanDevice::EnableReadback(uint32_t slotCount,
+                              FVulkanFrameReadback::FConsumer consumer,
+                              EReadbackFormat format)
+{
+    readback = std::make_unique<FVulkanFrameReadback>(
+        this, slotCount, std::move(consumer), format);
+    return readback.get();
+}
+
+vk::Format FVulkanDevice::GetSurfaceFormat() const
+{
+    return swapChainDetails.GetRequiredSurfaceFormat().format;
+}
+
 void FVulkanDevice::InitSwapChain()
 {
-    swapChain = std::make_unique<FVulkanSwapChain>(this);
+    const std::vector<vk::SurfaceKHR>& surfaces =
+        physicalDevice->GetInstance()->GetSurfaces();
+
+    for (vk::SurfaceKHR surface : surfaces) {
+        if (!physicalDevice->SupportsSurface(surface)) {
+            throw std::runtime_error(
+                "Selected GPU cannot present to every window");
+        }
+
+        swapChains.push_back(std::make_unique<FVulkanSwapChain>(this, surface));
+    }
 }
 
 void FVulkanDevice::InitDeviceQueue()
 {
-    const auto indices = physicalDevice->GetQueueFamilies();
+    const FQueueFamilyIndices& indices = physicalDevice->GetQueueFamilies();
 
     graphicsQueue = device.getQueue(indices.graphicsFamily.value(), 0);
     presentQueue = device.getQueue(indices.presentFamily.value(), 0);
 }
 
-void FVulkanDevice::InitPipeline()
+void FVulkanDevice::InitPipeline(std::shared_ptr<FVulkanShader> vertShader,
+                                 std::shared_ptr<FVulkanShader> fragShader)
+{
+    vertexShader = vertShader;
+    fragmentShader = fragShader;
+
+    // Must match the constant_id layout qualifiers in triangle.frag
+    fragmentShader->DeclareConstant("bGrayscale", 0);
+
+    // TODO: Improve API
+    const vk::Extent2D extent = swapChainDetails.GetRequiredExtent(nullptr);
+
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    scissor.offset.x = 0.0f;
+    scissor.offset.y = 0.0f;
+    scissor.extent = extent;
+
+    // Only mesh.vert has push constants
+    const vk::PushConstantRange meshConstants = {
+        .stageFlags = vk::ShaderStageFlagBits::eVertex,
+        .offset = 0,
+        .size = sizeof(FMeshConstants),
+    };
+
+    const vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {
+        .sType = vk::StructureType::ePipelineLayoutCreateInfo,
+        .setLayoutCount = 0,
+        .pSetLayouts = nullptr,
+        .pushConstantRangeCount = bMeshInput ? 1u : 0u,
+        .pPushConstantRanges = &meshConstants,
+    };
+
+    VERIFY_VULKAN_RESULT(device.createPipelineLayout(&pipelineLayoutInfo,
+                                                     nullptr, &pipelineLayout));
+
+    FVulkanSpecialization fragmentSpecialization;
+    fragmentShader->Specialize(fragmentSpecialization, "bGrayscale",
+                               FCommandLine::HasParam("grayscale"));
+
+    graphicsPipeline =
+        GetPipelineVariant(FVulkanSpecialization(), fragmentSpecialization);
+
+    if (bDepthPrepass) {
+        depthPrepassPipeline = CreateGraphicsPipeline(
+            FVulkanSpecialization(), FVulkanSpecialization(), true);
+    }
+}
+
+vk::Pipeline FVulkanDevice::GetPipelineVariant(
+    const FVulkanSpecialization& vertexSpecialization,
+    const FVulkanSpecialization& fragmentSpecialization)
 {
-    auto VertShader = CreateShader("shaders/triangle.vert.spv",
-                                   vk::ShaderStageFlagBits::eVertex);
-    auto FragShader = CreateShader("shaders/triangle.frag.spv",
-                                   vk::ShaderStageFlagBits::eFragment);
+    const size_t hash =
+        vertexSpecialization.GetHash() ^
+        (fragmentSpecialization.GetHash() * 0x9e3779b97f4a7c15ull);
+
+    std::lock_guard<std::mutex> lock(pipelineVariantMutex);
+
+    // Buckets hold every variant sharing a hash, compared by value
+    auto& bucket = pipelineVariants[hash];
+    for (const FPipelineVariant& variant : bucket) {
+        if (variant.vertexSpecialization == vertexSpecialization &&
+            variant.fragmentSpecialization == fragmentSpecialization) {
+            return variant.pipeline;
+        }
+    }
+
+    const vk::Pipeline pipeline =
+        CreateGraphicsPipeline(vertexSpecialization, fragmentSpecialization);
+
+    bucket.push_back({
+        .vertexSpecialization = vertexSpecialization,
+        .fragmentSpecialization = fragmentSpecialization,
+        .pipeline = pipeline,
+    });
+
+    return pipeline;
+}
 
+vk::Pipeline FVulkanDevice::CreateGraphicsPipeline(
+    const FVulkanSpecialization& vertexSpecialization,
+    const FVulkanSpecialization& fragmentSpecialization, bool bDepthOnly)
+{
     const vk::PipelineShaderStageCreateInfo shaderStages[] = {
-        VertShader->CreatePipelineStage(), FragShader->CreatePipelineStage()};
+        vertexShader->CreatePipelineStage(&vertexSpecialization),
+        fragmentShader->CreatePipelineStage(&fragmentSpecialization)};
 
     // Dynamic state
     const std::vector<vk::DynamicState> dynamicStates = {
@@ -172,13 +881,70 @@ void FVulkanDevice::InitPipeline()
         .pDynamicStates = dynamicStates.data(),
     };
 
-    // Vertex input
+    // Vertex input, the triangle's vertices are generated in the shader and
+    // its only stream is the per-instance data. A mesh streams FMeshVertex
+    // from binding 0 and moves the instances to binding 1.
+    const vk::VertexInputBindingDescription meshBindings[] = {
+        {
+            .binding = 0,
+            .stride = sizeof(FMeshVertex),
+            .inputRate = vk::VertexInputRate::eVertex,
+        },
+        {
+            .binding = 1,
+            .stride = sizeof(FInstanceData),
+            .inputRate = vk::VertexInputRate::eInstance,
+        },
+    };
+
+    const vk::VertexInputAttributeDescription meshAttributes[] = {
+        {
+            .location = 0,
+            .binding = 0,
+            .format = vk::Format::eR16G16B16A16Unorm,
+            .offset = offsetof(FMeshVertex, position),
+        },
+        {
+            .location = 1,
+            .binding = 0,
+            .format = vk::Format::eR16G16Snorm,
+            .offset = offsetof(FMeshVertex, normal),
+        },
+        {
+            .location = 2,
+            .binding = 0,
+            .format = vk::Format::eR16G16Sfloat,
+            .offset = offsetof(FMeshVertex, uv),
+        },
+        {
+            .location = 3,
+            .binding = 1,
+            .format = vk::Format::eR32G32B32A32Sfloat,
+            .offset = 0,
+        },
+    };
+
+    const vk::VertexInputBindingDescription instanceBinding = {
+        .binding = 0,
+        .stride = sizeof(FInstanceData),
+        .inputRate = vk::VertexInputRate::eInstance,
+    };
+
+    const vk::VertexInputAttributeDescription instanceAttribute = {
+        .location = 0,
+        .binding = 0,
+        .format = vk::Format::eR32G32B32A32Sfloat,
+        .offset = 0,
+    };
+
     const vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {
         .sType = vk::StructureType::ePipelineVertexInputStateCreateInfo,
-        .vertexBindingDescriptionCount = 0,
-        .pVertexBindingDescriptions = nullptr,
-        .vertexAttributeDescriptionCount = 0,
-        .pVertexAttributeDescriptions = nullptr,
+        .vertexBindingDescriptionCount = bMeshInput ? 2u : 1u,
+        .pVertexBindingDescriptions =
+            bMeshInput ? meshBindings : &instanceBinding,
+        .vertexAttributeDescriptionCount = bMeshInput ? 4u : 1u,
+        .pVertexAttributeDescriptions =
+            bMeshInput ? meshAttributes : &instanceAttribute,
     };
 
     // Input assembly
@@ -188,20 +954,6 @@ void FVulkanDevice::InitPipeline()
         .primitiveRestartEnable = VK_FALSE,
     };
 
-    // TODO: Improve API
-    const vk::Extent2D extent = swapChainDetails.GetRequiredExtent(nullptr);
-
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    scissor.offset.x = 0.0f;
-    scissor.offset.y = 0.0f;
-    scissor.extent = extent;
-
     const vk::PipelineViewportStateCreateInfo viewportState = {
         .sType = vk::StructureType::ePipelineViewportStateCreateInfo,
         .viewportCount = 1,
@@ -217,7 +969,9 @@ void FVulkanDevice::InitPipeline()
         .rasterizerDiscardEnable = VK_FALSE,
         .polygonMode = vk::PolygonMode::eFill,
         .cullMode = vk::CullModeFlagBits::eBack,
-        .frontFace = vk::FrontFace::eClockwise,
+        // Cooked meshes keep the counter clockwise winding of OBJ and glTF
+        .frontFace = bMeshInput ? vk::FrontFace::eCounterClockwise
+                                : vk::FrontFace::eClockwise,
         .depthBiasEnable = VK_FALSE,
         .depthBiasConstantFactor = 0.0f,
         .depthBiasClamp = 0.0f,
@@ -228,7 +982,7 @@ void FVulkanDevice::InitPipeline()
     // Multisampling (required GPU feature)
     const vk::PipelineMultisampleStateCreateInfo multisamplingInfo = {
         .sType = vk::StructureType::ePipelineMultisampleStateCreateInfo,
-        .rasterizationSamples = vk::SampleCountFlagBits::e1,
+        .rasterizationSamples = sampleCount,
         .sampleShadingEnable = VK_FALSE,
         .minSampleShading = 1.0f,
         .pSampleMask = nullptr,
@@ -236,8 +990,21 @@ void FVulkanDevice::InitPipeline()
         .alphaToOneEnable = VK_FALSE,
     };
 
-    // Depth and stencil testing
-    // TODO
+    // Depth and stencil testing. After a prepass depth is final, the color
+    // pass only shades fragments matching it and early-Z rejects the rest
+    const bool bTestEqual = bDepthPrepass && !bDepthOnly;
+
+    const vk::PipelineDepthStencilStateCreateInfo depthStencil = {
+        .sType = vk::StructureType::ePipelineDepthStencilStateCreateInfo,
+        .depthTestEnable = VK_TRUE,
+        .depthWriteEnable = bTestEqual ? VK_FALSE : VK_TRUE,
+        .depthCompareOp = bTestEqual ? vk::CompareOp::eEqual
+                                     : vk::CompareOp::eLessOrEqual,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable = VK_FALSE,
+        .minDepthBounds = 0.0f,
+        .maxDepthBounds = 1.0f,
+    };
 
     // Color blending
     const vk::PipelineColorBlendAttachmentState colorBlendAttachment = {
@@ -259,37 +1026,26 @@ void FVulkanDevice::InitPipeline()
         .sType = vk::StructureType::ePipelineColorBlendStateCreateInfo,
         .logicOpEnable = VK_FALSE,
         .logicOp = vk::LogicOp::eCopy,
-        .attachmentCount = 1,
+        .attachmentCount = bDepthOnly ? 0u : 1u,
         .pAttachments = &colorBlendAttachment,
         .blendConstants = defaultBlendConstants,
     };
 
-    const vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {
-        .sType = vk::StructureType::ePipelineLayoutCreateInfo,
-        .setLayoutCount = 0,
-        .pSetLayouts = nullptr,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = nullptr,
-    };
-
-    VERIFY_VULKAN_RESULT(device.createPipelineLayout(&pipelineLayoutInfo,
-                                                     nullptr, &pipelineLayout));
-
     const vk::GraphicsPipelineCreateInfo pipelineInfo = {
         .sType = vk::StructureType::eGraphicsPipelineCreateInfo,
-        .stageCount = 2,
+        .stageCount = bDepthOnly ? 1u : 2u,
         .pStages = shaderStages,
         .pVertexInputState = &vertexInputInfo,
         .pInputAssemblyState = &inputAssemblyInfo,
         .pViewportState = &viewportState,
         .pRasterizationState = &rasterizer,
         .pMultisampleState = &multisamplingInfo,
-        .pDepthStencilState = nullptr,
+        .pDepthStencilState = &depthStencil,
         .pColorBlendState = &colorBlending,
         .pDynamicState = &dynamicStateInfo,
         .layout = pipelineLayout,
         .renderPass = renderPass,
-        .subpass = 0,
+        .subpass = bDepthPrepass && !bDepthOnly ? 1u : 0u,
         .basePipelineHandle = nullptr,
         .basePipelineIndex = 0,
     };
@@ -298,22 +1054,209 @@ void FVulkanDevice::InitPipeline()
         device.createGraphicsPipelines(nullptr, {pipelineInfo}, nullptr));
 
     assert(pipelines.size() == 1);
-    graphicsPipeline = pipelines[0];
+    return pipelines[0];
+}
+
+vk::Format FVulkanDevice::ChooseDepthFormat() const
+{
+    std::vector<vk::Format> candidates = {
+        vk::Format::eD32Sfloat,
+        vk::Format::eD24UnormS8Uint,
+        vk::Format::eD32SfloatS8Uint,
+        vk::Format::eD16Unorm,
+    };
+
+    const std::string requestedName = FCommandLine::GetString("depthformat", "");
+    if (!requestedName.empty()) {
+        vk::Format requested;
+        if (requestedName == "d32") {
+            requested = vk::Format::eD32Sfloat;
+        } else if (requestedName == "d24s8") {
+            requested = vk::Format::eD24UnormS8Uint;
+        } else if (requestedName == "d32s8") {
+            requested = vk::Format::eD32SfloatS8Uint;
+        } else if (requestedName == "d16") {
+            requested = vk::Format::eD16Unorm;
+        } else {
+            throw std::runtime_error("Unknown depth format " + requestedName);
+        }
+        candidates.insert(candidates.begin(), requested);
+    }
+
+    const std::optional<vk::Format> format =
+        physicalDevice->FindDepthFormat(candidates);
+    if (!format.has_value()) {
+        throw std::runtime_error("No supported depth format");
+    }
+
+    if (!requestedName.empty() && *format != candidates.front()) {
+        std::cout << "Depth format " << requestedName
+                  << " is not supported, using " << vk::to_string(*format)
+                  << std::endl;
+    }
+
+    return *format;
+}
+
+void FVulkanDevice::InitDynamicResolution()
+{
+    const vk::Format format =
+        swapChainDetails.GetRequiredSurfaceFormat().format;
+    const vk::FormatFeatureFlags features =
+        physicalDevice->GetFormatProperties(format).optimalTilingFeatures;
+
+    const bool bCanBlit =
+        (features & vk::FormatFeatureFlagBits::eBlitSrc) &&
+        (features & vk::FormatFeatureFlagBits::eBlitDst) &&
+        (swapChainDetails.capabilities.supportedUsageFlags &
+         vk::ImageUsageFlagBits::eTransferDst);
+
+    if (!bCanBlit) {
+        std::cout << "Dynamic resolution needs blits to the swap chain, "
+                     "disabled"
+                  << std::endl;
+        return;
+    }
+
+    upscaleFilter =
+        (features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)
+            ? vk::Filter::eLinear
+            : vk::Filter::eNearest;
+
+    dynamicResolution.emplace(
+        FCommandLine::GetFloat("drsbudget", 1000.0 / 60.0),
+        static_cast<float>(FCommandLine::GetFloat("drsmin", 0.5)),
+        static_cast<float>(
+            std::min(FCommandLine::GetFloat("drsmax", 1.0), 1.0)));
+}
+
+void FVulkanDevice::UpscaleSceneTarget(vk::CommandBuffer* commandBuffer,
+                                       const FVulkanSwapChain& swapChain,
+                                       vk::Extent2D renderExtent)
+{
+    const vk::Extent2D outputExtent = swapChain.GetExtent();
+
+    const vk::ImageSubresourceRange colorRange = {
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+
+    // The previous contents are fully overwritten
+    const vk::ImageMemoryBarrier toTransfer = {
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = {},
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapChain.GetImage(),
+        .subresourceRange = colorRange,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eTransfer, {},
+                                   {}, {}, {toTransfer});
+
+    const vk::ImageSubresourceLayers colorLayers = {
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .mipLevel = 0,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+
+    const vk::ImageBlit region = {
+        .srcSubresource = colorLayers,
+        .srcOffsets = std::array<vk::Offset3D, 2>{
+            vk::Offset3D{0, 0, 0},
+            vk::Offset3D{static_cast<int32_t>(renderExtent.width),
+                         static_cast<int32_t>(renderExtent.height), 1}},
+        .dstSubresource = colorLayers,
+        .dstOffsets = std::array<vk::Offset3D, 2>{
+            vk::Offset3D{0, 0, 0},
+            vk::Offset3D{static_cast<int32_t>(outputExtent.width),
+                         static_cast<int32_t>(outputExtent.height), 1}},
+    };
+
+    commandBuffer->blitImage(swapChain.GetSceneTarget()->GetImage(),
+                             vk::ImageLayout::eTransferSrcOptimal,
+                             swapChain.GetImage(),
+                             vk::ImageLayout::eTransferDstOptimal, {region},
+                             upscaleFilter);
+
+    const vk::ImageMemoryBarrier toPresent = {
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = {},
+        .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+        .newLayout = vk::ImageLayout::ePresentSrcKHR,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapChain.GetImage(),
+        .subresourceRange = colorRange,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eBottomOfPipe,
+                                   {}, {}, {}, {toPresent});
 }
 
 void FVulkanDevice::InitRenderPass()
 {
-    // Attachment description
-    const vk::AttachmentDescription colorAttachment = {
+    const bool bMultisampled = sampleCount != vk::SampleCountFlagBits::e1;
+
+    // The scene target is blitted to the swapchain image after the pass
+    const vk::ImageLayout outputLayout =
+        IsDynamicResolutionEnabled() ? vk::ImageLayout::eTransferSrcOptimal
+                                     : vk::ImageLayout::ePresentSrcKHR;
+
+    TInlineVector<vk::AttachmentDescription, 4> attachments;
+
+    // Attachment description, with MSAA the multisampled target is only
+    // needed during the pass and is never stored
+    attachments.push_back({
         .format = swapChainDetails.GetRequiredSurfaceFormat().format,
-        .samples = vk::SampleCountFlagBits::e1,
+        .samples = sampleCount,
         .loadOp = vk::AttachmentLoadOp::eClear,
-        .storeOp = vk::AttachmentStoreOp::eStore,
+        .storeOp = bMultisampled ? vk::AttachmentStoreOp::eDontCare
+                                 : vk::AttachmentStoreOp::eStore,
         .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
         .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
         .initialLayout = vk::ImageLayout::eUndefined,
-        .finalLayout = vk::ImageLayout::ePresentSrcKHR,
-    };
+        .finalLayout = bMultisampled ? vk::ImageLayout::eColorAttachmentOptimal
+                                     : outputLayout,
+    });
+
+    // The swapchain image receives the resolve at the end of the subpass
+    if (bMultisampled) {
+        attachments.push_back({
+            .format = swapChainDetails.GetRequiredSurfaceFormat().format,
+            .samples = vk::SampleCountFlagBits::e1,
+            .loadOp = vk::AttachmentLoadOp::eDontCare,
+            .storeOp = vk::AttachmentStoreOp::eStore,
+            .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
+            .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
+            .initialLayout = vk::ImageLayout::eUndefined,
+            .finalLayout = outputLayout,
+        });
+    }
+
+    // Depth is only needed while the pass runs, so like the MSAA target it
+    // is transient and never stored
+    depthAttachmentIndex = static_cast<uint32_t>(attachments.size());
+    attachments.push_back({
+        .format = depthFormat,
+        .samples = sampleCount,
+        .loadOp = vk::AttachmentLoadOp::eClear,
+        .storeOp = vk::AttachmentStoreOp::eDontCare,
+        .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
+        .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
+        .initialLayout = vk::ImageLayout::eUndefined,
+        .finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
+    });
 
     // Attachment reference
     const vk::AttachmentReference colorAttachmentRef = {
@@ -321,32 +1264,92 @@ void FVulkanDevice::InitRenderPass()
         .layout = vk::ImageLayout::eColorAttachmentOptimal,
     };
 
-    // Subpass description
-    const vk::SubpassDescription subpass = {
+    const vk::AttachmentReference resolveAttachmentRef = {
+        .attachment = 1,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+    };
+
+    const vk::AttachmentReference depthAttachmentRef = {
+        .attachment = depthAttachmentIndex,
+        .layout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
+    };
+
+    // Subpass description, the optional prepass only writes depth
+    TInlineVector<vk::SubpassDescription, 2> subpasses;
+
+    if (bDepthPrepass) {
+        subpasses.push_back({
+            .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+            .colorAttachmentCount = 0,
+            .pDepthStencilAttachment = &depthAttachmentRef,
+        });
+    }
+
+    subpasses.push_back({
         .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
         .colorAttachmentCount = 1,
         .pColorAttachments = &colorAttachmentRef,
-    };
+        .pResolveAttachments = bMultisampled ? &resolveAttachmentRef : nullptr,
+        .pDepthStencilAttachment = &depthAttachmentRef,
+    });
+
+    const uint32_t colorSubpass = static_cast<uint32_t>(subpasses.size()) - 1;
 
     // Subpass dependency
-    const vk::SubpassDependency dependency = {
+    TInlineVector<vk::SubpassDependency, 4> dependencies;
+
+    dependencies.push_back({
         .srcSubpass = VK_SUBPASS_EXTERNAL,
-        .dstSubpass = 0,
+        .dstSubpass = colorSubpass,
         .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
         .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
         .srcAccessMask = vk::AccessFlagBits::eNoneKHR,
         .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
-    };
+    });
+
+    // The previous frame's depth tests are done before the clear
+    dependencies.push_back({
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = vk::PipelineStageFlagBits::eLateFragmentTests,
+        .dstStageMask = vk::PipelineStageFlagBits::eEarlyFragmentTests,
+        .srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+        .dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead |
+                         vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+    });
+
+    if (bDepthPrepass) {
+        dependencies.push_back({
+            .srcSubpass = 0,
+            .dstSubpass = colorSubpass,
+            .srcStageMask = vk::PipelineStageFlagBits::eLateFragmentTests,
+            .dstStageMask = vk::PipelineStageFlagBits::eEarlyFragmentTests,
+            .srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+            .dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead,
+            .dependencyFlags = vk::DependencyFlagBits::eByRegion,
+        });
+    }
+
+    if (IsDynamicResolutionEnabled()) {
+        dependencies.push_back({
+            .srcSubpass = colorSubpass,
+            .dstSubpass = VK_SUBPASS_EXTERNAL,
+            .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            .dstStageMask = vk::PipelineStageFlagBits::eTransfer,
+            .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+        });
+    }
 
     // Render pass
     const vk::RenderPassCreateInfo renderPassInfo = {
         .sType = vk::StructureType::eRenderPassCreateInfo,
-        .attachmentCount = 1,
-        .pAttachments = &colorAttachment,
-        .subpassCount = 1,
-        .pSubpasses = &subpass,
-        .dependencyCount = 1,
-        .pDependencies = &dependency,
+        .attachmentCount = static_cast<uint32_t>(attachments.size()),
+        .pAttachments = attachments.data(),
+        .subpassCount = static_cast<uint32_t>(subpasses.size()),
+        .pSubpasses = subpasses.data(),
+        .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+        .pDependencies = dependencies.data(),
     };
 
     VERIFY_VULKAN_RESULT(
@@ -355,7 +1358,7 @@ void FVulkanDevice::InitRenderPass()
 
 void FVulkanDevice::InitCommandPool()
 {
-    const auto indices = physicalDevice->GetQueueFamilies();
+    const FQueueFamilyIndices& indices = physicalDevice->GetQueueFamilies();
 
     const vk::CommandPoolCreateInfo commandPoolInfo = {
         .sType = vk::StructureType::eCommandPoolCreateInfo,
@@ -369,12 +1372,42 @@ void FVulkanDevice::InitCommandPool()
 
 void FVulkanDevice::BeginNextFrame()
 {
+    const auto waitBegin = std::chrono::steady_clock::now();
     VERIFY_VULKAN_RESULT(device.waitForFences(
         {inRenderFence}, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+    lastFenceWaitTime = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - waitBegin)
+                            .count();
 
     device.resetFences({inRenderFence});
 
-    GetSwapChain()->AcquireNextImage();
+    // Only one frame is in flight, everything submitted so far is done
+    completedFrameIndex = frameIndex;
+    frameIndex++;
+
+    if (readback != nullptr) {
+        readback->Retire(completedFrameIndex);
+    }
+
+    // Pressure callbacks run before the streamer picks new mips
+    memoryBudget.Update(frameIndex);
+
+    textureStreamer->Retire(completedFrameIndex);
+
+    // Everything allocated for the previous frame has been consumed
+    frameAllocator.Reset();
+
+    if (const auto gpuTime = gpuTimer->Resolve()) {
+        lastGpuTime = gpuTime;
+
+        if (dynamicResolution.has_value()) {
+            dynamicResolution->Update(*gpuTime, renderScale);
+        }
+    }
+
+    for (const std::unique_ptr<FVulkanSwapChain>& swapChain : swapChains) {
+        swapChain->AcquireNextImage();
+    }
 }
 
 vk::CommandBuffer FVulkanDevice::CreateCommandBuffer()
@@ -400,6 +1433,39 @@ vk::CommandBuffer FVulkanDevice::CreateCommandBuffer()
     return commandBuffers[0];
 }
 
+void FVulkanDevice::SubmitImmediate(
+    const std::function<void(vk::CommandBuffer*)>& record)
+{
+    vk::CommandBuffer commandBuffer = CreateCommandBuffer();
+
+    const vk::CommandBufferBeginInfo beginInfo = {
+        .sType = vk::StructureType::eCommandBufferBeginInfo,
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        .pInheritanceInfo = nullptr};
+
+    VERIFY_VULKAN_RESULT(commandBuffer.begin(&beginInfo));
+    record(&commandBuffer);
+    commandBuffer.end();
+
+    const vk::FenceCreateInfo fenceInfo = {
+        .sType = vk::StructureType::eFenceCreateInfo,
+    };
+    const vk::Fence fence = device.createFence({fenceInfo});
+
+    const vk::SubmitInfo submitInfo = {
+        .sType = vk::StructureType::eSubmitInfo,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &commandBuffer,
+    };
+
+    graphicsQueue.submit({submitInfo}, fence);
+    VERIFY_VULKAN_RESULT(device.waitForFences(
+        {fence}, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+    device.destroyFence(fence);
+    device.freeCommandBuffers(commandPool, {commandBuffer});
+}
+
 void FVulkanDevice::InitFences()
 {
     const vk::FenceCreateInfo fenceInfo = {
@@ -410,3 +1476,15 @@ void FVulkanDevice::InitFences()
 
     inRenderFence = device.createFence({fenceInfo});
 }
+
+void FVulkanDevice::InitInstanceData()
+{
+    // A single untransformed instance keeps the default triangle visible
+    const FInstanceData defaultInstance = {
+        .offset = {0.0f, 0.0f},
+        .scale = 1.0f,
+        .padding = 0.0f,
+    };
+
+    SetInstanceData({&defaultInstance, 1});
+}
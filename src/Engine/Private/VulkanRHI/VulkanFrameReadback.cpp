@@ -0,0 +1,655 @@
+#include "VulkanRHI/VulkanFrameReadback.h"
+
+#include "Core/ImageWriter.h"
+#include "Core/VideoStreamWriter.h"
+#include "VulkanRHI/VulkanBuffer.h"
+#include "VulkanRHI/VulkanCommon.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanShader.h"
+#include "VulkanRHI/VulkanSpecialization.h"
+#include "VulkanRHI/VulkanSwapChain.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace
+{
+
+bool IsBGRA8(vk::Format format)
+{
+    return format == vk::Format::eB8G8R8A8Srgb ||
+           format == vk::Format::eB8G8R8A8Unorm;
+}
+
+bool IsRGBA8(vk::Format format)
+{
+    return format == vk::Format::eR8G8B8A8Srgb ||
+           format == vk::Format::eR8G8B8A8Unorm;
+}
+
+// CPU reads from uncached memory are very slow, prefer cached memory and
+// invalidate it before reading
+vk::MemoryPropertyFlags
+ChooseReadbackMemory(const vk::PhysicalDeviceMemoryProperties& properties)
+{
+    const vk::MemoryPropertyFlags cached =
+        vk::MemoryPropertyFlagBits::eHostVisible |
+        vk::MemoryPropertyFlagBits::eHostCached;
+
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+        if ((properties.memoryTypes[i].propertyFlags & cached) == cached) {
+            return cached;
+        }
+    }
+
+    return vk::MemoryPropertyFlagBits::eHostVisible |
+           vk::MemoryPropertyFlagBits::eHostCoherent;
+}
+
+} // namespace
+
+FVulkanFrameReadback::FVulkanFrameReadback(FVulkanDevice* device,
+                                           uint32_t slotCount,
+                                           FConsumer consumer,
+                                           EReadbackFormat readbackFormat)
+    : device(device), consumer(std::move(consumer)),
+      readbackFormat(readbackFormat),
+      startTime(std::chrono::steady_clock::now()),
+      slots(std::max(slotCount, 1u)), nextSlot(0), bStopping(false),
+      capturedCount(0), droppedCount(0)
+{
+    // Only the first window is captured
+    if (!device->GetSwapChain()->SupportsReadback()) {
+        throw std::runtime_error(
+            "Swap chain images do not support transfer source usage");
+    }
+
+    const vk::Format format = device->GetSurfaceFormat();
+    if (!IsBGRA8(format) && !IsRGBA8(format)) {
+        throw std::runtime_error("Unsupported readback format " +
+                                 vk::to_string(format));
+    }
+
+    memoryProperties = ChooseReadbackMemory(
+        device->GetPhysicalDevice()->GetMemoryProperties());
+
+    if (readbackFormat != EReadbackFormat::Native) {
+        InitConversion();
+    }
+
+    thread = std::thread([this]() { ConsumerLoop(); });
+}
+
+FVulkanFrameReadback::~FVulkanFrameReadback()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bStopping = true;
+    }
+    retiredCondition.notify_all();
+
+    thread.join();
+
+    auto vk_device = device->GetDevice();
+
+    for (FSlot& slot : slots) {
+        slot.buffer.reset();
+    }
+    sourceBuffer.reset();
+
+    if (conversionPipeline) {
+        vk_device.destroyPipeline(conversionPipeline);
+        vk_device.destroyPipelineLayout(conversionLayout);
+        vk_device.destroyDescriptorPool(descriptorPool);
+        vk_device.destroyDescriptorSetLayout(descriptorSetLayout);
+    }
+    conversionShader.reset();
+
+    std::cout << "Frame readback: " << capturedCount << " captured, "
+              << droppedCount << " dropped" << std::endl;
+}
+
+void FVulkanFrameReadback::InitConversion()
+{
+    auto vk_device = device->GetDevice();
+    FVulkanGpu* gpu = device->GetPhysicalDevice();
+
+    const FQueueFamilyIndices& indices = gpu->GetQueueFamilies();
+    const vk::QueueFlags graphicsFlags =
+        gpu->GetCapabilities()
+            .queueFamilies[indices.graphicsFamily.value()]
+            .queueFlags;
+    if (!(graphicsFlags & vk::QueueFlagBits::eCompute)) {
+        throw std::runtime_error(
+            "YUV readback needs compute on the graphics queue");
+    }
+
+    conversionShader = device->CreateShader("shaders/rgba_to_yuv.comp.spv",
+                                            vk::ShaderStageFlagBits::eCompute);
+
+    // Must match the constant_id layout qualifiers in rgba_to_yuv.comp
+    conversionShader->DeclareConstant("bI420", 0);
+    conversionShader->DeclareConstant("bBGRA", 1);
+
+    const vk::DescriptorSetLayoutBinding bindings[] = {
+        {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        },
+        {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        },
+    };
+
+    const vk::DescriptorSetLayoutCreateInfo setLayoutInfo = {
+        .sType = vk::StructureType::eDescriptorSetLayoutCreateInfo,
+        .bindingCount = 2,
+        .pBindings = bindings,
+    };
+
+    VERIFY_VULKAN_RESULT(vk_device.createDescriptorSetLayout(
+        &setLayoutInfo, nullptr, &descriptorSetLayout));
+
+    const uint32_t slotCount = static_cast<uint32_t>(slots.size());
+
+    const vk::DescriptorPoolSize poolSize = {
+        .type = vk::DescriptorType::eStorageBuffer,
+        .descriptorCount = slotCount * 2,
+    };
+
+    const vk::DescriptorPoolCreateInfo poolInfo = {
+        .sType = vk::StructureType::eDescriptorPoolCreateInfo,
+        .maxSets = slotCount,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize,
+    };
+
+    VERIFY_VULKAN_RESULT(
+        vk_device.createDescriptorPool(&poolInfo, nullptr, &descriptorPool));
+
+    const std::vector<vk::DescriptorSetLayout> setLayouts(slotCount,
+                                                          descriptorSetLayout);
+
+    const vk::DescriptorSetAllocateInfo setInfo = {
+        .sType = vk::StructureType::eDescriptorSetAllocateInfo,
+        .descriptorPool = descriptorPool,
+        .descriptorSetCount = slotCount,
+        .pSetLayouts = setLayouts.data(),
+    };
+
+    const std::vector<vk::DescriptorSet> descriptorSets =
+        vk_device.allocateDescriptorSets(setInfo);
+    for (uint32_t i = 0; i < slotCount; i++) {
+        slots[i].descriptorSet = descriptorSets[i];
+    }
+
+    const vk::PushConstantRange pushConstants = {
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = sizeof(FConversionConstants),
+    };
+
+    const vk::PipelineLayoutCreateInfo layoutInfo = {
+        .sType = vk::StructureType::ePipelineLayoutCreateInfo,
+        .setLayoutCount = 1,
+        .pSetLayouts = &descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstants,
+    };
+
+    VERIFY_VULKAN_RESULT(
+        vk_device.createPipelineLayout(&layoutInfo, nullptr, &conversionLayout));
+
+    FVulkanSpecialization specialization;
+    conversionShader->Specialize(specialization, "bI420",
+                                 readbackFormat == EReadbackFormat::I420);
+    conversionShader->Specialize(specialization, "bBGRA",
+                                 IsBGRA8(device->GetSurfaceFormat()));
+
+    const vk::ComputePipelineCreateInfo pipelineInfo = {
+        .sType = vk::StructureType::eComputePipelineCreateInfo,
+        .stage = conversionShader->CreatePipelineStage(&specialization),
+        .layout = conversionLayout,
+        .basePipelineHandle = nullptr,
+        .basePipelineIndex = 0,
+    };
+
+    const auto pipelines = VERIFY_VULKAN_RESULT_VALUE(
+        vk_device.createComputePipelines(nullptr, {pipelineInfo}, nullptr));
+
+    assert(pipelines.size() == 1);
+    conversionPipeline = pipelines[0];
+}
+
+void FVulkanFrameReadback::Record(vk::CommandBuffer* commandBuffer,
+                                  const FVulkanSwapChain& swapChain,
+                                  uint64_t frameIndex)
+{
+    // Checked when the readback was created
+    assert(swapChain.SupportsReadback());
+    const vk::Format format = swapChain.GetFormat();
+    assert(IsBGRA8(format) || IsRGBA8(format));
+
+    FSlot& slot = slots[nextSlot];
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slot.state != ESlotState::Free) {
+            // The consumer fell behind, skip the frame rather than wait
+            droppedCount++;
+            return;
+        }
+    }
+    nextSlot = (nextSlot + 1) % slots.size();
+
+    const vk::Extent2D extent = swapChain.GetExtent();
+
+    slot.frameIndex = frameIndex;
+    slot.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - startTime)
+                           .count();
+    slot.format = format;
+
+    if (readbackFormat == EReadbackFormat::Native) {
+        slot.width = extent.width;
+        slot.height = extent.height;
+    } else {
+        slot.width = extent.width & ~7u;
+        slot.height = extent.height & ~1u;
+    }
+
+    const vk::DeviceSize size = GetFrameSize(slot.width, slot.height);
+    if (size == 0) {
+        droppedCount++;
+        return;
+    }
+
+    if (slot.buffer == nullptr || slot.buffer->GetSize() < size) {
+        slot.buffer.reset();
+        slot.buffer = std::make_unique<FVulkanBuffer>(
+            device, size,
+            vk::BufferUsageFlagBits::eTransferDst |
+                vk::BufferUsageFlagBits::eStorageBuffer,
+            memoryProperties);
+    }
+
+    if (readbackFormat == EReadbackFormat::Native) {
+        RecordCopy(commandBuffer, swapChain, slot);
+    } else {
+        RecordConversion(commandBuffer, swapChain, slot);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    slot.state = ESlotState::InFlight;
+}
+
+vk::DeviceSize FVulkanFrameReadback::GetFrameSize(uint32_t width,
+                                                  uint32_t height) const
+{
+    const vk::DeviceSize pixels = static_cast<vk::DeviceSize>(width) * height;
+
+    return readbackFormat == EReadbackFormat::Native ? pixels * 4
+                                                     : pixels * 3 / 2;
+}
+
+void FVulkanFrameReadback::RecordCopy(vk::CommandBuffer* commandBuffer,
+                                      const FVulkanSwapChain& swapChain,
+                                      FSlot& slot)
+{
+    CopyImageToBuffer(commandBuffer, swapChain, slot.buffer->GetBuffer());
+
+    const vk::BufferMemoryBarrier toHost = {
+        .sType = vk::StructureType::eBufferMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eHostRead,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = slot.buffer->GetBuffer(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eHost, {}, {},
+                                   {toHost}, {});
+}
+
+void FVulkanFrameReadback::RecordConversion(vk::CommandBuffer* commandBuffer,
+                                            const FVulkanSwapChain& swapChain,
+                                            FSlot& slot)
+{
+    const vk::Extent2D extent = swapChain.GetExtent();
+    const vk::DeviceSize sourceSize =
+        static_cast<vk::DeviceSize>(extent.width) * extent.height * 4;
+
+    // Shared by every slot, the previous frame finished reading it before
+    // this one was recorded
+    if (sourceBuffer == nullptr || sourceBuffer->GetSize() < sourceSize) {
+        sourceBuffer.reset();
+        sourceBuffer = std::make_unique<FVulkanBuffer>(
+            device, sourceSize,
+            vk::BufferUsageFlagBits::eTransferDst |
+                vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+    }
+
+    CopyImageToBuffer(commandBuffer, swapChain, sourceBuffer->GetBuffer());
+
+    const vk::BufferMemoryBarrier toCompute = {
+        .sType = vk::StructureType::eBufferMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = sourceBuffer->GetBuffer(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eComputeShader,
+                                   {}, {}, {toCompute}, {});
+
+    const vk::DescriptorBufferInfo sourceInfo = {
+        .buffer = sourceBuffer->GetBuffer(),
+        .offset = 0,
+        .range = VK_WHOLE_SIZE,
+    };
+    const vk::DescriptorBufferInfo destinationInfo = {
+        .buffer = slot.buffer->GetBuffer(),
+        .offset = 0,
+        .range = VK_WHOLE_SIZE,
+    };
+
+    const vk::WriteDescriptorSet writes[] = {
+        {
+            .sType = vk::StructureType::eWriteDescriptorSet,
+            .dstSet = slot.descriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .pBufferInfo = &sourceInfo,
+        },
+        {
+            .sType = vk::StructureType::eWriteDescriptorSet,
+            .dstSet = slot.descriptorSet,
+            .dstBinding = 1,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .pBufferInfo = &destinationInfo,
+        },
+    };
+
+    // The slot was free, so no submitted frame still uses its set
+    device->GetDevice().updateDescriptorSets(2, writes, 0, nullptr);
+
+    const FConversionConstants constants = {
+        .width = slot.width,
+        .height = slot.height,
+        .sourceWidth = extent.width,
+    };
+
+    commandBuffer->bindPipeline(vk::PipelineBindPoint::eCompute,
+                                conversionPipeline);
+    commandBuffer->bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                      conversionLayout, 0, 1,
+                                      &slot.descriptorSet, 0, nullptr);
+    commandBuffer->pushConstants(conversionLayout,
+                                 vk::ShaderStageFlagBits::eCompute, 0,
+                                 sizeof(constants), &constants);
+
+    // One invocation per 8x2 block, 8x8 invocations per group
+    const uint32_t blocksX = slot.width / 8;
+    const uint32_t blocksY = slot.height / 2;
+    commandBuffer->dispatch((blocksX + 7) / 8, (blocksY + 7) / 8, 1);
+
+    const vk::BufferMemoryBarrier toHost = {
+        .sType = vk::StructureType::eBufferMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+        .dstAccessMask = vk::AccessFlagBits::eHostRead,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = slot.buffer->GetBuffer(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                   vk::PipelineStageFlagBits::eHost, {}, {},
+                                   {toHost}, {});
+}
+
+void FVulkanFrameReadback::CopyImageToBuffer(vk::CommandBuffer* commandBuffer,
+                                             const FVulkanSwapChain& swapChain,
+                                             vk::Buffer buffer)
+{
+    const vk::Extent2D extent = swapChain.GetExtent();
+
+    const vk::ImageSubresourceRange colorRange = {
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+
+    // The image was last written by its render pass, or by the upscale blit
+    // with dynamic resolution
+    const vk::ImageMemoryBarrier toTransfer = {
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite |
+                         vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+        .oldLayout = vk::ImageLayout::ePresentSrcKHR,
+        .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapChain.GetImage(),
+        .subresourceRange = colorRange,
+    };
+
+    commandBuffer->pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {toTransfer});
+
+    const vk::BufferImageCopy region = {
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource =
+            {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {extent.width, extent.height, 1},
+    };
+
+    commandBuffer->copyImageToBuffer(swapChain.GetImage(),
+                                     vk::ImageLayout::eTransferSrcOptimal,
+                                     buffer, {region});
+
+    const vk::ImageMemoryBarrier toPresent = {
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eTransferRead,
+        .dstAccessMask = {},
+        .oldLayout = vk::ImageLayout::eTransferSrcOptimal,
+        .newLayout = vk::ImageLayout::ePresentSrcKHR,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapChain.GetImage(),
+        .subresourceRange = colorRange,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   vk::PipelineStageFlagBits::eBottomOfPipe,
+                                   {}, {}, {}, {toPresent});
+}
+
+void FVulkanFrameReadback::Retire(uint64_t completedFrameIndex)
+{
+    bool bRetired = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (FSlot& slot : slots) {
+            if (slot.state == ESlotState::InFlight &&
+                slot.frameIndex <= completedFrameIndex) {
+                slot.state = ESlotState::Retired;
+                bRetired = true;
+            }
+        }
+    }
+
+    if (bRetired) {
+        retiredCondition.notify_one();
+    }
+}
+
+void FVulkanFrameReadback::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    freeCondition.wait(lock, [this]() {
+        return std::none_of(slots.begin(), slots.end(), [](const FSlot& slot) {
+            return slot.state == ESlotState::Retired;
+        });
+    });
+}
+
+void FVulkanFrameReadback::ConsumerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        // Oldest retired frame first so the consumer sees frames in order
+        FSlot* next = nullptr;
+        for (FSlot& slot : slots) {
+            if (slot.state == ESlotState::Retired &&
+                (next == nullptr || slot.frameIndex < next->frameIndex)) {
+                next = &slot;
+            }
+        }
+
+        if (next == nullptr) {
+            if (bStopping) {
+                return;
+            }
+            retiredCondition.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+
+        next->buffer->Invalidate();
+
+        const uint8_t* pixels =
+            static_cast<const uint8_t*>(next->buffer->Map());
+        const size_t size = GetFrameSize(next->width, next->height);
+
+        const FReadbackFrame frame = {
+            .frameIndex = next->frameIndex,
+            .timestampNs = next->timestampNs,
+            .width = next->width,
+            .height = next->height,
+            .rowPitch = readbackFormat == EReadbackFormat::Native
+                            ? next->width * 4
+                            : next->width,
+            .readbackFormat = readbackFormat,
+            .format = next->format,
+            .pixels = {pixels, size},
+        };
+
+        try {
+            consumer(frame);
+        } catch (const std::exception& e) {
+            std::cerr << "Frame readback consumer failed: " << e.what()
+                      << std::endl;
+        }
+
+        capturedCount++;
+
+        lock.lock();
+        next->state = ESlotState::Free;
+        freeCondition.notify_all();
+    }
+}
+
+FVulkanFrameReadback::FConsumer
+FVulkanFrameReadback::CreateFileSink(const std::string& directory,
+                                     const std::string& format)
+{
+    const bool bPng = format == "png";
+    if (!bPng && format != "raw") {
+        throw std::runtime_error("Unknown capture format " + format);
+    }
+
+    std::filesystem::create_directories(directory);
+
+    return [directory, bPng](const FReadbackFrame& frame) {
+        assert(frame.readbackFormat == EReadbackFormat::Native);
+
+        const FImageData image = {
+            .width = frame.width,
+            .height = frame.height,
+            .rowPitch = frame.rowPitch,
+            .bBGRA = IsBGRA8(frame.format),
+            .pixels = frame.pixels.data(),
+        };
+
+        char name[64];
+        if (bPng) {
+            std::snprintf(name, sizeof(name), "frame_%06llu.png",
+                          static_cast<unsigned long long>(frame.frameIndex));
+            FImageWriter::WritePng(directory + "/" + name, image);
+        } else {
+            // Raw dumps carry the layout in the name
+            std::snprintf(name, sizeof(name), "frame_%06llu_%ux%u_%s.raw",
+                          static_cast<unsigned long long>(frame.frameIndex),
+                          frame.width, frame.height,
+                          image.bBGRA ? "bgra8" : "rgba8");
+            FImageWriter::WriteRaw(directory + "/" + name, image);
+        }
+    };
+}
+
+FVulkanFrameReadback::FConsumer
+FVulkanFrameReadback::CreateVideoSink(const std::string& destination)
+{
+    auto writer = std::make_shared<FVideoStreamWriter>(destination);
+
+    return [writer](const FReadbackFrame& frame) {
+        assert(frame.readbackFormat != EReadbackFormat::Native);
+
+        const FVideoFrameHeader header = {
+            .fourcc = frame.readbackFormat == EReadbackFormat::I420
+                          ? MakeFourCC('I', '4', '2', '0')
+                          : MakeFourCC('N', 'V', '1', '2'),
+            .width = frame.width,
+            .height = frame.height,
+            .frameIndex = frame.frameIndex,
+            .timestampNs = frame.timestampNs,
+            .payloadSize = frame.pixels.size(),
+        };
+
+        // Written straight from the mapped slot buffer
+        writer->WriteFrame(header, frame.pixels.data());
+    };
+}
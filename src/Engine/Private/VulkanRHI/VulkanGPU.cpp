@@ -4,9 +4,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -26,7 +28,10 @@ const std::vector<const char*> requiredExtensions = {
 
 FVulkanGpu::FVulkanGpu(vk::PhysicalDevice device, FVulkanInstance* instance,
                        const std::vector<const char*>& layers)
-    : device(device), instance(instance), layers(layers)
+    : device(device), instance(instance), layers(layers),
+      capabilities(
+          FVulkanGpuCapabilities::Query(device, instance->GetSurface())),
+      bMemoryBudget(false)
 {
 }
 
@@ -37,93 +42,163 @@ FVulkanGpu::~FVulkanGpu()
     device = VK_NULL_HANDLE;
 }
 
-FQueueFamilyIndices FVulkanGpu::GetQueueFamilies() const
+const FQueueFamilyIndices& FVulkanGpu::GetQueueFamilies() const
 {
-    FQueueFamilyIndices indices;
-
-    const auto queueFamilies = device.getQueueFamilyProperties();
-
-    vk::SurfaceKHR surface = instance->GetSurface();
-
-    int i = 0;
-    for (const vk::QueueFamilyProperties& properties : queueFamilies) {
-        if (properties.queueFlags & vk::QueueFlagBits::eGraphics) {
-            indices.graphicsFamily = i;
-        }
+    return capabilities.queueFamilyIndices;
+}
 
-        VkBool32 presentSupport = VK_FALSE;
+const vk::PhysicalDeviceProperties& FVulkanGpu::GetProperties() const
+{
+    return capabilities.properties;
+}
 
-        VERIFY_VULKAN_RESULT(
-            device.getSurfaceSupportKHR(i, surface, &presentSupport));
+const vk::PhysicalDeviceFeatures& FVulkanGpu::GetFeatures() const
+{
+    return capabilities.features;
+}
 
-        if (presentSupport) {
-            indices.presentFamily = i;
-        }
+const vk::PhysicalDeviceMemoryProperties&
+FVulkanGpu::GetMemoryProperties() const
+{
+    return capabilities.memoryProperties;
+}
 
-        i += 1;
+uint32_t FVulkanGpu::GetGraphicsTimestampValidBits() const
+{
+    const FQueueFamilyIndices& indices = GetQueueFamilies();
+    if (!indices.graphicsFamily.has_value()) {
+        return 0;
     }
 
-    return indices;
+    return capabilities.queueFamilies[indices.graphicsFamily.value()]
+        .timestampValidBits;
 }
 
-const vk::PhysicalDeviceProperties FVulkanGpu::GetProperties() const
+const std::vector<vk::ExtensionProperties>& FVulkanGpu::GetExtensions() const
 {
-    return device.getProperties();
+    return capabilities.extensions;
 }
 
-const vk::PhysicalDeviceFeatures FVulkanGpu::GetFeatures() const
+vk::FormatProperties FVulkanGpu::GetFormatProperties(vk::Format format) const
 {
-    return device.getFeatures();
+    return device.getFormatProperties(format);
 }
 
-std::vector<vk::ExtensionProperties> FVulkanGpu::GetExtensions() const
+std::optional<vk::Format>
+FVulkanGpu::FindDepthFormat(const std::vector<vk::Format>& candidates) const
 {
-    return device.enumerateDeviceExtensionProperties();
+    for (vk::Format format : candidates) {
+        const vk::FormatProperties properties = GetFormatProperties(format);
+        if (properties.optimalTilingFeatures &
+            vk::FormatFeatureFlagBits::eDepthStencilAttachment) {
+            return format;
+        }
+    }
+
+    return std::nullopt;
 }
 
 bool FVulkanGpu::IsValid() const
 {
-    const auto extensions = GetExtensions();
+    bool IsExtensionAvailable = true;
+
+    for (const char* extensionName : requiredExtensions) {
+        IsExtensionAvailable &= capabilities.HasExtension(extensionName);
+    }
 
-    std::set<std::string> requiredExts(requiredExtensions.begin(),
-                                       requiredExtensions.end());
+    const FQueueFamilyIndices& indices = GetQueueFamilies();
 
-    for (const auto& extensionProperties : extensions) {
-        requiredExts.erase(extensionProperties.extensionName);
+    if (!IsExtensionAvailable || !indices.isValid() ||
+        capabilities.surfaceFormats.empty() ||
+        capabilities.presentModes.empty()) {
+        return false;
     }
 
-    const bool IsExtensionAvailable = requiredExts.empty();
+    for (vk::SurfaceKHR surface : instance->GetSurfaces()) {
+        if (!SupportsSurface(surface)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FVulkanGpu::SupportsSurface(vk::SurfaceKHR surface) const
+{
+    const FQueueFamilyIndices& indices = GetQueueFamilies();
+    if (!indices.presentFamily.has_value()) {
+        return false;
+    }
+
+    // Answered by the snapshot, the driver is only asked for other windows
+    if (surface == instance->GetSurface()) {
+        return capabilities.presentSupport[indices.presentFamily.value()];
+    }
 
-    const FQueueFamilyIndices indices = GetQueueFamilies();
+    VkBool32 presentSupport = VK_FALSE;
+    VERIFY_VULKAN_RESULT(device.getSurfaceSupportKHR(
+        indices.presentFamily.value(), surface, &presentSupport));
 
-    return IsExtensionAvailable && indices.isValid();
+    return presentSupport == VK_TRUE;
 }
 
 uint32_t FVulkanGpu::GetScore() const
 {
-    const auto properties = GetProperties();
-    // const auto features = GetFeatures();
+    const auto& properties = GetProperties();
+    const auto& features = GetFeatures();
+    const auto& limits = properties.limits;
 
     uint32_t score = 0;
 
     switch (properties.deviceType) {
     case vk::PhysicalDeviceType::eDiscreteGpu:
-        score += 1000;
+        score += 10000;
         break;
     case vk::PhysicalDeviceType::eIntegratedGpu:
-        score += 100;
+        score += 1000;
+        break;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+        score += 500;
         break;
     default:
         break;
     }
 
+    // 100 points per GiB of the largest device local heap, integrated GPUs
+    // report shared system memory here so the device type still dominates
+    const vk::DeviceSize deviceLocalMemory =
+        capabilities.GetDeviceLocalMemorySize();
+    score += static_cast<uint32_t>(
+        std::min<vk::DeviceSize>(deviceLocalMemory >> 30, 64) * 100);
+
+    // Separate engines let uploads and compute overlap graphics work
+    if (capabilities.HasDedicatedTransferQueue()) {
+        score += 300;
+    }
+    if (capabilities.HasAsyncComputeQueue()) {
+        score += 300;
+    }
+
+    if (features.samplerAnisotropy) {
+        score += 50;
+    }
+    if (features.textureCompressionBC || features.textureCompressionASTC_LDR) {
+        score += 50;
+    }
+    if (features.multiDrawIndirect) {
+        score += 50;
+    }
+
+    score += limits.maxImageDimension2D / 1024;
+    score += std::min(limits.maxComputeSharedMemorySize / 1024, 64u);
+
     return score;
 }
 
 void FVulkanGpu::InitLogicalDevice()
 {
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-    const FQueueFamilyIndices indices = GetQueueFamilies();
+    const FQueueFamilyIndices& indices = GetQueueFamilies();
 
     const std::set<uint32_t> uniqueQueueFamilies = {
         indices.graphicsFamily.value(), indices.presentFamily.value()};
@@ -161,14 +236,16 @@ void FVulkanGpu::InitLogicalDevice()
     // Swapchain
     extensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
-#if PLATFORM_APPLE
-    const auto extensions = GetExtensions();
+    // Queried through vkGetPhysicalDeviceMemoryProperties2 of Vulkan 1.1
+    bMemoryBudget =
+        capabilities.properties.apiVersion >= VK_API_VERSION_1_1 &&
+        capabilities.HasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (bMemoryBudget) {
+        extensionNames.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
 
-    if (std::find_if(extensions.begin(), extensions.end(),
-                     [](const vk::ExtensionProperties& properties) {
-                         return strcmp(properties.extensionName,
-                                       "VK_KHR_portability_subset");
-                     }) != extensions.end()) {
+#if PLATFORM_APPLE
+    if (capabilities.HasExtension("VK_KHR_portability_subset")) {
         extensionNames.push_back("VK_KHR_portability_subset");
     }
 #endif
@@ -182,6 +259,45 @@ void FVulkanGpu::InitLogicalDevice()
     logicalDevice = std::make_unique<FVulkanDevice>(vk_device, this);
 }
 
+vk::PhysicalDeviceMemoryBudgetPropertiesEXT
+FVulkanGpu::QueryMemoryBudget() const
+{
+    assert(bMemoryBudget);
+
+    const auto chain = device.getMemoryProperties2<
+        vk::PhysicalDeviceMemoryProperties2,
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+    return chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+}
+
+std::string FVulkanGpu::GetName() const
+{
+    return capabilities.properties.deviceName.data();
+}
+
+bool FVulkanGpu::MatchesIdentifier(const std::string& identifier) const
+{
+    if (identifier.empty()) {
+        return false;
+    }
+
+    const auto toLower = [](std::string value) {
+        std::transform(value.begin(), value.end(), value.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        value.erase(std::remove(value.begin(), value.end(), '-'), value.end());
+        return value;
+    };
+
+    const std::string id = toLower(identifier);
+
+    const std::string uuid = toLower(capabilities.GetUUIDString());
+    if (!uuid.empty() && uuid == id) {
+        return true;
+    }
+
+    return toLower(GetName()).find(id) != std::string::npos;
+}
+
 FVulkanDevice* FVulkanGpu::GetLogicalDevice() const
 {
     assert(logicalDevice != nullptr);
@@ -189,8 +305,36 @@ FVulkanDevice* FVulkanGpu::GetLogicalDevice() const
     return logicalDevice.get();
 }
 
-FSwapChainSupportDetails FVulkanGpu::GetSwapChainSupportDetails() const
+FSwapChainSupportDetails
+FVulkanGpu::GetSwapChainSupportDetails(vk::SurfaceKHR surface) const
 {
-    vk::SurfaceKHR surface = instance->GetSurface();
-    return FSwapChainSupportDetails(device, surface);
+    FSurfaceInfo& info = surfaceInfos[surface];
+
+    if (!info.capabilities.has_value()) {
+        vk::SurfaceCapabilitiesKHR caps;
+        VERIFY_VULKAN_RESULT(device.getSurfaceCapabilitiesKHR(surface, &caps));
+        info.capabilities = caps;
+    }
+
+    if (surface == instance->GetSurface()) {
+        return FSwapChainSupportDetails(surface, info.capabilities.value(),
+                                        capabilities.surfaceFormats,
+                                        capabilities.presentModes);
+    }
+
+    if (info.formats.empty()) {
+        info.formats = device.getSurfaceFormatsKHR(surface);
+        info.presentModes = device.getSurfacePresentModesKHR(surface);
+    }
+
+    return FSwapChainSupportDetails(surface, info.capabilities.value(),
+                                    info.formats, info.presentModes);
+}
+
+void FVulkanGpu::InvalidateSurfaceCapabilities(vk::SurfaceKHR surface)
+{
+    const auto it = surfaceInfos.find(surface);
+    if (it != surfaceInfos.end()) {
+        it->second.capabilities.reset();
+    }
 }
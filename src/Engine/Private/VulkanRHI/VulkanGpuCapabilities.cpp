@@ -0,0 +1,140 @@
+#include "VulkanRHI/VulkanGpuCapabilities.h"
+
+#include "VulkanRHI/VulkanCommon.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vulkan/vulkan.hpp>
+
+FVulkanGpuCapabilities FVulkanGpuCapabilities::Query(vk::PhysicalDevice device,
+                                                     vk::SurfaceKHR surface)
+{
+    FVulkanGpuCapabilities caps;
+
+    caps.properties = device.getProperties();
+    caps.features = device.getFeatures();
+    caps.memoryProperties = device.getMemoryProperties();
+
+    if (caps.properties.apiVersion >= VK_API_VERSION_1_1) {
+        const auto chain =
+            device.getProperties2<vk::PhysicalDeviceProperties2,
+                                  vk::PhysicalDeviceIDProperties>();
+        const auto& idProperties = chain.get<vk::PhysicalDeviceIDProperties>();
+
+        std::array<uint8_t, VK_UUID_SIZE> uuid;
+        std::copy(idProperties.deviceUUID.begin(),
+                  idProperties.deviceUUID.end(), uuid.begin());
+        caps.deviceUUID = uuid;
+    }
+    caps.extensions = device.enumerateDeviceExtensionProperties();
+    caps.queueFamilies = device.getQueueFamilyProperties();
+
+    caps.presentSupport.resize(caps.queueFamilies.size(), false);
+
+    for (uint32_t i = 0; i < caps.queueFamilies.size(); i++) {
+        if (caps.queueFamilies[i].queueFlags & vk::QueueFlagBits::eGraphics) {
+            caps.queueFamilyIndices.graphicsFamily = i;
+        }
+
+        VkBool32 presentSupport = VK_FALSE;
+
+        VERIFY_VULKAN_RESULT(
+            device.getSurfaceSupportKHR(i, surface, &presentSupport));
+
+        if (presentSupport) {
+            caps.presentSupport[i] = true;
+            caps.queueFamilyIndices.presentFamily = i;
+        }
+    }
+
+    caps.surfaceFormats = device.getSurfaceFormatsKHR(surface);
+    caps.presentModes = device.getSurfacePresentModesKHR(surface);
+
+    return caps;
+}
+
+std::string FVulkanGpuCapabilities::GetUUIDString() const
+{
+    if (!deviceUUID.has_value()) {
+        return "";
+    }
+
+    std::string result;
+    for (size_t i = 0; i < deviceUUID->size(); i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            result += '-';
+        }
+
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02x", (*deviceUUID)[i]);
+        result += hex;
+    }
+    return result;
+}
+
+vk::DeviceSize FVulkanGpuCapabilities::GetDeviceLocalMemorySize() const
+{
+    vk::DeviceSize size = 0;
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        const vk::MemoryHeap& heap = memoryProperties.memoryHeaps[i];
+        if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            size = std::max(size, heap.size);
+        }
+    }
+
+    return size;
+}
+
+vk::SampleCountFlagBits
+FVulkanGpuCapabilities::GetSampleCount(uint32_t requested) const
+{
+    const vk::SampleCountFlags supported =
+        properties.limits.framebufferColorSampleCounts &
+        properties.limits.framebufferDepthSampleCounts;
+
+    for (uint32_t count = 64; count > 1; count >>= 1) {
+        const auto bit = static_cast<vk::SampleCountFlagBits>(count);
+        if (count <= requested && (supported & bit)) {
+            return bit;
+        }
+    }
+
+    return vk::SampleCountFlagBits::e1;
+}
+
+bool FVulkanGpuCapabilities::HasDedicatedTransferQueue() const
+{
+    for (const vk::QueueFamilyProperties& family : queueFamilies) {
+        if ((family.queueFlags & vk::QueueFlagBits::eTransfer) &&
+            !(family.queueFlags & (vk::QueueFlagBits::eGraphics |
+                                   vk::QueueFlagBits::eCompute))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FVulkanGpuCapabilities::HasAsyncComputeQueue() const
+{
+    for (const vk::QueueFamilyProperties& family : queueFamilies) {
+        if ((family.queueFlags & vk::QueueFlagBits::eCompute) &&
+            !(family.queueFlags & vk::QueueFlagBits::eGraphics)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FVulkanGpuCapabilities::HasExtension(const char* name) const
+{
+    for (const vk::ExtensionProperties& extension : extensions) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,91 @@
+#include "VulkanRHI/VulkanGpuTimer.h"
+
+#include "VulkanRHI/VulkanCommon.h"
+#include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGPU.h"
+
+#include <array>
+#include <stdint.h>
+#include <vulkan/vulkan.hpp>
+
+FVulkanGpuTimer::FVulkanGpuTimer(FVulkanDevice* device)
+    : device(device), queryPool(), timestampPeriod(0.0), timestampMask(0),
+      bSupported(false), bPending(false)
+{
+    FVulkanGpu* gpu = device->GetPhysicalDevice();
+
+    const vk::PhysicalDeviceLimits limits = gpu->GetProperties().limits;
+    const uint32_t validBits = gpu->GetGraphicsTimestampValidBits();
+
+    bSupported = limits.timestampComputeAndGraphics && validBits > 0;
+    if (!bSupported) {
+        return;
+    }
+
+    timestampPeriod = limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    const vk::QueryPoolCreateInfo createInfo = {
+        .sType = vk::StructureType::eQueryPoolCreateInfo,
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = 2,
+    };
+
+    VERIFY_VULKAN_RESULT(
+        device->GetDevice().createQueryPool(&createInfo, nullptr, &queryPool));
+}
+
+FVulkanGpuTimer::~FVulkanGpuTimer()
+{
+    if (queryPool) {
+        device->GetDevice().destroyQueryPool(queryPool);
+    }
+
+    device = VK_NULL_HANDLE;
+}
+
+void FVulkanGpuTimer::Begin(vk::CommandBuffer* commandBuffer)
+{
+    if (!bSupported) {
+        return;
+    }
+
+    commandBuffer->resetQueryPool(queryPool, 0, 2);
+    commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe,
+                                  queryPool, 0);
+}
+
+void FVulkanGpuTimer::End(vk::CommandBuffer* commandBuffer)
+{
+    if (!bSupported) {
+        return;
+    }
+
+    commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe,
+                                  queryPool, 1);
+    bPending = true;
+}
+
+std::optional<double> FVulkanGpuTimer::Resolve()
+{
+    if (!bPending) {
+        return std::nullopt;
+    }
+
+    std::array<uint64_t, 2> timestamps = {};
+
+    const vk::Result result = device->GetDevice().getQueryPoolResults(
+        queryPool, 0, 2, sizeof(timestamps), timestamps.data(),
+        sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+    if (result != vk::Result::eSuccess) {
+        return std::nullopt;
+    }
+
+    bPending = false;
+
+    const uint64_t ticks = (timestamps[1] - timestamps[0]) & timestampMask;
+
+    // timestampPeriod is the number of nanoseconds per tick
+    return static_cast<double>(ticks) * timestampPeriod * 1e-6;
+}
@@ -0,0 +1,109 @@
+#include "VulkanRHI/VulkanImage.h"
+
+#include "VulkanRHI/VulkanCommon.h"
+#include "VulkanRHI/VulkanDevice.h"
+
+#include <vulkan/vulkan.hpp>
+
+FVulkanImage::FVulkanImage(FVulkanDevice* device, vk::Extent2D extent,
+                           vk::Format format, vk::ImageUsageFlags usage,
+                           vk::SampleCountFlagBits samples)
+    : device(device), extent(extent), format(format), samples(samples),
+      bLazilyAllocated(false)
+{
+    auto vk_device = device->GetDevice();
+
+    const vk::ImageCreateInfo createInfo = {
+        .sType = vk::StructureType::eImageCreateInfo,
+        .imageType = vk::ImageType::e2D,
+        .format = format,
+        .extent = {extent.width, extent.height, 1},
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = samples,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined,
+    };
+
+    VERIFY_VULKAN_RESULT(vk_device.createImage(&createInfo, nullptr, &image));
+
+    const vk::MemoryRequirements requirements =
+        vk_device.getImageMemoryRequirements(image);
+
+    const vk::MemoryPropertyFlags lazyProperties =
+        vk::MemoryPropertyFlagBits::eDeviceLocal |
+        vk::MemoryPropertyFlagBits::eLazilyAllocated;
+
+    bLazilyAllocated =
+        (usage & vk::ImageUsageFlagBits::eTransientAttachment) &&
+        device->HasMemoryType(requirements.memoryTypeBits, lazyProperties);
+
+    const vk::ImageUsageFlags attachmentUsage =
+        vk::ImageUsageFlagBits::eColorAttachment |
+        vk::ImageUsageFlagBits::eDepthStencilAttachment |
+        vk::ImageUsageFlagBits::eInputAttachment;
+
+    memory = device->AllocateMemory(
+        requirements,
+        bLazilyAllocated ? lazyProperties
+                         : vk::MemoryPropertyFlags(
+                               vk::MemoryPropertyFlagBits::eDeviceLocal),
+        (usage & attachmentUsage) ? EMemoryCategory::Attachment
+                                  : EMemoryCategory::Image);
+
+    vk_device.bindImageMemory(image, memory, 0);
+
+    const vk::ImageViewCreateInfo viewInfo = {
+        .sType = vk::StructureType::eImageViewCreateInfo,
+        .image = image,
+        .viewType = vk::ImageViewType::e2D,
+        .format = format,
+        .components =
+            {
+                .r = vk::ComponentSwizzle::eIdentity,
+                .g = vk::ComponentSwizzle::eIdentity,
+                .b = vk::ComponentSwizzle::eIdentity,
+                .a = vk::ComponentSwizzle::eIdentity,
+            },
+        .subresourceRange =
+            {
+                .aspectMask = GetAspectMask(format),
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+    };
+
+    VERIFY_VULKAN_RESULT(vk_device.createImageView(&viewInfo, nullptr, &view));
+}
+
+FVulkanImage::~FVulkanImage()
+{
+    auto vk_device = device->GetDevice();
+
+    vk_device.destroyImageView(view);
+    vk_device.destroyImage(image);
+    device->FreeMemory(memory);
+
+    device = VK_NULL_HANDLE;
+}
+
+vk::ImageAspectFlags FVulkanImage::GetAspectMask(vk::Format format)
+{
+    switch (format) {
+    case vk::Format::eD16Unorm:
+    case vk::Format::eX8D24UnormPack32:
+    case vk::Format::eD32Sfloat:
+        return vk::ImageAspectFlagBits::eDepth;
+    case vk::Format::eD16UnormS8Uint:
+    case vk::Format::eD24UnormS8Uint:
+    case vk::Format::eD32SfloatS8Uint:
+        return vk::ImageAspectFlagBits::eDepth |
+               vk::ImageAspectFlagBits::eStencil;
+    default:
+        return vk::ImageAspectFlagBits::eColor;
+    }
+}
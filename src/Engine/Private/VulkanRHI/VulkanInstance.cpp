@@ -1,5 +1,6 @@
 #include "VulkanRHI/VulkanInstance.h"
 
+#include <cassert>
 #include <cstddef>
 #include <iostream>
 #include <memory>
@@ -8,6 +9,7 @@
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "Core/CommandLine.h"
 #include "Definition.h"
 #include "GLFW/glfw3.h"
 #include "VulkanRHI/VulkanCommon.h"
@@ -17,20 +19,17 @@
 std::vector<const char*> FVulkanInstance::validationLayers = {
     "VK_LAYER_KHRONOS_validation"};
 
-FVulkanInstance::FVulkanInstance(GLFWwindow* window)
-    : instance(VK_NULL_HANDLE), surface(VK_NULL_HANDLE)
-{
-    assert(window != nullptr);
-
-    CreateInstance();
-    CreateSurface(window);
-    SelectGPU();
-}
+FVulkanInstance::FVulkanInstance() : instance(VK_NULL_HANDLE) {}
 
 FVulkanInstance::~FVulkanInstance()
 {
     device = nullptr;
 
+    for (vk::SurfaceKHR surface : surfaces) {
+        instance.destroySurfaceKHR(surface);
+    }
+    surfaces.clear();
+
     instance.destroy();
 }
 
@@ -85,19 +84,60 @@ void FVulkanInstance::SelectGPU()
 {
     auto gpus = GetGPUs();
 
-    // Simplest solution
-    for (std::unique_ptr<FVulkanGpu>& gpu : gpus) {
-        if (gpu->IsValid()) {
-            device = std::move(gpu);
-            break;
+    // -gpu=<name or UUID> takes precedence over the score
+    const std::string gpuOverride = FCommandLine::GetString("gpu", "");
+
+    std::unique_ptr<FVulkanGpu>* bestGpu = nullptr;
+    std::unique_ptr<FVulkanGpu>* overrideGpu = nullptr;
+    uint32_t bestScore = 0;
+
+    std::cout << "GPU candidates:" << std::endl;
+    for (size_t i = 0; i < gpus.size(); i++) {
+        std::unique_ptr<FVulkanGpu>& gpu = gpus[i];
+        const FVulkanGpuCapabilities& caps = gpu->GetCapabilities();
+
+        const bool bValid = gpu->IsValid();
+        const uint32_t score = gpu->GetScore();
+
+        std::cout << '\t' << i << ": " << gpu->GetName() << " ["
+                  << vk::to_string(caps.properties.deviceType) << "]"
+                  << " uuid=" << caps.GetUUIDString()
+                  << " vram=" << (caps.GetDeviceLocalMemorySize() >> 20)
+                  << "MiB transfer="
+                  << caps.HasDedicatedTransferQueue()
+                  << " compute=" << caps.HasAsyncComputeQueue()
+                  << " score=" << score << (bValid ? "" : " (unsupported)")
+                  << std::endl;
+
+        if (!bValid) {
+            continue;
+        }
+
+        if (overrideGpu == nullptr && gpu->MatchesIdentifier(gpuOverride)) {
+            overrideGpu = &gpu;
         }
+
+        if (bestGpu == nullptr || score > bestScore) {
+            bestGpu = &gpu;
+            bestScore = score;
+        }
+    }
+
+    if (!gpuOverride.empty() && overrideGpu == nullptr) {
+        std::cout << "No supported GPU matches -gpu=" << gpuOverride
+                  << ", falling back to the highest score" << std::endl;
     }
 
-    if (device == VK_NULL_HANDLE) {
+    std::unique_ptr<FVulkanGpu>* selectedGpu =
+        overrideGpu != nullptr ? overrideGpu : bestGpu;
+
+    if (selectedGpu == nullptr) {
         throw std::runtime_error("Failed to find a suitable GPU!");
     }
 
-    device->InitLogicalDevice();
+    device = std::move(*selectedGpu);
+
+    std::cout << "Selected GPU: " << device->GetName() << std::endl;
 }
 
 void FVulkanInstance::CreateInstance()
@@ -169,6 +209,8 @@ void FVulkanInstance::CreateInstance()
 
 void FVulkanInstance::CreateSurface(GLFWwindow* window)
 {
+    assert(window != nullptr);
+
     VkSurfaceKHR c_surface;
     const VkResult Result =
         glfwCreateWindowSurface(instance, window, nullptr, &c_surface);
@@ -177,5 +219,5 @@ void FVulkanInstance::CreateSurface(GLFWwindow* window)
         throw std::runtime_error("Failed to create window surface");
     }
 
-    surface = c_surface;
+    surfaces.push_back(c_surface);
 }
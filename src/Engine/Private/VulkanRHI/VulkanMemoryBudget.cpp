@@ -0,0 +1,234 @@
+#include "VulkanRHI/VulkanMemoryBudget.h"
+
+#include "Core/CommandLine.h"
+#include "VulkanRHI/VulkanGPU.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+
+// Leaving pressure needs this much room under the threshold, so a heap right
+// at the threshold does not flip every query
+constexpr double PressureHysteresis = 0.05;
+
+// Budget of a heap without VK_EXT_memory_budget
+constexpr double HeapBudgetFraction = 0.8;
+
+double ToMiB(vk::DeviceSize bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+const char* GetMemoryCategoryName(EMemoryCategory category)
+{
+    switch (category) {
+    case EMemoryCategory::Buffer:
+        return "buffers";
+    case EMemoryCategory::Image:
+        return "images";
+    case EMemoryCategory::Staging:
+        return "staging";
+    case EMemoryCategory::Attachment:
+        return "attachments";
+    case EMemoryCategory::Count:
+        break;
+    }
+    return "unknown";
+}
+
+FVulkanMemoryBudget::FVulkanMemoryBudget(FVulkanGpu* gpu)
+    : gpu(gpu), bDriverBudget(gpu->HasMemoryBudget()),
+      queryInterval(static_cast<uint32_t>(
+          std::max<int64_t>(FCommandLine::GetInt("memoryinterval", 30), 1))),
+      pressureThreshold(FCommandLine::GetFloat("memorypressure", 90.0) / 100.0),
+      bLog(FCommandLine::HasParam("memorylog")), lastQueryFrame(0)
+{
+    const vk::PhysicalDeviceMemoryProperties& properties =
+        gpu->GetMemoryProperties();
+
+    typeHeaps.resize(properties.memoryTypeCount);
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+        typeHeaps[i] = properties.memoryTypes[i].heapIndex;
+    }
+
+    heaps.resize(properties.memoryHeapCount);
+    untrackedUsage.resize(properties.memoryHeapCount, 0);
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+        const vk::MemoryHeap& heap = properties.memoryHeaps[i];
+        heaps[i].size = heap.size;
+        heaps[i].bDeviceLocal = static_cast<bool>(
+            heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+        heaps[i].budget = static_cast<vk::DeviceSize>(
+            static_cast<double>(heap.size) * HeapBudgetFraction);
+    }
+
+    QueryBudget();
+}
+
+void FVulkanMemoryBudget::OnAllocate(vk::DeviceMemory memory,
+                                     uint32_t memoryTypeIndex,
+                                     vk::DeviceSize size,
+                                     EMemoryCategory category)
+{
+    assert(memoryTypeIndex < typeHeaps.size());
+    const uint32_t heapIndex = typeHeaps[memoryTypeIndex];
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    FMemoryHeapBudget& heap = heaps[heapIndex];
+    heap.allocated += size;
+    heap.peakAllocated = std::max(heap.peakAllocated, heap.allocated);
+    heap.categories[static_cast<size_t>(category)] += size;
+    heap.usage = untrackedUsage[heapIndex] + heap.allocated;
+
+    allocations.emplace(static_cast<VkDeviceMemory>(memory),
+                        FAllocation{
+                            .heapIndex = heapIndex,
+                            .size = size,
+                            .category = category,
+                        });
+}
+
+void FVulkanMemoryBudget::OnFree(vk::DeviceMemory memory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto found = allocations.find(static_cast<VkDeviceMemory>(memory));
+    assert(found != allocations.end());
+    const FAllocation& allocation = found->second;
+
+    FMemoryHeapBudget& heap = heaps[allocation.heapIndex];
+    heap.allocated -= allocation.size;
+    heap.categories[static_cast<size_t>(allocation.category)] -=
+        allocation.size;
+    heap.usage = untrackedUsage[allocation.heapIndex] + heap.allocated;
+
+    allocations.erase(found);
+}
+
+void FVulkanMemoryBudget::Update(uint64_t frameIndex)
+{
+    if (frameIndex < lastQueryFrame + queryInterval) {
+        return;
+    }
+    lastQueryFrame = frameIndex;
+
+    QueryBudget();
+
+    // Callbacks run without the lock, they usually free memory
+    std::vector<std::pair<uint32_t, bool>> changes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (uint32_t i = 0; i < heaps.size(); i++) {
+            FMemoryHeapBudget& heap = heaps[i];
+            const double fraction =
+                heap.budget > 0 ? static_cast<double>(heap.usage) /
+                                      static_cast<double>(heap.budget)
+                                : 0.0;
+
+            const bool bPressure =
+                heap.bPressure
+                    ? fraction >= pressureThreshold - PressureHysteresis
+                    : fraction >= pressureThreshold;
+            if (bPressure != heap.bPressure) {
+                heap.bPressure = bPressure;
+                changes.emplace_back(i, bPressure);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < heaps.size() && bLog; i++) {
+        std::cout << "Memory " << Format(i) << std::endl;
+    }
+
+    for (const auto& [heapIndex, bPressure] : changes) {
+        std::cout << (bPressure ? "Memory heap near budget: "
+                                : "Memory heap back under budget: ")
+                  << Format(heapIndex) << std::endl;
+
+        for (const FPressureCallback& callback : callbacks) {
+            callback(heapIndex, bPressure);
+        }
+    }
+}
+
+void FVulkanMemoryBudget::QueryBudget()
+{
+    if (!bDriverBudget) {
+        return;
+    }
+
+    const vk::PhysicalDeviceMemoryBudgetPropertiesEXT budgets =
+        gpu->QueryMemoryBudget();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (uint32_t i = 0; i < heaps.size(); i++) {
+        FMemoryHeapBudget& heap = heaps[i];
+        heap.budget = budgets.heapBudget[i];
+        // Lazily allocated memory may not be counted yet
+        untrackedUsage[i] = budgets.heapUsage[i] > heap.allocated
+                                ? budgets.heapUsage[i] - heap.allocated
+                                : 0;
+        heap.usage = untrackedUsage[i] + heap.allocated;
+    }
+}
+
+void FVulkanMemoryBudget::AddPressureCallback(FPressureCallback callback)
+{
+    callbacks.push_back(std::move(callback));
+}
+
+std::vector<FMemoryHeapBudget> FVulkanMemoryBudget::GetHeaps() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return heaps;
+}
+
+bool FVulkanMemoryBudget::IsUnderPressure(vk::MemoryHeapFlags flags) const
+{
+    const vk::PhysicalDeviceMemoryProperties& properties =
+        gpu->GetMemoryProperties();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (uint32_t i = 0; i < heaps.size(); i++) {
+        if ((properties.memoryHeaps[i].flags & flags) == flags &&
+            heaps[i].bPressure) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string FVulkanMemoryBudget::Format(uint32_t heapIndex) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    assert(heapIndex < heaps.size());
+    const FMemoryHeapBudget& heap = heaps[heapIndex];
+
+    std::ostringstream line;
+    line.precision(1);
+    line << std::fixed << "heap " << heapIndex
+         << (heap.bDeviceLocal ? " (device local)" : "") << ": "
+         << ToMiB(heap.usage) << " of " << ToMiB(heap.budget) << " MiB"
+         << (bDriverBudget ? "" : " (estimated)") << ", allocated "
+         << ToMiB(heap.allocated) << " MiB";
+
+    for (size_t i = 0; i < heap.categories.size(); i++) {
+        line << (i == 0 ? " (" : ", ")
+             << GetMemoryCategoryName(static_cast<EMemoryCategory>(i)) << ' '
+             << ToMiB(heap.categories[i]);
+    }
+    line << ')';
+
+    return line.str();
+}
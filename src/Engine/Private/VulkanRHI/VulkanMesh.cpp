@@ -0,0 +1,166 @@
+#include "VulkanRHI/VulkanMesh.h"
+
+#include "Core/FileManager.h"
+#include "VulkanRHI/VulkanBuffer.h"
+#include "VulkanRHI/VulkanCommandList.h"
+#include "VulkanRHI/VulkanDevice.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vulkan/vulkan.hpp>
+
+FVulkanMesh::FVulkanMesh(FVulkanDevice* device, const std::string& filename)
+    : device(device)
+{
+    const FileBlob file = FileManager::MapFile(filename);
+
+    if (file.GetFileSize() < sizeof(header)) {
+        throw std::runtime_error(filename + " is not a cooked mesh");
+    }
+    std::memcpy(&header, file.GetBytes(), sizeof(header));
+
+    if (header.magic != MeshFileMagic) {
+        throw std::runtime_error(filename + " is not a cooked mesh");
+    }
+    if (header.version != MeshFileVersion) {
+        throw std::runtime_error(filename + " was cooked for version " +
+                                 std::to_string(header.version) +
+                                 ", cook it again");
+    }
+    if (header.vertexStride != sizeof(FMeshVertex) ||
+        (header.indexSize != 2 && header.indexSize != 4) ||
+        header.vertexCount == 0 || header.lodCount == 0 ||
+        header.lodCount > MaxMeshLodCount) {
+        throw std::runtime_error(filename + " has an invalid header");
+    }
+
+    const uint64_t vertexBytes =
+        static_cast<uint64_t>(header.vertexCount) * header.vertexStride;
+    const uint64_t indexBytes =
+        static_cast<uint64_t>(header.indexCount) * header.indexSize;
+    const uint64_t lodBytes =
+        static_cast<uint64_t>(header.lodCount) * sizeof(FMeshLod);
+
+    if (MeshLodTableOffset + lodBytes > file.GetFileSize() ||
+        header.vertexOffset > file.GetFileSize() ||
+        vertexBytes > file.GetFileSize() - header.vertexOffset ||
+        header.indexOffset > file.GetFileSize() ||
+        indexBytes > file.GetFileSize() - header.indexOffset) {
+        throw std::runtime_error(filename + " is truncated");
+    }
+
+    lods.resize(header.lodCount);
+    std::memcpy(lods.data(), file.GetBytes() + MeshLodTableOffset, lodBytes);
+
+    for (const FMeshLod& lod : lods) {
+        if (lod.indexCount == 0 || lod.indexCount % 3 != 0 ||
+            lod.firstIndex > header.indexCount ||
+            lod.indexCount > header.indexCount - lod.firstIndex) {
+            throw std::runtime_error(filename + " has an invalid LOD");
+        }
+    }
+
+    indexType =
+        header.indexSize == 2 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+
+    vertexBuffer = std::make_unique<FVulkanBuffer>(
+        device, vertexBytes,
+        vk::BufferUsageFlagBits::eVertexBuffer |
+            vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    indexBuffer = std::make_unique<FVulkanBuffer>(
+        device, indexBytes,
+        vk::BufferUsageFlagBits::eIndexBuffer |
+            vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    // Both sections go through one staging buffer straight from the mapping
+    FVulkanBuffer stagingBuffer(device, vertexBytes + indexBytes,
+                                vk::BufferUsageFlagBits::eTransferSrc,
+                                vk::MemoryPropertyFlagBits::eHostVisible |
+                                    vk::MemoryPropertyFlagBits::eHostCoherent);
+    stagingBuffer.Upload(file.GetBytes() + header.vertexOffset, vertexBytes);
+    stagingBuffer.Upload(file.GetBytes() + header.indexOffset, indexBytes,
+                         vertexBytes);
+
+    device->SubmitImmediate([&](vk::CommandBuffer* commandBuffer) {
+        const vk::BufferCopy vertexRegion = {
+            .srcOffset = 0,
+            .dstOffset = 0,
+            .size = vertexBytes,
+        };
+        commandBuffer->copyBuffer(stagingBuffer.GetBuffer(),
+                                  vertexBuffer->GetBuffer(), {vertexRegion});
+
+        const vk::BufferCopy indexRegion = {
+            .srcOffset = vertexBytes,
+            .dstOffset = 0,
+            .size = indexBytes,
+        };
+        commandBuffer->copyBuffer(stagingBuffer.GetBuffer(),
+                                  indexBuffer->GetBuffer(), {indexRegion});
+
+        const vk::MemoryBarrier barrier = {
+            .sType = vk::StructureType::eMemoryBarrier,
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead |
+                             vk::AccessFlagBits::eIndexRead,
+        };
+        commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                       vk::PipelineStageFlagBits::eVertexInput,
+                                       {}, {barrier}, {}, {});
+    });
+}
+
+FVulkanMesh::~FVulkanMesh()
+{
+    vertexBuffer.reset();
+    indexBuffer.reset();
+}
+
+float FVulkanMesh::GetBoundingRadius() const
+{
+    float radius = 0.0f;
+    for (size_t i = 0; i < 3; i++) {
+        radius += header.positionExtent[i] * header.positionExtent[i];
+    }
+    return std::sqrt(radius) * 0.5f;
+}
+
+FMeshConstants FVulkanMesh::GetNormalizedConstants() const
+{
+    const float radius = GetBoundingRadius();
+    const float inverseRadius = radius > 0.0f ? 1.0f / radius : 1.0f;
+
+    FMeshConstants constants = {};
+    for (size_t i = 0; i < 3; i++) {
+        constants.positionScale[i] = header.positionExtent[i] * inverseRadius;
+        constants.positionBias[i] =
+            -0.5f * header.positionExtent[i] * inverseRadius;
+    }
+    return constants;
+}
+
+void FVulkanMesh::Bind(FVulkanCommandList& commandList) const
+{
+    const vk::Buffer vertexBuffers[] = {vertexBuffer->GetBuffer()};
+    const vk::DeviceSize vertexOffsets[] = {0};
+    commandList.BindVertexBuffers(0, vertexBuffers, vertexOffsets);
+    commandList.BindIndexBuffer(indexBuffer->GetBuffer(), 0, indexType);
+}
+
+void FVulkanMesh::DrawInstanced(FVulkanCommandList& commandList, uint32_t lod,
+                                const FInstanceRange& range) const
+{
+    assert(lod < lods.size());
+
+    if (range.count == 0) {
+        return;
+    }
+
+    commandList.DrawIndexed(lods[lod].indexCount, range.count,
+                            lods[lod].firstIndex, 0, range.first);
+}
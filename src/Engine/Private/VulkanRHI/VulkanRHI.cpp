@@ -1,27 +1,98 @@
 #include "VulkanRHI/VulkanRHI.h"
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "Core/CommandLine.h"
+#include "Core/TaskGraph.h"
+#include "Core/ThreadPool.h"
 #include "GLFW/glfw3.h"
 #include "VulkanRHI/VulkanCommon.h"
 #include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanFrameReadback.h"
 #include "VulkanRHI/VulkanShader.h"
 #include "VulkanRHI/VulkanSwapChain.h"
 
 constexpr uint32_t WIDTH = 800;
 constexpr uint32_t HEIGHT = 600;
 
-FVulkanRHI::FVulkanRHI() { commandBuffer = VK_NULL_HANDLE; }
+FVulkanRHI::FVulkanRHI() : bFirstFrameReported(false)
+{
+    commandBuffer = VK_NULL_HANDLE;
+}
 
 void FVulkanRHI::Init()
 {
-    CreateWindow();
+    initStartTime = std::chrono::steady_clock::now();
+
+    glfwInit();
+
+    Instance = std::make_unique<FVulkanInstance>();
+
+    // The windows must be created on the main thread, the instance does not
+    // need them and is created at the same time
+    FTaskGraph graph("RHI");
+
+    const auto windowTask = graph.AddTask(
+        "CreateWindows", [this]() { CreateWindows(); }, {}, true);
+    const auto instanceTask = graph.AddTask(
+        "CreateInstance", [this]() { Instance->CreateInstance(); });
+    const auto surfaceTask = graph.AddTask(
+        "CreateSurfaces",
+        [this]() {
+            for (GLFWwindow* window : windows) {
+                Instance->CreateSurface(window);
+            }
+        },
+        {windowTask, instanceTask});
+    const auto gpuTask = graph.AddTask(
+        "SelectGPU", [this]() { Instance->SelectGPU(); }, {surfaceTask});
+    graph.AddTask(
+        "InitLogicalDevice",
+        [this]() { Instance->GetPhysicalDevice()->InitLogicalDevice(); },
+        {gpuTask});
+
+    graph.Run(FThreadPool::Get());
+    graph.PrintReport(std::cout);
+
+    FVulkanDevice* device = Instance->GetPhysicalDevice()->GetLogicalDevice();
+    const uint32_t captureSlots =
+        static_cast<uint32_t>(FCommandLine::GetInt("captureslots", 3));
+
+    if (FCommandLine::HasParam("capture") && FCommandLine::HasParam("video")) {
+        throw std::runtime_error("-capture and -video cannot be combined");
+    }
+
+    // -capture=<png|raw> dumps every frame of the first window
+    if (FCommandLine::HasParam("capture")) {
+        device->EnableReadback(
+            captureSlots, FVulkanFrameReadback::CreateFileSink(
+                              FCommandLine::GetString("capturedir", "capture"),
+                              FCommandLine::GetString("capture", "png")));
+    }
 
-    Instance = std::make_unique<FVulkanInstance>(window);
+    // -video=<nv12|i420> streams the first window as raw YUV frames
+    if (FCommandLine::HasParam("video")) {
+        const std::string format = FCommandLine::GetString("video", "nv12");
+        if (format != "nv12" && format != "i420") {
+            throw std::runtime_error("Unknown video format " + format);
+        }
+
+        device->EnableReadback(
+            captureSlots,
+            FVulkanFrameReadback::CreateVideoSink(
+                FCommandLine::GetString("videoout", "video.rvf")),
+            format == "i420" ? EReadbackFormat::I420 : EReadbackFormat::NV12);
+    }
 }
 
 void FVulkanRHI::Destroy()
@@ -29,23 +100,41 @@ void FVulkanRHI::Destroy()
 
     Instance.reset();
 
-    glfwDestroyWindow(window);
-    window = nullptr;
+    for (GLFWwindow* window : windows) {
+        glfwDestroyWindow(window);
+    }
+    windows.clear();
 }
 
 void FVulkanRHI::Render()
 {
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+    while (PollEvents()) {
         Draw();
     }
 
+    WaitIdle();
+}
+
+void FVulkanRHI::WaitIdle()
+{
     auto vk_device =
         Instance->GetPhysicalDevice()->GetLogicalDevice()->GetDevice();
 
     vk_device.waitIdle();
 }
 
+bool FVulkanRHI::PollEvents()
+{
+    glfwPollEvents();
+
+    for (GLFWwindow* window : windows) {
+        if (glfwWindowShouldClose(window)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 FVulkanInstance* FVulkanRHI::GetInstance() const { return Instance.get(); }
 
 std::vector<vk::ExtensionProperties> FVulkanRHI::GetAvailableExtensions()
@@ -58,15 +147,33 @@ std::vector<vk::LayerProperties> FVulkanRHI::GetAvailableLayers()
     return vk::enumerateInstanceLayerProperties();
 }
 
-void FVulkanRHI::CreateWindow()
+void FVulkanRHI::CreateWindows()
 {
-    glfwInit();
-
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    window = glfwCreateWindow(WIDTH, HEIGHT, "Vulkan window", nullptr, nullptr);
 
-    glfwSetWindowUserPointer(window, this);
-    glfwSetFramebufferSizeCallback(window, OnFramebufferResize);
+    if (FCommandLine::HasParam("headless")) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
+    const int64_t windowCount =
+        std::max<int64_t>(FCommandLine::GetInt("windows", 1), 1);
+
+    for (int64_t i = 0; i < windowCount; i++) {
+        const std::string title =
+            i == 0 ? "Vulkan window"
+                   : "Vulkan window " + std::to_string(i + 1);
+
+        GLFWwindow* window =
+            glfwCreateWindow(WIDTH, HEIGHT, title.c_str(), nullptr, nullptr);
+        if (window == nullptr) {
+            throw std::runtime_error("Failed to create window " + title);
+        }
+
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, OnFramebufferResize);
+
+        windows.push_back(window);
+    }
 }
 
 void FVulkanRHI::OnFramebufferResize(GLFWwindow* window, int width, int height)
@@ -77,10 +184,14 @@ void FVulkanRHI::OnFramebufferResize(GLFWwindow* window, int width, int height)
 
     auto rhi = reinterpret_cast<FVulkanRHI*>(glfwGetWindowUserPointer(window));
 
+    // Swapchains are created in window order
+    const auto it = std::find(rhi->windows.begin(), rhi->windows.end(), window);
+    assert(it != rhi->windows.end());
+
     rhi->GetInstance()
         ->GetPhysicalDevice()
         ->GetLogicalDevice()
-        ->GetSwapChain()
+        ->GetSwapChain(std::distance(rhi->windows.begin(), it))
         ->SetNeedResize();
 }
 
@@ -108,5 +219,14 @@ void FVulkanRHI::Draw()
     _device->Render(commandBuffer.get());
     _device->Submit(commandBuffer.get());
 
-    _device->GetSwapChain()->Present();
+    _device->Present();
+
+    if (!bFirstFrameReported) {
+        bFirstFrameReported = true;
+
+        const auto elapsed = std::chrono::steady_clock::now() - initStartTime;
+        std::cout << "Time to first frame: "
+                  << std::chrono::duration<double, std::milli>(elapsed).count()
+                  << " ms" << std::endl;
+    }
 }
@@ -34,14 +34,32 @@ FVulkanShader::~FVulkanShader()
     device = VK_NULL_HANDLE;
 }
 
-vk::PipelineShaderStageCreateInfo FVulkanShader::CreatePipelineStage() const
+vk::PipelineShaderStageCreateInfo FVulkanShader::CreatePipelineStage(
+    const FVulkanSpecialization* specialization) const
 {
     const vk::PipelineShaderStageCreateInfo stageInfo = {
         .sType = vk::StructureType::ePipelineShaderStageCreateInfo,
         .stage = stage,
         .module = ShaderModule,
         .pName = entryPoint.c_str(),
+        .pSpecializationInfo =
+            specialization != nullptr ? specialization->GetInfo() : nullptr,
     };
 
     return stageInfo;
 }
+
+void FVulkanShader::DeclareConstant(const std::string& name,
+                                    uint32_t constantId)
+{
+    constants[name] = constantId;
+}
+
+uint32_t FVulkanShader::GetConstantId(const std::string& name) const
+{
+    const auto it = constants.find(name);
+    if (it == constants.end()) {
+        throw std::runtime_error("Undeclared specialization constant " + name);
+    }
+    return it->second;
+}
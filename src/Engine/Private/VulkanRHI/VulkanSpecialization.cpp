@@ -0,0 +1,99 @@
+#include "VulkanRHI/VulkanSpecialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+FVulkanSpecialization::FVulkanSpecialization(
+    const FVulkanSpecialization& other)
+    : entries(other.entries), data(other.data)
+{
+}
+
+FVulkanSpecialization&
+FVulkanSpecialization::operator=(const FVulkanSpecialization& other)
+{
+    entries = other.entries;
+    data = other.data;
+    return *this;
+}
+
+void FVulkanSpecialization::SetRaw(uint32_t constantId, const void* value)
+{
+    constexpr uint32_t valueSize = 4;
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), constantId,
+                               [](const vk::SpecializationMapEntry& entry,
+                                  uint32_t id) { return entry.constantID < id; });
+
+    if (it != entries.end() && it->constantID == constantId) {
+        std::memcpy(data.data() + it->offset, value, valueSize);
+        return;
+    }
+
+    const size_t index = it - entries.begin();
+    const uint32_t offset = static_cast<uint32_t>(index) * valueSize;
+
+    const vk::SpecializationMapEntry entry = {
+        .constantID = constantId,
+        .offset = offset,
+        .size = valueSize,
+    };
+    entries.insert(it, entry);
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    data.insert(data.begin() + offset, bytes, bytes + valueSize);
+
+    // Everything after the new entry moved up by one value
+    for (size_t i = index + 1; i < entries.size(); i++) {
+        entries[i].offset += valueSize;
+    }
+}
+
+const vk::SpecializationInfo* FVulkanSpecialization::GetInfo() const
+{
+    if (entries.empty()) {
+        return nullptr;
+    }
+
+    info.mapEntryCount = static_cast<uint32_t>(entries.size());
+    info.pMapEntries = entries.data();
+    info.dataSize = data.size();
+    info.pData = data.data();
+
+    return &info;
+}
+
+size_t FVulkanSpecialization::GetHash() const
+{
+    // FNV-1a over the constant ids and values, offsets follow from the order
+    uint64_t hash = 14695981039346656037ull;
+
+    const auto mix = [&hash](const void* bytes, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<const uint8_t*>(bytes)[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (const vk::SpecializationMapEntry& entry : entries) {
+        mix(&entry.constantID, sizeof(entry.constantID));
+    }
+    mix(data.data(), data.size());
+
+    return static_cast<size_t>(hash);
+}
+
+bool FVulkanSpecialization::operator==(const FVulkanSpecialization& other) const
+{
+    if (entries.size() != other.entries.size() || data != other.data) {
+        return false;
+    }
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].constantID != other.entries[i].constantID) {
+            return false;
+        }
+    }
+    return true;
+}
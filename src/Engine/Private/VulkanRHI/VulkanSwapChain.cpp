@@ -1,8 +1,10 @@
 #include "VulkanRHI/VulkanSwapChain.h"
+#include "Core/InlineVector.h"
 #include "Definition.h"
 #include "VulkanRHI/VulkanCommon.h"
 #include "VulkanRHI/VulkanDevice.h"
 #include "VulkanRHI/VulkanGPU.h"
+#include "VulkanRHI/VulkanImage.h"
 
 #include <cassert>
 #include <cstddef>
@@ -10,12 +12,14 @@
 #include <stdexcept>
 #include <vector>
 
-FVulkanSwapChain::FVulkanSwapChain(FVulkanDevice* device)
-    : logicalDevice(device), swapChain(), CurrentIndex(INDEX_NONE),
-      bSwapchainNeedsResize(false)
+FVulkanSwapChain::FVulkanSwapChain(FVulkanDevice* device,
+                                   vk::SurfaceKHR surface)
+    : logicalDevice(device), surface(surface), swapChain(),
+      CurrentIndex(INDEX_NONE), bSwapchainNeedsResize(false)
 {
     CreateSwapChain();
     CreateImageViews();
+    CreateRenderTargets();
     CreateFrameBuffers();
     CreateSyncObjects();
 }
@@ -35,12 +39,25 @@ void FVulkanSwapChain::CreateSwapChain()
     auto vk_device = logicalDevice->GetDevice();
     FVulkanGpu* gpu = logicalDevice->GetPhysicalDevice();
 
-    const auto details = gpu->GetSwapChainSupportDetails();
+    const auto details = gpu->GetSwapChainSupportDetails(surface);
     assert(details.IsValid());
 
     const vk::SurfaceFormatKHR surfaceFormat =
         details.GetRequiredSurfaceFormat();
 
+    // Every window is drawn with the same render pass
+    if (surfaceFormat.format != logicalDevice->GetSurfaceFormat()) {
+        throw std::runtime_error(
+            "Surface format does not match the render pass");
+    }
+
+    // Transfer source lets FVulkanFrameReadback copy the presented image,
+    // transfer destination is needed for the dynamic resolution upscale
+    vk::ImageUsageFlags imageUsage = vk::ImageUsageFlagBits::eColorAttachment;
+    imageUsage |= details.capabilities.supportedUsageFlags &
+                  (vk::ImageUsageFlagBits::eTransferSrc |
+                   vk::ImageUsageFlagBits::eTransferDst);
+
     vk::SwapchainCreateInfoKHR createInfo = {
         .sType = vk::StructureType::eSwapchainCreateInfoKHR,
         .surface = details.GetSurface(),
@@ -49,7 +66,7 @@ void FVulkanSwapChain::CreateSwapChain()
         .imageColorSpace = surfaceFormat.colorSpace,
         .imageExtent = details.GetRequiredExtent(nullptr),
         .imageArrayLayers = 1,
-        .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+        .imageUsage = imageUsage,
         .preTransform = details.capabilities.currentTransform,
         .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
         .presentMode = details.GetRequiredPresentMode(),
@@ -57,7 +74,7 @@ void FVulkanSwapChain::CreateSwapChain()
         .oldSwapchain = nullptr,
     };
 
-    const auto indices = gpu->GetQueueFamilies();
+    const FQueueFamilyIndices& indices = gpu->GetQueueFamilies();
 
     const uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(),
                                            indices.presentFamily.value()};
@@ -75,6 +92,7 @@ void FVulkanSwapChain::CreateSwapChain()
 
     ImageFormat = createInfo.imageFormat;
     Extent = createInfo.imageExtent;
+    ImageUsage = createInfo.imageUsage;
 
     Images = vk_device.getSwapchainImagesKHR(swapChain);
 }
@@ -112,6 +130,30 @@ void FVulkanSwapChain::CreateImageViews()
     }
 }
 
+void FVulkanSwapChain::CreateRenderTargets()
+{
+    if (logicalDevice->IsDynamicResolutionEnabled()) {
+        sceneTarget = std::make_unique<FVulkanImage>(
+            logicalDevice, Extent, ImageFormat,
+            vk::ImageUsageFlagBits::eColorAttachment |
+                vk::ImageUsageFlagBits::eTransferSrc);
+    }
+
+    if (logicalDevice->GetSampleCount() != vk::SampleCountFlagBits::e1) {
+        colorTarget = std::make_unique<FVulkanImage>(
+            logicalDevice, Extent, ImageFormat,
+            vk::ImageUsageFlagBits::eColorAttachment |
+                vk::ImageUsageFlagBits::eTransientAttachment,
+            logicalDevice->GetSampleCount());
+    }
+
+    depthTarget = std::make_unique<FVulkanImage>(
+        logicalDevice, Extent, logicalDevice->GetDepthFormat(),
+        vk::ImageUsageFlagBits::eDepthStencilAttachment |
+            vk::ImageUsageFlagBits::eTransientAttachment,
+        logicalDevice->GetSampleCount());
+}
+
 void FVulkanSwapChain::CreateFrameBuffers()
 {
     const size_t size = Images.size();
@@ -120,13 +162,20 @@ void FVulkanSwapChain::CreateFrameBuffers()
     auto vk_device = logicalDevice->GetDevice();
 
     for (size_t i = 0; i < size; i++) {
-        const vk::ImageView attachments[] = {ImageViews[i]};
+        // Same order as the render pass attachments
+        TInlineVector<vk::ImageView, 4> attachments;
+        if (colorTarget != nullptr) {
+            attachments.push_back(colorTarget->GetView());
+        }
+        attachments.push_back(sceneTarget != nullptr ? sceneTarget->GetView()
+                                                     : ImageViews[i]);
+        attachments.push_back(depthTarget->GetView());
 
         const vk::FramebufferCreateInfo createInfo = {
             .sType = vk::StructureType::eFramebufferCreateInfo,
             .renderPass = logicalDevice->GetRenderPass(),
-            .attachmentCount = 1,
-            .pAttachments = attachments,
+            .attachmentCount = static_cast<uint32_t>(attachments.size()),
+            .pAttachments = attachments.data(),
             .width = Extent.width,
             .height = Extent.height,
             .layers = 1,
@@ -144,6 +193,13 @@ vk::Framebuffer FVulkanSwapChain::GetFrameBuffer() const
     return frameBuffers[CurrentIndex];
 }
 
+vk::Image FVulkanSwapChain::GetImage() const
+{
+    assert(CurrentIndex < static_cast<int32_t>(Images.size()) &&
+           CurrentIndex != INDEX_NONE);
+    return Images[CurrentIndex];
+}
+
 void FVulkanSwapChain::CreateSyncObjects()
 {
     const vk::SemaphoreCreateInfo semaphoreInfo = {
@@ -173,6 +229,10 @@ void FVulkanSwapChain::Destroy()
     ImageViews.clear();
     Images.clear();
 
+    colorTarget.reset();
+    depthTarget.reset();
+    sceneTarget.reset();
+
     vk_device.destroySwapchainKHR(swapChain);
     swapChain = nullptr;
 
@@ -208,32 +268,19 @@ void FVulkanSwapChain::AcquireNextImage()
     CurrentIndex = nextImageIndex;
 }
 
-void FVulkanSwapChain::Present()
+void FVulkanSwapChain::OnPresentResult(vk::Result result)
 {
-    assert(CurrentIndex != INDEX_NONE);
-
-    const std::vector<vk::Semaphore> waitSemaphores = {
-        GetRenderFinishedSemaphore(),
-    };
-
-    const std::vector<vk::SwapchainKHR> swapChains = {swapChain};
-    const std::vector<uint32_t> swapChainIndices = {
-        static_cast<uint32_t>(CurrentIndex),
-    };
-
-    const vk::PresentInfoKHR presentInfo = {
-        .sType = vk::StructureType::ePresentInfoKHR,
-        .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
-        .pWaitSemaphores = waitSemaphores.data(),
-        .swapchainCount = static_cast<uint32_t>(swapChains.size()),
-        .pSwapchains = swapChains.data(),
-        .pImageIndices = swapChainIndices.data(),
-        .pResults = nullptr,
-    };
-
-    vk::Queue* graphicsQueue = logicalDevice->GetGraphicsQueue();
-
-    VERIFY_VULKAN_RESULT(graphicsQueue->presentKHR(presentInfo));
+    switch (result) {
+    case vk::Result::eSuccess:
+        break;
+    case vk::Result::eErrorOutOfDateKHR:
+    case vk::Result::eSuboptimalKHR:
+        // Recreated before the next acquire
+        bSwapchainNeedsResize = true;
+        break;
+    default:
+        throw std::runtime_error("Failed to present swap chain image");
+    }
 }
 
 void FVulkanSwapChain::Recreate()
@@ -246,8 +293,11 @@ void FVulkanSwapChain::Recreate()
 
     Destroy();
 
+    logicalDevice->GetPhysicalDevice()->InvalidateSurfaceCapabilities(surface);
+
     CreateSwapChain();
     CreateImageViews();
+    CreateRenderTargets();
     CreateFrameBuffers();
 }
 
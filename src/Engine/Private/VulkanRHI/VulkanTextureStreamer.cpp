@@ -0,0 +1,641 @@
+#include "VulkanRHI/VulkanTextureStreamer.h"
+
+#include "Core/InlineVector.h"
+#include "Core/ThreadPool.h"
+#include "VulkanRHI/TextureSource.h"
+#include "VulkanRHI/VulkanBuffer.h"
+#include "VulkanRHI/VulkanCommon.h"
+#include "VulkanRHI/VulkanDevice.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Mips at or below this size stay resident
+constexpr uint32_t TailSize = 64;
+
+// Buffer to image copies need offsets aligned to the texel size
+constexpr vk::DeviceSize StagingAlignment = 16;
+
+constexpr vk::PipelineStageFlags ShaderStages =
+    vk::PipelineStageFlagBits::eVertexShader |
+    vk::PipelineStageFlagBits::eFragmentShader;
+
+FVulkanTextureStreamer::FVulkanTextureStreamer(FVulkanDevice* device,
+                                               vk::DeviceSize budgetBytes,
+                                               uint32_t maxPendingReads)
+    : device(device), budgetBytes(budgetBytes),
+      maxPendingReads(std::max(maxPendingReads, 1u)), requestIndex(1),
+      lastRecordedFrame(0), bMemoryPressure(false), outstandingReads(0)
+{
+    stats.budgetBytes = budgetBytes;
+}
+
+FVulkanTextureStreamer::~FVulkanTextureStreamer()
+{
+    // The read callbacks reference the completion queue
+    while (outstandingReads.load(std::memory_order_acquire) > 0) {
+        if (!FThreadPool::Get().TryRunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (FRetiredResource& resource : retired) {
+        DestroyResource(resource);
+    }
+    retired.clear();
+
+    for (FTexture& texture : textures) {
+        if (texture.image) {
+            RetireImage(texture, 0, nullptr);
+        }
+    }
+    for (FRetiredResource& resource : retired) {
+        DestroyResource(resource);
+    }
+    retired.clear();
+
+    device = nullptr;
+}
+
+FTextureHandle
+FVulkanTextureStreamer::AddTexture(std::unique_ptr<FTextureSource> source)
+{
+    const FTextureHandle handle = static_cast<FTextureHandle>(textures.size());
+
+    FTexture& texture = textures.emplace_back();
+    texture.source = std::move(source);
+    texture.mipCount = texture.source->GetMipCount();
+    texture.residentMip = texture.mipCount;
+    texture.targetMip = texture.mipCount;
+    texture.loadedMips.resize(texture.mipCount);
+
+    texture.tailMip = texture.mipCount - 1;
+    for (uint32_t mip = 0; mip < texture.mipCount; mip++) {
+        const vk::Extent2D extent = texture.source->GetMipExtent(mip);
+        if (std::max(extent.width, extent.height) <= TailSize) {
+            texture.tailMip = mip;
+            break;
+        }
+    }
+    texture.wantedMip = texture.tailMip;
+
+    StartReads(handle, texture.tailMip);
+
+    stats.textureCount += 1;
+
+    return handle;
+}
+
+void FVulkanTextureStreamer::RemoveTexture(FTextureHandle handle)
+{
+    assert(handle < textures.size());
+    FTexture& texture = textures[handle];
+
+    if (texture.source == nullptr) {
+        return;
+    }
+
+    stats.committedBytes -= GetMipRangeSize(texture, texture.targetMip);
+    stats.textureCount -= 1;
+
+    if (texture.image) {
+        RetireImage(texture, lastRecordedFrame, nullptr);
+    }
+
+    // Reads still in flight are dropped when they complete
+    texture.source.reset();
+    texture.loadedMips.clear();
+}
+
+void FVulkanTextureStreamer::RequestScreenSize(FTextureHandle handle,
+                                               float pixels)
+{
+    assert(handle < textures.size());
+    FTexture& texture = textures[handle];
+
+    if (texture.lastRequest != requestIndex) {
+        texture.lastRequest = requestIndex;
+        texture.screenSize = 0.0f;
+    }
+    texture.screenSize = std::max(texture.screenSize, pixels);
+}
+
+vk::ImageView FVulkanTextureStreamer::GetView(FTextureHandle handle) const
+{
+    assert(handle < textures.size());
+    return textures[handle].view;
+}
+
+uint32_t FVulkanTextureStreamer::GetResidentMip(FTextureHandle handle) const
+{
+    assert(handle < textures.size());
+    return textures[handle].residentMip;
+}
+
+uint32_t FVulkanTextureStreamer::GetWantedMip(FTextureHandle handle) const
+{
+    assert(handle < textures.size());
+    return textures[handle].wantedMip;
+}
+
+void FVulkanTextureStreamer::Retire(uint64_t completedFrameIndex)
+{
+    std::erase_if(retired, [&](FRetiredResource& resource) {
+        if (resource.frameIndex > completedFrameIndex) {
+            return false;
+        }
+        DestroyResource(resource);
+        return true;
+    });
+
+    // Textures that were not drawn since the last call only need their tail
+    TInlineVector<FTextureHandle, 64> candidates;
+    stats.starvedTextures = 0;
+
+    for (FTextureHandle handle = 0; handle < textures.size(); handle++) {
+        FTexture& texture = textures[handle];
+        if (texture.source == nullptr) {
+            continue;
+        }
+
+        texture.wantedMip = texture.lastRequest == requestIndex
+                                ? GetMipForScreenSize(texture)
+                                : texture.tailMip;
+
+        if (texture.residentMip > texture.wantedMip &&
+            texture.residentMip <= texture.tailMip) {
+            stats.starvedTextures += 1;
+
+            if (!texture.bFailed && texture.targetMip == texture.residentMip) {
+                candidates.push_back(handle);
+            }
+        }
+    }
+
+    // Device memory is close to its budget, keep what is resident
+    if (bMemoryPressure) {
+        candidates.clear();
+    }
+
+    // The largest shortfall first, then the largest on screen
+    std::sort(candidates.begin(), candidates.end(),
+              [&](FTextureHandle a, FTextureHandle b) {
+                  const FTexture& textureA = textures[a];
+                  const FTexture& textureB = textures[b];
+                  const uint32_t missingA =
+                      textureA.residentMip - textureA.wantedMip;
+                  const uint32_t missingB =
+                      textureB.residentMip - textureB.wantedMip;
+                  if (missingA != missingB) {
+                      return missingA > missingB;
+                  }
+                  return textureA.screenSize > textureB.screenSize;
+              });
+
+    for (FTextureHandle handle : candidates) {
+        if (outstandingReads.load(std::memory_order_relaxed) >=
+            maxPendingReads) {
+            break;
+        }
+
+        FTexture& texture = textures[handle];
+        const uint32_t nextMip = texture.residentMip - 1;
+        const vk::DeviceSize mipSize = texture.source->GetMipSize(nextMip);
+
+        // Make room from textures resident above what they are drawn at
+        bool bFits = stats.committedBytes + mipSize <= budgetBytes;
+        while (!bFits && EvictOneMip(handle)) {
+            bFits = stats.committedBytes + mipSize <= budgetBytes;
+        }
+
+        if (!bFits) {
+            break;
+        }
+
+        StartReads(handle, nextMip);
+    }
+
+    requestIndex += 1;
+}
+
+void FVulkanTextureStreamer::SetMemoryPressure(bool bPressure)
+{
+    bMemoryPressure = bPressure;
+}
+
+void FVulkanTextureStreamer::Record(vk::CommandBuffer* commandBuffer,
+                                    uint64_t frameIndex)
+{
+    lastRecordedFrame = frameIndex;
+
+    DrainCompletedReads();
+
+    for (FTexture& texture : textures) {
+        if (texture.source == nullptr ||
+            texture.targetMip == texture.residentMip ||
+            texture.pendingReads > 0) {
+            continue;
+        }
+
+        if (texture.bFailed && texture.targetMip < texture.residentMip) {
+            // Keep what is resident, the texture is not streamed any further
+            stats.committedBytes -=
+                GetMipRangeSize(texture, texture.targetMip) -
+                GetMipRangeSize(texture, texture.residentMip);
+            texture.targetMip = texture.residentMip;
+            std::fill(texture.loadedMips.begin(), texture.loadedMips.end(),
+                      std::nullopt);
+            continue;
+        }
+
+        RecreateImage(commandBuffer, texture, frameIndex);
+    }
+
+    stats.pendingReads = outstandingReads.load(std::memory_order_relaxed);
+}
+
+vk::DeviceSize FVulkanTextureStreamer::GetMipRangeSize(const FTexture& texture,
+                                                       uint32_t firstMip) const
+{
+    vk::DeviceSize size = 0;
+    for (uint32_t mip = firstMip; mip < texture.mipCount; mip++) {
+        size += texture.source->GetMipSize(mip);
+    }
+    return size;
+}
+
+uint32_t
+FVulkanTextureStreamer::GetMipForScreenSize(const FTexture& texture) const
+{
+    if (texture.screenSize <= 0.0f) {
+        return texture.tailMip;
+    }
+
+    // The smallest mip that still covers every pixel it is drawn to
+    const vk::Extent2D extent = texture.source->GetExtent();
+    const float ratio =
+        static_cast<float>(std::max(extent.width, extent.height)) /
+        texture.screenSize;
+
+    if (ratio <= 1.0f) {
+        return 0;
+    }
+
+    return std::min(static_cast<uint32_t>(std::floor(std::log2(ratio))),
+                    texture.tailMip);
+}
+
+void FVulkanTextureStreamer::StartReads(FTextureHandle handle,
+                                        uint32_t firstMip)
+{
+    FTexture& texture = textures[handle];
+    assert(firstMip < texture.residentMip && texture.pendingReads == 0);
+
+    stats.committedBytes += GetMipRangeSize(texture, firstMip) -
+                            GetMipRangeSize(texture, texture.residentMip);
+
+    texture.targetMip = firstMip;
+    texture.pendingReads = texture.residentMip - firstMip;
+    outstandingReads.fetch_add(texture.pendingReads, std::memory_order_relaxed);
+
+    for (uint32_t mip = firstMip; mip < texture.residentMip; mip++) {
+        texture.source->ReadMip(
+            mip, [this, handle, mip](std::optional<FileBlob> blob) {
+                {
+                    std::lock_guard<std::mutex> lock(completedMutex);
+                    completedReads.push_back({
+                        .texture = handle,
+                        .mip = mip,
+                        .blob = std::move(blob),
+                    });
+                }
+                outstandingReads.fetch_sub(1, std::memory_order_release);
+            });
+    }
+}
+
+void FVulkanTextureStreamer::DrainCompletedReads()
+{
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        std::swap(completedReads, drainedReads);
+    }
+
+    for (FCompletedRead& read : drainedReads) {
+        FTexture& texture = textures[read.texture];
+        if (texture.source == nullptr) {
+            continue;
+        }
+
+        texture.pendingReads -= 1;
+
+        if (!read.blob.has_value() ||
+            read.blob->GetFileSize() != texture.source->GetMipSize(read.mip)) {
+            std::cout << "Failed to stream mip " << read.mip << " of texture "
+                      << read.texture << std::endl;
+            texture.bFailed = true;
+            continue;
+        }
+
+        texture.loadedMips[read.mip] = std::move(read.blob);
+    }
+
+    drainedReads.clear();
+}
+
+bool FVulkanTextureStreamer::EvictOneMip(FTextureHandle requester)
+{
+    FTexture* victim = nullptr;
+
+    for (FTextureHandle handle = 0; handle < textures.size(); handle++) {
+        FTexture& texture = textures[handle];
+
+        if (handle == requester || texture.source == nullptr ||
+            texture.targetMip != texture.residentMip ||
+            texture.residentMip >= texture.wantedMip) {
+            continue;
+        }
+
+        if (victim == nullptr || texture.lastRequest < victim->lastRequest ||
+            (texture.lastRequest == victim->lastRequest &&
+             texture.wantedMip - texture.residentMip >
+                 victim->wantedMip - victim->residentMip)) {
+            victim = &texture;
+        }
+    }
+
+    if (victim == nullptr) {
+        return false;
+    }
+
+    stats.committedBytes -= victim->source->GetMipSize(victim->residentMip);
+    victim->targetMip = victim->residentMip + 1;
+
+    return true;
+}
+
+void FVulkanTextureStreamer::RecreateImage(vk::CommandBuffer* commandBuffer,
+                                           FTexture& texture,
+                                           uint64_t frameIndex)
+{
+    auto vk_device = device->GetDevice();
+
+    const uint32_t newMip = texture.targetMip;
+    const uint32_t oldMip = texture.residentMip;
+    const vk::Extent2D extent = texture.source->GetMipExtent(newMip);
+    const vk::Format format = texture.source->GetFormat();
+
+    // Image, memory and view for [newMip, mipCount)
+    const vk::ImageCreateInfo imageInfo = {
+        .sType = vk::StructureType::eImageCreateInfo,
+        .imageType = vk::ImageType::e2D,
+        .format = format,
+        .extent = {extent.width, extent.height, 1},
+        .mipLevels = texture.mipCount - newMip,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eTransferSrc |
+                 vk::ImageUsageFlagBits::eTransferDst |
+                 vk::ImageUsageFlagBits::eSampled,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined,
+    };
+
+    vk::Image image;
+    VERIFY_VULKAN_RESULT(vk_device.createImage(&imageInfo, nullptr, &image));
+
+    const vk::MemoryRequirements requirements =
+        vk_device.getImageMemoryRequirements(image);
+    const vk::DeviceMemory memory =
+        device->AllocateMemory(requirements,
+                               vk::MemoryPropertyFlagBits::eDeviceLocal,
+                               EMemoryCategory::Image);
+    vk_device.bindImageMemory(image, memory, 0);
+
+    const vk::ImageSubresourceRange newRange = {
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .baseMipLevel = 0,
+        .levelCount = texture.mipCount - newMip,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+
+    const vk::ImageViewCreateInfo viewInfo = {
+        .sType = vk::StructureType::eImageViewCreateInfo,
+        .image = image,
+        .viewType = vk::ImageViewType::e2D,
+        .format = format,
+        .components =
+            {
+                .r = vk::ComponentSwizzle::eIdentity,
+                .g = vk::ComponentSwizzle::eIdentity,
+                .b = vk::ComponentSwizzle::eIdentity,
+                .a = vk::ComponentSwizzle::eIdentity,
+            },
+        .subresourceRange = newRange,
+    };
+
+    vk::ImageView view;
+    VERIFY_VULKAN_RESULT(vk_device.createImageView(&viewInfo, nullptr, &view));
+
+    // Mips read from the source go through one staging buffer
+    std::unique_ptr<FVulkanBuffer> stagingBuffer;
+    TInlineVector<vk::BufferImageCopy, 16> uploads;
+
+    if (newMip < oldMip) {
+        vk::DeviceSize stagingSize = 0;
+        for (uint32_t mip = newMip; mip < oldMip; mip++) {
+            stagingSize += (texture.loadedMips[mip]->GetFileSize() +
+                            StagingAlignment - 1) &
+                           ~(StagingAlignment - 1);
+        }
+
+        stagingBuffer = std::make_unique<FVulkanBuffer>(
+            device, stagingSize, vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible |
+                vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        vk::DeviceSize offset = 0;
+        for (uint32_t mip = newMip; mip < oldMip; mip++) {
+            const FileBlob& blob = *texture.loadedMips[mip];
+            stagingBuffer->Upload(blob.GetBytes(), blob.GetFileSize(), offset);
+
+            const vk::Extent2D mipExtent = texture.source->GetMipExtent(mip);
+            uploads.push_back({
+                .bufferOffset = offset,
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource =
+                    {
+                        .aspectMask = vk::ImageAspectFlagBits::eColor,
+                        .mipLevel = mip - newMip,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                    },
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {mipExtent.width, mipExtent.height, 1},
+            });
+
+            offset += (blob.GetFileSize() + StagingAlignment - 1) &
+                      ~(StagingAlignment - 1);
+            texture.loadedMips[mip].reset();
+        }
+    }
+
+    // Mips both images hold are copied on the GPU
+    TInlineVector<vk::ImageCopy, 16> copies;
+    for (uint32_t mip = std::max(newMip, oldMip); mip < texture.mipCount;
+         mip++) {
+        const vk::Extent2D mipExtent = texture.source->GetMipExtent(mip);
+        copies.push_back({
+            .srcSubresource =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = mip - oldMip,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .srcOffset = {0, 0, 0},
+            .dstSubresource =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = mip - newMip,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .dstOffset = {0, 0, 0},
+            .extent = {mipExtent.width, mipExtent.height, 1},
+        });
+    }
+
+    TInlineVector<vk::ImageMemoryBarrier, 2> toTransfer;
+    toTransfer.push_back({
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = {},
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = newRange,
+    });
+
+    if (texture.image) {
+        toTransfer.push_back({
+            .sType = vk::StructureType::eImageMemoryBarrier,
+            .srcAccessMask = {},
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .newLayout = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = texture.image,
+            .subresourceRange =
+                {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .baseMipLevel = 0,
+                    .levelCount = texture.mipCount - oldMip,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+        });
+    }
+
+    commandBuffer->pipelineBarrier(
+        ShaderStages | vk::PipelineStageFlagBits::eTopOfPipe,
+        vk::PipelineStageFlagBits::eTransfer, {}, 0, nullptr, 0, nullptr,
+        static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+
+    if (!copies.empty() && texture.image) {
+        commandBuffer->copyImage(texture.image,
+                                 vk::ImageLayout::eTransferSrcOptimal, image,
+                                 vk::ImageLayout::eTransferDstOptimal,
+                                 static_cast<uint32_t>(copies.size()),
+                                 copies.data());
+    }
+
+    if (!uploads.empty()) {
+        commandBuffer->copyBufferToImage(
+            stagingBuffer->GetBuffer(), image,
+            vk::ImageLayout::eTransferDstOptimal,
+            static_cast<uint32_t>(uploads.size()), uploads.data());
+    }
+
+    const vk::ImageMemoryBarrier toShaderRead = {
+        .sType = vk::StructureType::eImageMemoryBarrier,
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+        .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+        .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = newRange,
+    };
+
+    commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                   ShaderStages, {}, {}, {}, {toShaderRead});
+
+    RetireImage(texture, frameIndex, std::move(stagingBuffer));
+
+    texture.image = image;
+    texture.view = view;
+    texture.memory = memory;
+    texture.memorySize = requirements.size;
+    texture.residentMip = newMip;
+
+    if (newMip < oldMip) {
+        // The tail is not counted as streamed
+        stats.streamedMips += std::min(oldMip, texture.tailMip) -
+                              std::min(newMip, texture.tailMip);
+    } else {
+        stats.evictedMips += newMip - oldMip;
+    }
+
+    stats.residentBytes += requirements.size;
+    stats.peakResidentBytes =
+        std::max(stats.peakResidentBytes, stats.residentBytes);
+}
+
+void FVulkanTextureStreamer::RetireImage(
+    FTexture& texture, uint64_t frameIndex,
+    std::unique_ptr<FVulkanBuffer> stagingBuffer)
+{
+    retired.push_back({
+        .frameIndex = frameIndex,
+        .image = texture.image,
+        .view = texture.view,
+        .memory = texture.memory,
+        .memorySize = texture.memorySize,
+        .stagingBuffer = std::move(stagingBuffer),
+    });
+
+    texture.image = nullptr;
+    texture.view = nullptr;
+    texture.memory = nullptr;
+    texture.memorySize = 0;
+}
+
+void FVulkanTextureStreamer::DestroyResource(FRetiredResource& resource)
+{
+    auto vk_device = device->GetDevice();
+
+    if (resource.image) {
+        vk_device.destroyImageView(resource.view);
+        vk_device.destroyImage(resource.image);
+        device->FreeMemory(resource.memory);
+        stats.residentBytes -= resource.memorySize;
+    }
+
+    resource.stagingBuffer.reset();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Collects named metrics per benchmark case, printed as a table and written
+// as JSON
+class FBenchmarkReport
+{
+  public:
+    struct FRow {
+        std::string name;
+        std::vector<std::pair<std::string, double>> metrics;
+
+        FRow& Set(const std::string& key, double value);
+    };
+
+    FBenchmarkReport(const std::string& name);
+
+    FRow& AddRow(const std::string& rowName);
+
+    const std::string& GetName() const { return name; }
+    const std::vector<FRow>& GetRows() const { return rows; }
+
+    void Print() const;
+    void WriteJson(const std::string& filename) const;
+
+  private:
+    std::string name;
+    std::vector<FRow> rows;
+};
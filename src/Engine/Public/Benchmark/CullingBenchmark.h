@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+
+// Culls -cullobjects bounding spheres and boxes scattered around a camera
+// with the scalar and the SIMD kernels, serially and on the thread pool.
+// Fails when the backends disagree on an object clear of the frustum planes.
+class FCullingBenchmark
+{
+  public:
+    FCullingBenchmark();
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    uint32_t objectCount;
+    uint32_t warmupIterations;
+    uint32_t measuredIterations;
+};
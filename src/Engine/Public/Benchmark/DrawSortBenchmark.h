@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+
+// Sorts -draws random draw keys with std::stable_sort and FDrawQueue, serially
+// and on the thread pool, and counts the pipeline and material binds of the
+// draws in submission order against sorted order
+class FDrawSortBenchmark
+{
+  public:
+    FDrawSortBenchmark();
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    uint32_t drawCount;
+    uint32_t warmupIterations;
+    uint32_t measuredIterations;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+class FVulkanRHI;
+
+// Runs the default frame loop and checks that steady state frames do not
+// allocate. Fails when more than maxFrameAllocations are counted in a frame,
+// which requires the engine to be built with ENGINE_ALLOCATION_TRACKING.
+class FFrameLoopBenchmark
+{
+  public:
+    FFrameLoopBenchmark(FVulkanRHI* rhi);
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    FVulkanRHI* rhi;
+
+    uint32_t warmupFrames;
+    uint32_t measuredFrames;
+    uint64_t maxFrameAllocations;
+};
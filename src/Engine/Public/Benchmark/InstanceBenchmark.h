@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+class FVulkanRHI;
+
+// Renders the triangle pipeline with 1 to maxInstances instances, growing by
+// a factor of ten, and records CPU and GPU frame time per instance count
+class FInstanceBenchmark
+{
+  public:
+    FInstanceBenchmark(FVulkanRHI* rhi);
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    FVulkanRHI* rhi;
+
+    uint32_t maxInstances;
+    uint32_t warmupFrames;
+    uint32_t measuredFrames;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+
+// Runs every FMathBatch kernel over -mathcount elements with the native SIMD
+// backend and the scalar reference. Fails when the results differ by more
+// than rounding, then reports the time per element of both.
+class FMathBenchmark
+{
+  public:
+    FMathBenchmark();
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    uint32_t elementCount;
+    uint32_t warmupIterations;
+    uint32_t measuredIterations;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+class FVulkanRHI;
+
+// Simulates -entities scene entities in an FEntityWorld each frame, updates
+// their bounds and gathers them into the instance stream that is drawn.
+// Every stage runs once over the chunks serially and once in parallel.
+class FSceneBenchmark
+{
+  public:
+    FSceneBenchmark(FVulkanRHI* rhi);
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    FVulkanRHI* rhi;
+
+    uint32_t entityCount;
+    uint32_t warmupFrames;
+    uint32_t measuredFrames;
+};
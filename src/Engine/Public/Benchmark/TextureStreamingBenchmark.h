@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+class FBenchmarkReport;
+class FVulkanRHI;
+
+// Registers procedural textures far larger than the texture budget and sweeps
+// a focus point across them, the texture under it is drawn the largest.
+// -texturefile=<file.ktx2> streams copies of a KTX2 texture instead.
+// Reports streaming throughput and fails if the committed mips ever exceed
+// the budget plus the always resident tails.
+class FTextureStreamingBenchmark
+{
+  public:
+    FTextureStreamingBenchmark(FVulkanRHI* rhi);
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    FVulkanRHI* rhi;
+
+    uint32_t textureCount;
+    uint32_t textureSize;
+    std::string textureFile;
+    uint32_t warmupFrames;
+    uint32_t measuredFrames;
+};
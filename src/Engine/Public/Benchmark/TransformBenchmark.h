@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+class FBenchmarkReport;
+
+// Updates a hierarchy of -transformnodes nodes after moving every root, then
+// after animating -animatednodes random nodes, serially and on the thread
+// pool. Fails when the incremental result differs from a full update.
+class FTransformBenchmark
+{
+  public:
+    FTransformBenchmark();
+
+    void Run(FBenchmarkReport& report);
+
+  private:
+    uint32_t nodeCount;
+    uint32_t animatedCount;
+    uint32_t warmupIterations;
+    uint32_t measuredIterations;
+};
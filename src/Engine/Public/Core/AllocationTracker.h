@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct FAllocationStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytesAllocated = 0;
+    uint64_t bytesFreed = 0;
+
+    FAllocationStats operator-(const FAllocationStats& other) const
+    {
+        return {
+            .allocations = allocations - other.allocations,
+            .frees = frees - other.frees,
+            .bytesAllocated = bytesAllocated - other.bytesAllocated,
+            .bytesFreed = bytesFreed - other.bytesFreed,
+        };
+    }
+};
+
+// Counts global operator new/delete calls when the engine is configured with
+// ENGINE_ALLOCATION_TRACKING, otherwise every query returns zero
+class FAllocationTracker
+{
+  public:
+    static constexpr size_t MaxTags = 64;
+
+    static bool IsEnabled();
+
+    // Counters of the calling thread
+    static FAllocationStats GetThreadStats();
+    static FAllocationStats GetGlobalStats();
+
+    static FAllocationStats GetTagStats(const char* tag);
+    static std::vector<std::pair<std::string, FAllocationStats>> GetAllTagStats();
+
+    static const char* GetCurrentTag();
+};
+
+// Attributes allocations made by this thread to a tag until destroyed. The tag
+// must be a string literal, tags are compared by address.
+class FScopedAllocationTag
+{
+  public:
+    FScopedAllocationTag(const char* tag);
+    ~FScopedAllocationTag();
+
+  private:
+    const char* previousTag;
+};
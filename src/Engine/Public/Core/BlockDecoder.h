@@ -0,0 +1,33 @@
+#pragma once
+
+#include <span>
+#include <stdint.h>
+
+enum class EBlockFormat : uint8_t {
+    // RGB with 1-bit alpha, 8 bytes per 4x4 block
+    BC1,
+    // BC1 color with explicit 4-bit alpha, 16 bytes
+    BC2,
+    // BC1 color with interpolated alpha, 16 bytes
+    BC3,
+    // One interpolated channel, 8 bytes
+    BC4,
+    // Two interpolated channels, 16 bytes
+    BC5,
+};
+
+// CPU decoder for GPUs without BC texture support, the uncompressed fallback
+// of last resort
+class FBlockDecoder
+{
+  public:
+    static uint32_t GetBlockBytes(EBlockFormat format);
+    // RGBA for BC1 to BC3, R for BC4 and RG for BC5
+    static uint32_t GetChannelCount(EBlockFormat format);
+
+    // Decodes a width x height image into tightly packed 8-bit texels, blocks
+    // on the right and bottom edge may be partially used
+    static void Decode(EBlockFormat format, std::span<const uint8_t> blocks,
+                       uint32_t width, uint32_t height,
+                       std::span<uint8_t> output);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+// Parses "-name" and "-name=value" style arguments
+class FCommandLine
+{
+  public:
+    static void Init(int argc, const char* const* argv);
+
+    static bool HasParam(const std::string& name);
+
+    static std::optional<std::string> GetValue(const std::string& name);
+
+    static std::string GetString(const std::string& name,
+                                 const std::string& defaultValue);
+    static int64_t GetInt(const std::string& name, int64_t defaultValue);
+    static double GetFloat(const std::string& name, double defaultValue);
+
+  private:
+    static std::unordered_map<std::string, std::string> params;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class FThreadPool;
+
+// Draw sort key, from the most significant bits down: pass, pipeline,
+// material, depth. Sorting by key groups the draws of a pass by the state
+// they need, so recording only binds when the bits above the depth change.
+class FDrawKey
+{
+  public:
+    static constexpr uint32_t PassBits = 4;
+    static constexpr uint32_t PipelineBits = 12;
+    static constexpr uint32_t MaterialBits = 16;
+    static constexpr uint32_t DepthBits = 32;
+
+    // Fields are masked to their width
+    static uint64_t Make(uint32_t pass, uint32_t pipeline, uint32_t material,
+                         uint32_t depth);
+
+    // Orders non-negative view depths front to back, or back to front for
+    // blended draws
+    static uint32_t EncodeDepth(float viewDepth, bool bBackToFront = false);
+
+    static uint32_t GetPass(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> (64 - PassBits));
+    }
+    static uint32_t GetPipeline(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> (MaterialBits + DepthBits)) &
+               ((1u << PipelineBits) - 1);
+    }
+    static uint32_t GetMaterial(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> DepthBits) &
+               ((1u << MaterialBits) - 1);
+    }
+    // Pass, pipeline and material, everything a draw binds
+    static uint64_t GetState(uint64_t key) { return key >> DepthBits; }
+};
+
+struct FDrawItem {
+    uint64_t key;
+    // Index into the caller's draw list
+    uint32_t draw;
+};
+
+// Draws of a frame, sorted by key with an LSD radix sort. Every byte of the
+// key is one pass over the items, bytes that are the same in every key are
+// skipped, so short queues of a few states only pay for the depth.
+class FDrawQueue
+{
+  public:
+    void Reset() { items.clear(); }
+    void Add(uint64_t key, uint32_t draw) { items.push_back({key, draw}); }
+
+    // Stable, draws with equal keys keep the order they were added in. The
+    // histograms and scatters of large queues run on the pool when given.
+    std::span<const FDrawItem> Sort(FThreadPool* pool = nullptr);
+
+    std::span<const FDrawItem> GetItems() const { return items; }
+    size_t GetSize() const { return items.size(); }
+
+  private:
+    std::vector<FDrawItem> items;
+    std::vector<FDrawItem> scratch;
+    // Per block, 256 counts for every key byte, then the scatter offsets
+    std::vector<uint32_t> histograms;
+};
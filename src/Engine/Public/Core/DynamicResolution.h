@@ -0,0 +1,35 @@
+#pragma once
+
+#include <optional>
+
+// Picks the render resolution scale from measured GPU frame times. GPU time
+// is assumed to follow the pixel count, so the smoothed cost is tracked per
+// full resolution frame and the scale is its square root against the budget.
+// It drops immediately when over budget and grows back slowly once there is
+// headroom, so it does not oscillate around the budget.
+class FDynamicResolution
+{
+  public:
+    FDynamicResolution(double budgetMilliseconds, float minScale,
+                       float maxScale);
+
+    // Feeds the GPU time of a finished frame rendered at measuredScale,
+    // returns the new scale
+    float Update(double gpuMilliseconds, float measuredScale);
+
+    float GetScale() const { return scale; }
+    double GetBudget() const { return budget; }
+    // Estimated GPU time of a frame at full resolution
+    std::optional<double> GetFullResolutionTime() const
+    {
+        return fullResolutionTime;
+    }
+
+  private:
+    double budget;
+    float minScale;
+    float maxScale;
+
+    float scale;
+    std::optional<double> fullResolutionTime;
+};
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdint.h>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Handle to an entity, stays valid while components are added and removed.
+// The generation tells a destroyed entity from a new one reusing its slot.
+struct FEntity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const FEntity& other) const = default;
+};
+
+constexpr uint32_t MaxComponentTypes = 64;
+constexpr size_t EntityChunkSize = 16 * 1024;
+
+using FComponentMask = uint64_t;
+
+// Component types get ids on first use, shared by every world
+class FComponentTypes
+{
+  public:
+    struct FInfo {
+        uint32_t size;
+        uint32_t alignment;
+    };
+
+    static uint32_t Register(uint32_t size, uint32_t alignment);
+    static FInfo Get(uint32_t id);
+};
+
+template <typename T> uint32_t GetComponentId()
+{
+    // const T shares the id of T
+    if constexpr (std::is_const_v<T>) {
+        return GetComponentId<std::remove_const_t<T>>();
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Components are moved between chunks with memcpy");
+
+        static const uint32_t id =
+            FComponentTypes::Register(sizeof(T), alignof(T));
+        return id;
+    }
+}
+
+// Fixed size block of one archetype, one array per component type followed
+// by the entity handles
+struct alignas(64) FEntityChunk {
+    std::byte data[EntityChunkSize];
+};
+
+// Entities with the same set of components. Rows are packed, row r lives in
+// chunk r / capacity, and a removed row is filled with the last one.
+class FArchetype
+{
+  public:
+    explicit FArchetype(FComponentMask mask);
+    FArchetype(const FArchetype& other) = delete;
+
+    FComponentMask GetMask() const { return mask; }
+    const std::vector<uint32_t>& GetComponentIds() const
+    {
+        return componentIds;
+    }
+
+    uint32_t GetCapacity() const { return capacity; }
+    uint32_t GetEntityCount() const { return entityCount; }
+    size_t GetChunkCount() const
+    {
+        return (entityCount + capacity - 1) / capacity;
+    }
+    uint32_t GetChunkEntityCount(size_t chunk) const
+    {
+        return std::min(entityCount - static_cast<uint32_t>(chunk) * capacity,
+                        capacity);
+    }
+
+    // FEntity returns the handles of the chunk
+    template <typename T> T* GetArray(size_t chunk) const
+    {
+        std::byte* data = chunks[chunk]->data;
+        if constexpr (std::is_same_v<std::remove_const_t<T>, FEntity>) {
+            return reinterpret_cast<T*>(data + entityOffset);
+        } else {
+            const uint32_t id = GetComponentId<T>();
+            assert(mask & (FComponentMask{1} << id));
+            return reinterpret_cast<T*>(data + offsets[id]);
+        }
+    }
+
+    uint32_t GetComponentSize(uint32_t id) const { return sizes[id]; }
+    void* GetComponent(uint32_t id, uint32_t row) const;
+    FEntity GetEntity(uint32_t row) const;
+
+    // The new row is zeroed
+    uint32_t AddRow(FEntity entity);
+    // Returns the entity moved into the row, if any
+    FEntity RemoveRow(uint32_t row);
+
+  private:
+    FComponentMask mask;
+    std::vector<uint32_t> componentIds;
+    // Indexed by component id
+    std::array<uint32_t, MaxComponentTypes> offsets;
+    std::array<uint32_t, MaxComponentTypes> sizes;
+    uint32_t entityOffset;
+    uint32_t capacity;
+
+    std::vector<std::unique_ptr<FEntityChunk>> chunks;
+    uint32_t entityCount;
+};
+
+// Archetype based entity component store. Components are plain data kept in
+// structure of arrays chunks, so a query streams only the arrays it asks for.
+// Structural changes (creating, destroying, adding or removing components)
+// must not happen while iterating.
+class FEntityWorld
+{
+  public:
+    FEntityWorld();
+    FEntityWorld(const FEntityWorld& other) = delete;
+    ~FEntityWorld();
+
+    template <typename... Ts> FEntity Create(const Ts&... components)
+    {
+        const FEntity entity = CreateEntity(GetMask<Ts...>());
+        (std::memcpy(Get<Ts>(entity), &components, sizeof(Ts)), ...);
+        return entity;
+    }
+
+    void Destroy(FEntity entity);
+    bool IsAlive(FEntity entity) const;
+
+    // Returns nullptr when the entity has no such component
+    template <typename T> T* Get(FEntity entity) const
+    {
+        return static_cast<T*>(GetComponent(entity, GetComponentId<T>()));
+    }
+    template <typename T> bool Has(FEntity entity) const
+    {
+        return Get<T>(entity) != nullptr;
+    }
+
+    // Moves the entity to the archetype with the component, or overwrites it
+    template <typename T> T& Add(FEntity entity, const T& component)
+    {
+        const uint32_t id = GetComponentId<T>();
+        ChangeArchetype(entity,
+                        GetEntityMask(entity) | (FComponentMask{1} << id));
+
+        T* result = static_cast<T*>(GetComponent(entity, id));
+        std::memcpy(result, &component, sizeof(T));
+        return *result;
+    }
+
+    template <typename T> void Remove(FEntity entity)
+    {
+        const uint32_t id = GetComponentId<T>();
+        ChangeArchetype(entity,
+                        GetEntityMask(entity) & ~(FComponentMask{1} << id));
+    }
+
+    // Calls fn(first, count, Ts*... arrays) for every chunk whose entities
+    // have all of Ts. first counts the matching entities in earlier chunks,
+    // so chunks can write to disjoint ranges of an output array.
+    template <typename... Ts, typename Fn> void ForEachChunk(Fn&& fn) const
+    {
+        const FComponentMask mask = GetMask<Ts...>();
+        size_t first = 0;
+
+        for (const std::unique_ptr<FArchetype>& archetype : archetypes) {
+            if ((archetype->GetMask() & mask) != mask) {
+                continue;
+            }
+            for (size_t chunk = 0; chunk < archetype->GetChunkCount();
+                 chunk++) {
+                const size_t count = archetype->GetChunkEntityCount(chunk);
+                fn(first, count, archetype->template GetArray<Ts>(chunk)...);
+                first += count;
+            }
+        }
+    }
+
+    // Same as ForEachChunk with the chunks of each archetype spread over the
+    // pool, fn is called from several threads at once
+    template <typename... Ts, typename Fn>
+    void ParallelForEachChunk(FThreadPool& pool, Fn&& fn) const
+    {
+        const FComponentMask mask = GetMask<Ts...>();
+        size_t first = 0;
+
+        for (const std::unique_ptr<FArchetype>& archetype : archetypes) {
+            if ((archetype->GetMask() & mask) != mask) {
+                continue;
+            }
+
+            const FArchetype& matching = *archetype;
+            pool.ParallelFor(
+                matching.GetChunkCount(), 1, [&](size_t begin, size_t end) {
+                    for (size_t chunk = begin; chunk < end; chunk++) {
+                        fn(first + chunk * matching.GetCapacity(),
+                           static_cast<size_t>(
+                               matching.GetChunkEntityCount(chunk)),
+                           matching.template GetArray<Ts>(chunk)...);
+                    }
+                });
+            first += matching.GetEntityCount();
+        }
+    }
+
+    // Calls fn(Ts&... components) for every matching entity
+    template <typename... Ts, typename Fn> void ForEach(Fn&& fn) const
+    {
+        ForEachChunk<Ts...>([&](size_t, size_t count, Ts*... arrays) {
+            for (size_t i = 0; i < count; i++) {
+                fn(arrays[i]...);
+            }
+        });
+    }
+
+    template <typename... Ts> size_t Count() const
+    {
+        const FComponentMask mask = GetMask<Ts...>();
+        size_t count = 0;
+        for (const std::unique_ptr<FArchetype>& archetype : archetypes) {
+            if ((archetype->GetMask() & mask) == mask) {
+                count += archetype->GetEntityCount();
+            }
+        }
+        return count;
+    }
+
+    size_t GetEntityCount() const { return entityCount; }
+    size_t GetArchetypeCount() const { return archetypes.size(); }
+    size_t GetChunkCount() const;
+
+  private:
+    struct FEntitySlot {
+        FArchetype* archetype;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    template <typename... Ts> static FComponentMask GetMask()
+    {
+        FComponentMask mask = 0;
+        (
+            [&]() {
+                if constexpr (!std::is_same_v<std::remove_const_t<Ts>,
+                                              FEntity>) {
+                    mask |= FComponentMask{1} << GetComponentId<Ts>();
+                }
+            }(),
+            ...);
+        return mask;
+    }
+
+    FArchetype& FindOrCreateArchetype(FComponentMask mask);
+
+    FEntity CreateEntity(FComponentMask mask);
+    FComponentMask GetEntityMask(FEntity entity) const;
+    void* GetComponent(FEntity entity, uint32_t id) const;
+    // Copies the shared components, the new ones are zeroed
+    void ChangeArchetype(FEntity entity, FComponentMask mask);
+
+    std::vector<std::unique_ptr<FArchetype>> archetypes;
+    std::unordered_map<FComponentMask, FArchetype*> archetypesByMask;
+
+    std::vector<FEntitySlot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t entityCount;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <optional>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -8,17 +11,47 @@ class FileBlob
 {
   public:
     FileBlob(const std::vector<char>& inBlob);
+    FileBlob(std::vector<char>&& inBlob);
     FileBlob() = default;
 
     size_t GetFileSize() const;
     const uint32_t* GetData() const;
+    const char* GetBytes() const;
+
+    bool IsMapped() const { return mapping != nullptr; }
+
+    // Bytes [offset, offset + size), slices of a mapped file share the
+    // mapping instead of copying
+    FileBlob Slice(size_t offset, size_t size) const;
 
   protected:
     std::vector<char> blob;
+
+    // Read only view of a memory mapped file, shared by every copy and
+    // unmapped with the last one
+    std::shared_ptr<const char> mapping;
+    size_t mappedSize = 0;
+
+    friend class FileManager;
 };
 
 class FileManager
 {
   public:
+    // Runs on a worker thread, empty when the read failed
+    using FReadCallback = std::function<void(std::optional<FileBlob>)>;
+
     static FileBlob ReadFile(const std::string& filename);
+    // Maps the whole file read only instead of reading it, pages are loaded
+    // as they are touched
+    static FileBlob MapFile(const std::string& filename);
+    // Reads size bytes starting at offset, throws if the file is shorter
+    static FileBlob ReadFile(const std::string& filename, uint64_t offset,
+                             uint64_t size);
+    // Reads the range on FThreadPool::Get() and hands it to onComplete
+    static void ReadFileAsync(const std::string& filename, uint64_t offset,
+                              uint64_t size, FReadCallback onComplete);
+
+    static void WriteFile(const std::string& filename, const void* data,
+                          size_t size);
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Math/MathBatch.h"
+
+#include <span>
+#include <stdint.h>
+#include <vector>
+
+class FThreadPool;
+
+// Culls structure of arrays bounds against a frustum in fixed size chunks
+// spread over the thread pool, then packs the indices each chunk found into
+// one list in increasing order. Without a pool every chunk runs on the
+// calling thread.
+class FFrustumCuller
+{
+  public:
+    static constexpr size_t ChunkSize = 16 * 1024;
+
+    // The result stays valid until the next call
+    std::span<const uint32_t>
+    CullSpheres(const FFrustum& frustum, const FSphereArrays& spheres,
+                FThreadPool* pool,
+                EMathBackend backend = EMathBackend::Native);
+    std::span<const uint32_t>
+    CullBounds(const FFrustum& frustum, const FBoundsArrays& bounds,
+               FThreadPool* pool, EMathBackend backend = EMathBackend::Native);
+
+    std::span<const uint32_t> GetVisible() const { return visible; }
+
+  private:
+    // cullChunk(begin, end, output) culls [begin, end) and returns the number
+    // of indices written to output
+    template <typename Fn>
+    std::span<const uint32_t> Cull(size_t count, FThreadPool* pool,
+                                   Fn&& cullChunk);
+
+    // Chunk c writes its indices from c * ChunkSize on
+    std::vector<uint32_t> chunkVisible;
+    std::vector<uint32_t> chunkCounts;
+    std::vector<uint32_t> chunkOffsets;
+    std::vector<uint32_t> visible;
+};
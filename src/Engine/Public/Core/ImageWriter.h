@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 8-bit, 4 channel pixels as read back from a color attachment
+struct FImageData {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowPitch = 0;
+
+    // Channel order in memory is B, G, R, A instead of R, G, B, A
+    bool bBGRA = false;
+
+    const uint8_t* pixels = nullptr;
+};
+
+class FImageWriter
+{
+  public:
+    // Uncompressed (stored deflate) RGBA PNG, encoding is bound by memory
+    // bandwidth so it keeps up with full rate capture
+    static std::vector<uint8_t> EncodePng(const FImageData& image);
+
+    static void WritePng(const std::string& filename, const FImageData& image);
+
+    // Tightly packed rows in the source channel order
+    static void WriteRaw(const std::string& filename, const FImageData& image);
+};
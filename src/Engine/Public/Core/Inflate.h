@@ -0,0 +1,18 @@
+#pragma once
+
+#include <span>
+#include <stdint.h>
+
+// Decoder for deflate (RFC 1951) and zlib (RFC 1950) streams whose
+// decompressed size is known up front, as in KTX2 and PNG
+class FInflate
+{
+  public:
+    // Throws if the stream is malformed or does not fill output exactly
+    static void Decompress(std::span<const uint8_t> input,
+                           std::span<uint8_t> output);
+
+    // Also checks the zlib header and the Adler-32 of the output
+    static void DecompressZlib(std::span<const uint8_t> input,
+                               std::span<uint8_t> output);
+};
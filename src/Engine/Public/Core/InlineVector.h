@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Vector that keeps up to InlineCapacity elements without touching the heap,
+// used for short transient arrays on the frame path
+template <typename T, size_t InlineCapacity> class TInlineVector
+{
+  public:
+    TInlineVector() : data_(InlineData()), size_(0), capacity_(InlineCapacity)
+    {
+    }
+
+    TInlineVector(std::initializer_list<T> values) : TInlineVector()
+    {
+        reserve(values.size());
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    TInlineVector(const TInlineVector& other) : TInlineVector()
+    {
+        reserve(other.size_);
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+
+    TInlineVector& operator=(const TInlineVector& other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (const T& value : other) {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    ~TInlineVector()
+    {
+        clear();
+        ReleaseHeap();
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    T& operator[](size_t index)
+    {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T& back()
+    {
+        assert(size_ > 0);
+        return data_[size_ - 1];
+    }
+
+    operator std::span<T>() { return {data_, size_}; }
+    operator std::span<const T>() const { return {data_, size_}; }
+
+    void reserve(size_t newCapacity)
+    {
+        if (newCapacity <= capacity_) {
+            return;
+        }
+
+        T* newData = static_cast<T*>(
+            ::operator new(sizeof(T) * newCapacity, std::align_val_t(alignof(T))));
+
+        for (size_t i = 0; i < size_; i++) {
+            new (newData + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+
+        ReleaseHeap();
+
+        data_ = newData;
+        capacity_ = newCapacity;
+    }
+
+    template <typename... Args> T& emplace_back(Args&&... args)
+    {
+        if (size_ == capacity_) {
+            reserve(capacity_ * 2);
+        }
+
+        T* element = new (data_ + size_) T(std::forward<Args>(args)...);
+        size_ += 1;
+        return *element;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        assert(size_ > 0);
+        size_ -= 1;
+        data_[size_].~T();
+    }
+
+    void resize(size_t newSize)
+    {
+        reserve(newSize);
+        while (size_ > newSize) {
+            pop_back();
+        }
+        while (size_ < newSize) {
+            emplace_back();
+        }
+    }
+
+    void clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < size_; i++) {
+                data_[i].~T();
+            }
+        }
+        size_ = 0;
+    }
+
+  private:
+    T* InlineData() { return reinterpret_cast<T*>(inlineStorage); }
+
+    void ReleaseHeap()
+    {
+        if (data_ != InlineData()) {
+            ::operator delete(data_, std::align_val_t(alignof(T)));
+        }
+    }
+
+    alignas(T) std::byte inlineStorage[sizeof(T) * InlineCapacity];
+
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for transient per-frame data. Memory is released all at once
+// by Reset, destructors are never run. Overflow blocks are merged into a
+// single block on Reset so the steady state never touches the heap.
+class FLinearAllocator
+{
+  public:
+    explicit FLinearAllocator(size_t initialCapacity = 64 * 1024);
+    FLinearAllocator(const FLinearAllocator& other) = delete;
+    ~FLinearAllocator();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T> std::span<T> AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "Linear allocations are never destructed");
+
+        if (count == 0) {
+            return {};
+        }
+
+        T* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; i++) {
+            new (data + i) T();
+        }
+        return {data, count};
+    }
+
+    template <typename T> std::span<T> CopyArray(std::span<const T> source)
+    {
+        std::span<T> result = AllocateArray<T>(source.size());
+        std::copy(source.begin(), source.end(), result.begin());
+        return result;
+    }
+
+    void Reset();
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetUsedBytes() const { return usedBytes; }
+
+  private:
+    struct FBlock {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    FBlock current;
+    size_t offset;
+
+    std::vector<FBlock> overflowBlocks;
+
+    size_t capacity;
+    size_t usedBytes;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+// Cooked mesh file written by the MeshCooker tool, little endian. The header is
+// followed by the LOD table, the vertices and the indices, each section starts
+// at a 16 byte aligned offset and is copied into its GPU buffer as is.
+constexpr uint32_t MeshFileMagic = 0x48534d47; // "GMSH"
+constexpr uint32_t MeshFileVersion = 1;
+constexpr uint32_t MeshFileAlignment = 16;
+
+struct FMeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t vertexStride;
+    // Indices of every LOD, 2 or 4 bytes each
+    uint32_t indexCount;
+    uint32_t indexSize;
+    uint32_t lodCount;
+    uint32_t padding;
+    // Positions are stored as unorm16 fractions of these bounds
+    float positionMin[3];
+    float positionExtent[3];
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+};
+
+static_assert(sizeof(FMeshFileHeader) == 72, "Mesh file header layout");
+
+constexpr uint64_t MeshLodTableOffset =
+    (sizeof(FMeshFileHeader) + MeshFileAlignment - 1) &
+    ~uint64_t{MeshFileAlignment - 1};
+
+constexpr uint32_t MaxMeshLodCount = 8;
+
+// LODs go from the full mesh to the coarsest, all of them index the same
+// vertices and their index ranges follow each other
+struct FMeshLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    // Object space distance between the LOD and the full mesh surface, grows
+    // with every LOD
+    float error;
+    uint32_t padding;
+};
+
+static_assert(sizeof(FMeshLod) == 16, "Mesh LOD layout");
+
+// Vertex layout read by mesh.vert
+//   position: R16G16B16A16_UNORM within the header bounds, w is unused
+//   normal:   R16G16_SNORM octahedral encoding
+//   uv:       R16G16_SFLOAT, the origin is the top left of the texture
+struct FMeshVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+static_assert(sizeof(FMeshVertex) == 16, "Mesh vertex layout");
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// Picks mesh LODs from the projected size of each object. The error of every
+// LOD is projected to pixels and the coarsest LOD under the threshold wins.
+// Objects only move to a coarser LOD once its error is clearly under the
+// threshold, so a size right at a boundary does not pop back and forth.
+class FMeshLodSelector
+{
+  public:
+    // Errors from the finest LOD on, as fractions of the bounding radius
+    FMeshLodSelector(std::vector<float> lodErrors, float pixelThreshold);
+
+    // radiusPixels is the projected bounding sphere radius
+    uint32_t Select(float radiusPixels, uint32_t currentLod) const;
+
+    uint32_t GetLodCount() const
+    {
+        return static_cast<uint32_t>(errors.size());
+    }
+
+  private:
+    std::vector<float> errors;
+    float threshold;
+};
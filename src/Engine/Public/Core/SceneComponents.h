@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Components of renderable scene entities. Every type is its own array in the
+// entity chunks, so a system reading transforms only streams transforms.
+
+struct FTransform {
+    float position[3];
+    float scale;
+    // Unit quaternion, xyzw
+    float rotation[4];
+};
+
+// World space bounding sphere
+struct FBounds {
+    float center[3];
+    float radius;
+};
+
+struct FRenderData {
+    uint32_t mesh;
+    uint32_t material;
+    // Bounding sphere radius of the mesh in object space
+    float localRadius;
+    uint32_t flags;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class FThreadPool;
+
+// Runs a set of named tasks in dependency order on a thread pool and records
+// when each of them ran, so startup phases can overlap and be reported
+class FTaskGraph
+{
+  public:
+    using FTaskId = uint32_t;
+
+    FTaskGraph(const std::string& name);
+
+    // Tasks flagged bMainThread only run on the thread calling Run, for APIs
+    // like window creation that are bound to the main thread
+    FTaskId AddTask(const std::string& taskName, std::function<void()> function,
+                    std::initializer_list<FTaskId> dependencies = {},
+                    bool bMainThread = false);
+
+    // Blocks until every task has finished. The calling thread executes tasks
+    // as well. The first exception thrown by a task is rethrown here, tasks
+    // depending on a failed task are skipped.
+    void Run(FThreadPool& pool);
+
+    double GetTotalMilliseconds() const;
+
+    // Per task start, duration and thread, followed by the critical path
+    void PrintReport(std::ostream& stream) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct FTask {
+        std::string name;
+        std::function<void()> function;
+        std::vector<FTaskId> dependencies;
+        std::vector<FTaskId> dependents;
+        bool bMainThread;
+
+        uint32_t pendingDependencies;
+        bool bRanOnCaller;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    std::string name;
+    std::vector<FTask> tasks;
+
+    Clock::time_point runStart;
+    Clock::time_point runEnd;
+
+    std::vector<FTaskId> GetCriticalPath() const;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class FThreadPool
+{
+  public:
+    explicit FThreadPool(uint32_t numThreads);
+    FThreadPool(const FThreadPool& other) = delete;
+    ~FThreadPool();
+
+    // Shared pool with one worker per hardware thread besides the caller
+    static FThreadPool& Get();
+
+    uint32_t GetNumThreads() const
+    {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    void Enqueue(std::function<void()> task);
+
+    // Runs one queued task on the calling thread, returns false if the queue
+    // was empty. Lets waiting threads help instead of blocking.
+    bool TryRunPendingTask();
+
+    // Calls fn(begin, end) over [0, count) in batches of at least minBatchSize
+    // on the workers and the calling thread, returns when all batches are done
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t minBatchSize, Fn&& fn)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        minBatchSize = std::max<size_t>(minBatchSize, 1);
+
+        const size_t maxBatches = (count + minBatchSize - 1) / minBatchSize;
+        const size_t numBatches =
+            std::min<size_t>(maxBatches, (GetNumThreads() + 1) * 4);
+
+        if (numBatches <= 1) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        const size_t batchSize = (count + numBatches - 1) / numBatches;
+
+        std::atomic<size_t> nextBatch = 0;
+        std::atomic<size_t> activeHelpers = 0;
+
+        const auto runBatches = [&]() {
+            for (size_t batch = nextBatch.fetch_add(1); batch < numBatches;
+                 batch = nextBatch.fetch_add(1)) {
+                const size_t begin = batch * batchSize;
+                const size_t end = std::min(begin + batchSize, count);
+                fn(begin, end);
+            }
+        };
+
+        const size_t numHelpers =
+            std::min<size_t>(GetNumThreads(), numBatches - 1);
+
+        activeHelpers = numHelpers;
+        for (size_t i = 0; i < numHelpers; i++) {
+            Enqueue([&runBatches, &activeHelpers]() {
+                runBatches();
+                activeHelpers.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        runBatches();
+
+        // Helpers reference this stack frame, wait until every one has run
+        while (activeHelpers.load(std::memory_order_acquire) > 0) {
+            if (!TryRunPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+  private:
+    std::vector<std::thread> workers;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+
+    // Ring buffer, grows but never shrinks so steady state enqueues do not
+    // allocate
+    std::vector<std::function<void()>> queue;
+    size_t queueHead;
+    size_t queueSize;
+
+    bool bStopping;
+
+    bool PopTask(std::function<void()>& task);
+    void WorkerLoop();
+};
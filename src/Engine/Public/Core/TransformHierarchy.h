@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Math/Matrix.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class FThreadPool;
+
+constexpr uint32_t InvalidTransformNode = UINT32_MAX;
+
+struct FLocalTransform {
+    FVector3 position;
+    FQuaternion rotation;
+    FVector3 scale = {1.0f, 1.0f, 1.0f};
+};
+
+// Parent relative transforms and the world matrices derived from them. Nodes
+// are kept breadth first in flat arrays, parents before children and the
+// children of a node next to each other, so the descendants of a node on any
+// level are one contiguous range.
+//
+// Update only recomputes the subtrees under nodes whose local transform
+// changed, one level at a time. Nodes of a level do not depend on each other,
+// so the parallel update splits every level of all dirty subtrees together.
+class FTransformHierarchy
+{
+  public:
+    FTransformHierarchy();
+    FTransformHierarchy(const FTransformHierarchy& other) = delete;
+
+    // Returns a node id that stays valid until the node is removed. The world
+    // matrix is computed by the next update.
+    uint32_t Add(uint32_t parent, const FLocalTransform& local = {});
+    // Removes the node and all of its descendants
+    void Remove(uint32_t node);
+    bool IsAlive(uint32_t node) const;
+
+    // Keeps the local transform, now relative to the new parent. Throws if
+    // the parent is in the subtree of the node.
+    void SetParent(uint32_t node, uint32_t parent);
+    uint32_t GetParent(uint32_t node) const { return slots[node].parent; }
+
+    void SetLocal(uint32_t node, const FLocalTransform& local);
+    const FLocalTransform& GetLocal(uint32_t node) const
+    {
+        return locals[slots[node].position];
+    }
+
+    // As of the last update
+    const FMatrix4& GetWorld(uint32_t node) const
+    {
+        return worlds[slots[node].position];
+    }
+
+    void Update();
+    void ParallelUpdate(FThreadPool& pool);
+
+    size_t GetNodeCount() const { return ids.size(); }
+    size_t GetLevelCount() const { return levelOffsets.size() - 1; }
+    // World matrices recomputed by the last update
+    size_t GetUpdatedCount() const { return updatedCount; }
+
+  private:
+    struct FSlot {
+        // In the breadth first arrays
+        uint32_t position;
+        uint32_t parent;
+        bool bAlive;
+        bool bDirty;
+    };
+
+    // Positions [begin, end) on one level
+    struct FRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    void MarkDirty(uint32_t node);
+
+    // Sorts the nodes breadth first again after structural changes and frees
+    // the slots of removed subtrees
+    void Rebuild();
+
+    void UpdateDirty(FThreadPool* pool);
+    void UpdateLevel(FThreadPool* pool);
+    void UpdateNode(uint32_t position);
+
+    // Indexed by node id
+    std::vector<FSlot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> dirtyNodes;
+    bool bLayoutDirty;
+
+    // Indexed by position. Nodes added since the last update are appended
+    // out of order until the next rebuild.
+    std::vector<FLocalTransform> locals;
+    std::vector<FMatrix4> worlds;
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> parents;
+    // Leaves get the position their children would start at, so the children
+    // of the range [a, b) are [firstChildren[a], childEnd of b - 1)
+    std::vector<uint32_t> firstChildren;
+    std::vector<uint32_t> childCounts;
+    // First position of every level and one past the last node
+    std::vector<uint32_t> levelOffsets;
+
+    // Scratch of the update, kept to avoid allocating every frame
+    std::vector<uint32_t> dirtyRoots;
+    std::vector<FRange> level;
+    std::vector<FRange> nextLevel;
+    std::vector<uint32_t> levelPrefix;
+    size_t updatedCount;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+// Precedes every frame in the stream, little endian
+struct FVideoFrameHeader {
+    static constexpr uint32_t Magic = MakeFourCC('R', 'V', 'F', '0');
+
+    uint32_t magic = Magic;
+    // 'NV12' or 'I420'
+    uint32_t fourcc = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t frameIndex = 0;
+    // Capture time since the stream started
+    uint64_t timestampNs = 0;
+    uint64_t payloadSize = 0;
+};
+
+static_assert(sizeof(FVideoFrameHeader) == 40,
+              "The stream header layout is part of the format");
+
+// Raw video frame stream for an external encoder. The destination is a file
+// or named pipe path, "fd:<n>" for an inherited descriptor or
+// "unix:<path>" for a Unix domain socket.
+class FVideoStreamWriter
+{
+  public:
+    explicit FVideoStreamWriter(const std::string& destination);
+    FVideoStreamWriter(const FVideoStreamWriter& other) = delete;
+    ~FVideoStreamWriter();
+
+    void WriteFrame(const FVideoFrameHeader& header, const void* payload);
+
+  private:
+    std::FILE* file;
+};
@@ -11,3 +11,7 @@
 #define GE_VALIDATION_LAYERS BUILD_DEBUG
 
 #define INDEX_NONE -1
+
+#ifndef WITH_ALLOCATION_TRACKING
+#define WITH_ALLOCATION_TRACKING 0
+#endif
@@ -17,6 +17,7 @@ class GameEngine
     void init();
 
     void tick();
+    void benchmark();
     void cleanup();
 
   private:
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Math/Matrix.h"
+#include "Math/Vector.h"
+
+#include <limits>
+
+// Axis aligned bounding box, empty until a point is added
+struct FAabb {
+    FVector3 min = {std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max()};
+    FVector3 max = {std::numeric_limits<float>::lowest(),
+                    std::numeric_limits<float>::lowest(),
+                    std::numeric_limits<float>::lowest()};
+
+    static FAabb FromCenterExtent(const FVector3& center,
+                                  const FVector3& extent)
+    {
+        return {center - extent, center + extent};
+    }
+
+    bool IsEmpty() const
+    {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    FVector3 GetCenter() const { return (min + max) * 0.5f; }
+    // Half the size
+    FVector3 GetExtent() const { return (max - min) * 0.5f; }
+
+    void Add(const FVector3& point)
+    {
+        min = Min(min, point);
+        max = Max(max, point);
+    }
+    void Add(const FAabb& other)
+    {
+        min = Min(min, other.min);
+        max = Max(max, other.max);
+    }
+
+    bool Contains(const FVector3& point) const
+    {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y &&
+               point.y <= max.y && point.z >= min.z && point.z <= max.z;
+    }
+    bool Intersects(const FAabb& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+};
+
+// Box around the transformed box (Arvo, "Transforming Axis-Aligned Bounding
+// Boxes"), empty boxes stay empty
+FAabb Transform(const FMatrix4& matrix, const FAabb& box);
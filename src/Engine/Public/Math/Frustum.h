@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Math/Matrix.h"
+#include "Math/Vector.h"
+
+// Six planes facing inwards, xyz is the unit normal and w the distance. A
+// point p is inside when Dot(xyz, p) + w >= 0 for every plane.
+struct FFrustum {
+    enum EPlane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    FVector4 planes[PlaneCount];
+
+    // The Vulkan clip volume of the matrix, world space planes for a view
+    // projection matrix
+    static FFrustum FromMatrix(const FMatrix4& viewProjection);
+
+    bool IntersectsSphere(const FVector3& center, float radius) const;
+    // Box given by center and half extent
+    bool IntersectsBox(const FVector3& center, const FVector3& extent) const;
+};
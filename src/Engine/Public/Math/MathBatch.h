@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Math/Frustum.h"
+#include "Math/Matrix.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Structure of arrays views, every array holds count floats. Inputs are only
+// read, so the same view can be both input and output.
+struct FPointArrays {
+    float* x;
+    float* y;
+    float* z;
+    size_t count;
+};
+
+// Axis aligned boxes as centers and half extents
+struct FBoundsArrays {
+    float* centerX;
+    float* centerY;
+    float* centerZ;
+    float* extentX;
+    float* extentY;
+    float* extentZ;
+    size_t count;
+};
+
+struct FSphereArrays {
+    float* centerX;
+    float* centerY;
+    float* centerZ;
+    float* radius;
+    size_t count;
+};
+
+enum class EMathBackend {
+    // Picked at compile time with ENGINE_SIMD, see PlatformMarcos.cmake
+    Native,
+    // One element at a time, the reference the SIMD paths are checked against
+    Scalar,
+};
+
+// Transforms of whole arrays, Native processes as many elements per
+// instruction as the backend allows (8 with AVX2, 4 with SSE4 and NEON)
+class FMathBatch
+{
+  public:
+    static const char* GetNativeBackendName();
+    static size_t GetNativeWidth();
+
+    static void TransformPoints(const FMatrix4& matrix,
+                                const FPointArrays& input,
+                                const FPointArrays& output,
+                                EMathBackend backend = EMathBackend::Native);
+
+    // The result boxes enclose the transformed boxes
+    static void TransformBounds(const FMatrix4& matrix,
+                                const FBoundsArrays& input,
+                                const FBoundsArrays& output,
+                                EMathBackend backend = EMathBackend::Native);
+
+    // Radii grow with the largest scale of the matrix
+    static void TransformSpheres(const FMatrix4& matrix,
+                                 const FSphereArrays& input,
+                                 const FSphereArrays& output,
+                                 EMathBackend backend = EMathBackend::Native);
+
+    // Writes firstIndex plus the array index of every element touching the
+    // frustum to visible, which needs room for all of them, and returns how
+    // many were written. The indices come out in increasing order.
+    static size_t CullSpheres(const FFrustum& frustum,
+                              const FSphereArrays& spheres, uint32_t firstIndex,
+                              uint32_t* visible,
+                              EMathBackend backend = EMathBackend::Native);
+    static size_t CullBounds(const FFrustum& frustum,
+                             const FBoundsArrays& bounds, uint32_t firstIndex,
+                             uint32_t* visible,
+                             EMathBackend backend = EMathBackend::Native);
+
+    // output[i] = a[i] * b[i]
+    static void MultiplyMatrices(const FMatrix4* a, const FMatrix4* b,
+                                 FMatrix4* output, size_t count,
+                                 EMathBackend backend = EMathBackend::Native);
+};
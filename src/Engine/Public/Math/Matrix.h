@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Math/Quaternion.h"
+#include "Math/Vector.h"
+
+// Column major like GLSL, m[column][row]. Vectors are columns, so a * b
+// applies b first.
+struct alignas(16) FMatrix4 {
+    float m[4][4] = {};
+
+    static FMatrix4 Identity();
+    // Scale, then rotation, then translation
+    static FMatrix4 FromTransform(const FVector3& translation,
+                                  const FQuaternion& rotation,
+                                  const FVector3& scale);
+    // Right handed view looking down -z
+    static FMatrix4 LookAt(const FVector3& eye, const FVector3& target,
+                           const FVector3& up);
+    // Vulkan clip space, depth from 0 at near to 1 at far and y down
+    static FMatrix4 Perspective(float verticalFov, float aspectRatio,
+                                float nearPlane, float farPlane);
+
+    FVector3 GetColumn(int column) const
+    {
+        return {m[column][0], m[column][1], m[column][2]};
+    }
+    FVector3 GetTranslation() const { return GetColumn(3); }
+};
+
+// SIMD on every backend but scalar
+FMatrix4 operator*(const FMatrix4& a, const FMatrix4& b);
+
+FMatrix4 Transpose(const FMatrix4& matrix);
+// Only for rotation, scale and translation, no projection
+FMatrix4 AffineInverse(const FMatrix4& matrix);
+
+FVector3 TransformPoint(const FMatrix4& matrix, const FVector3& point);
+FVector3 TransformVector(const FMatrix4& matrix, const FVector3& vector);
+FVector4 Transform(const FMatrix4& matrix, const FVector4& vector);
+
+// Largest scale along any axis, scales bounding sphere radii
+float GetMaxScale(const FMatrix4& matrix);
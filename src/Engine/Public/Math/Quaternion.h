@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Math/Vector.h"
+
+// Rotation as a unit quaternion, w is the real part
+struct alignas(16) FQuaternion {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 1.0f;
+
+    static FQuaternion Identity() { return {}; }
+    // The axis has to be normalized, angle in radians
+    static FQuaternion FromAxisAngle(const FVector3& axis, float angle);
+};
+
+// Applies b first, then a
+FQuaternion operator*(const FQuaternion& a, const FQuaternion& b);
+
+FQuaternion Normalize(const FQuaternion& q);
+inline FQuaternion Conjugate(const FQuaternion& q)
+{
+    return {-q.x, -q.y, -q.z, q.w};
+}
+
+FVector3 Rotate(const FQuaternion& q, const FVector3& v);
+
+// Takes the shorter arc, falls back to a normalized lerp when the rotations
+// are nearly the same
+FQuaternion Slerp(const FQuaternion& a, const FQuaternion& b, float t);
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(MATH_SIMD_AVX2) || defined(MATH_SIMD_SSE4)
+#include <immintrin.h>
+#elif defined(MATH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// Lanes of the math backend selected by ENGINE_SIMD in PlatformMarcos.cmake.
+// Kernels are written once against Load, Store, Splat and the operators below
+// and instantiated for the widest lane type, then FFloat1 for the tail.
+
+// One float, the scalar reference
+struct FFloat1 {
+    static constexpr size_t Width = 1;
+    float value;
+
+    static FFloat1 Load(const float* source) { return {*source}; }
+    static FFloat1 Splat(float value) { return {value}; }
+    void Store(float* destination) const { *destination = value; }
+};
+
+inline FFloat1 operator+(FFloat1 a, FFloat1 b) { return {a.value + b.value}; }
+inline FFloat1 operator-(FFloat1 a, FFloat1 b) { return {a.value - b.value}; }
+inline FFloat1 operator*(FFloat1 a, FFloat1 b) { return {a.value * b.value}; }
+// a * b + c
+inline FFloat1 MulAdd(FFloat1 a, FFloat1 b, FFloat1 c)
+{
+    return {a.value * b.value + c.value};
+}
+inline FFloat1 Min(FFloat1 a, FFloat1 b)
+{
+    return {a.value < b.value ? a.value : b.value};
+}
+inline FFloat1 Max(FFloat1 a, FFloat1 b)
+{
+    return {a.value > b.value ? a.value : b.value};
+}
+inline FFloat1 Abs(FFloat1 a) { return {std::abs(a.value)}; }
+// Bit i is set when lane i of a is less or equal to b
+inline uint32_t CompareLessEqual(FFloat1 a, FFloat1 b)
+{
+    return a.value <= b.value ? 1u : 0u;
+}
+
+#if defined(MATH_SIMD_AVX2) || defined(MATH_SIMD_SSE4)
+
+#define MATH_HAS_FLOAT4 1
+
+struct FFloat4 {
+    static constexpr size_t Width = 4;
+    __m128 value;
+
+    static FFloat4 Load(const float* source) { return {_mm_loadu_ps(source)}; }
+    static FFloat4 Splat(float value) { return {_mm_set1_ps(value)}; }
+    void Store(float* destination) const { _mm_storeu_ps(destination, value); }
+};
+
+inline FFloat4 operator+(FFloat4 a, FFloat4 b)
+{
+    return {_mm_add_ps(a.value, b.value)};
+}
+inline FFloat4 operator-(FFloat4 a, FFloat4 b)
+{
+    return {_mm_sub_ps(a.value, b.value)};
+}
+inline FFloat4 operator*(FFloat4 a, FFloat4 b)
+{
+    return {_mm_mul_ps(a.value, b.value)};
+}
+inline FFloat4 MulAdd(FFloat4 a, FFloat4 b, FFloat4 c)
+{
+#if defined(MATH_SIMD_AVX2)
+    return {_mm_fmadd_ps(a.value, b.value, c.value)};
+#else
+    return {_mm_add_ps(_mm_mul_ps(a.value, b.value), c.value)};
+#endif
+}
+inline FFloat4 Min(FFloat4 a, FFloat4 b)
+{
+    return {_mm_min_ps(a.value, b.value)};
+}
+inline FFloat4 Max(FFloat4 a, FFloat4 b)
+{
+    return {_mm_max_ps(a.value, b.value)};
+}
+inline FFloat4 Abs(FFloat4 a)
+{
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.value)};
+}
+inline uint32_t CompareLessEqual(FFloat4 a, FFloat4 b)
+{
+    return static_cast<uint32_t>(
+        _mm_movemask_ps(_mm_cmple_ps(a.value, b.value)));
+}
+
+#elif defined(MATH_SIMD_NEON)
+
+#define MATH_HAS_FLOAT4 1
+
+struct FFloat4 {
+    static constexpr size_t Width = 4;
+    float32x4_t value;
+
+    static FFloat4 Load(const float* source) { return {vld1q_f32(source)}; }
+    static FFloat4 Splat(float value) { return {vdupq_n_f32(value)}; }
+    void Store(float* destination) const { vst1q_f32(destination, value); }
+};
+
+inline FFloat4 operator+(FFloat4 a, FFloat4 b)
+{
+    return {vaddq_f32(a.value, b.value)};
+}
+inline FFloat4 operator-(FFloat4 a, FFloat4 b)
+{
+    return {vsubq_f32(a.value, b.value)};
+}
+inline FFloat4 operator*(FFloat4 a, FFloat4 b)
+{
+    return {vmulq_f32(a.value, b.value)};
+}
+inline FFloat4 MulAdd(FFloat4 a, FFloat4 b, FFloat4 c)
+{
+    return {vfmaq_f32(c.value, a.value, b.value)};
+}
+inline FFloat4 Min(FFloat4 a, FFloat4 b)
+{
+    return {vminq_f32(a.value, b.value)};
+}
+inline FFloat4 Max(FFloat4 a, FFloat4 b)
+{
+    return {vmaxq_f32(a.value, b.value)};
+}
+inline FFloat4 Abs(FFloat4 a) { return {vabsq_f32(a.value)}; }
+inline uint32_t CompareLessEqual(FFloat4 a, FFloat4 b)
+{
+    // Each lane keeps its own bit of the mask, then the lanes are summed
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(vcleq_f32(a.value, b.value), bits));
+}
+
+#endif
+
+#if defined(MATH_SIMD_AVX2)
+
+struct FFloat8 {
+    static constexpr size_t Width = 8;
+    __m256 value;
+
+    static FFloat8 Load(const float* source)
+    {
+        return {_mm256_loadu_ps(source)};
+    }
+    static FFloat8 Splat(float value) { return {_mm256_set1_ps(value)}; }
+    void Store(float* destination) const
+    {
+        _mm256_storeu_ps(destination, value);
+    }
+};
+
+inline FFloat8 operator+(FFloat8 a, FFloat8 b)
+{
+    return {_mm256_add_ps(a.value, b.value)};
+}
+inline FFloat8 operator-(FFloat8 a, FFloat8 b)
+{
+    return {_mm256_sub_ps(a.value, b.value)};
+}
+inline FFloat8 operator*(FFloat8 a, FFloat8 b)
+{
+    return {_mm256_mul_ps(a.value, b.value)};
+}
+inline FFloat8 MulAdd(FFloat8 a, FFloat8 b, FFloat8 c)
+{
+    return {_mm256_fmadd_ps(a.value, b.value, c.value)};
+}
+inline FFloat8 Min(FFloat8 a, FFloat8 b)
+{
+    return {_mm256_min_ps(a.value, b.value)};
+}
+inline FFloat8 Max(FFloat8 a, FFloat8 b)
+{
+    return {_mm256_max_ps(a.value, b.value)};
+}
+inline FFloat8 Abs(FFloat8 a)
+{
+    return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value)};
+}
+inline uint32_t CompareLessEqual(FFloat8 a, FFloat8 b)
+{
+    return static_cast<uint32_t>(
+        _mm256_movemask_ps(_mm256_cmp_ps(a.value, b.value, _CMP_LE_OQ)));
+}
+
+using FFloatNative = FFloat8;
+#define MATH_SIMD_NAME "AVX2"
+
+#elif defined(MATH_HAS_FLOAT4)
+
+using FFloatNative = FFloat4;
+#if defined(MATH_SIMD_NEON)
+#define MATH_SIMD_NAME "NEON"
+#else
+#define MATH_SIMD_NAME "SSE4"
+#endif
+
+#else
+
+using FFloatNative = FFloat1;
+#define MATH_SIMD_NAME "Scalar"
+
+#endif
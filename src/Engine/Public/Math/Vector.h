@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// Single vectors stay scalar, compilers vectorize them as well as hand written
+// SIMD would. Arrays go through FMathBatch.
+struct FVector3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+
+    float& operator[](int axis) { return (&x)[axis]; }
+    float operator[](int axis) const { return (&x)[axis]; }
+
+    FVector3& operator+=(const FVector3& other)
+    {
+        x += other.x;
+        y += other.y;
+        z += other.z;
+        return *this;
+    }
+    FVector3& operator-=(const FVector3& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        z -= other.z;
+        return *this;
+    }
+    FVector3& operator*=(float scale)
+    {
+        x *= scale;
+        y *= scale;
+        z *= scale;
+        return *this;
+    }
+};
+
+inline FVector3 operator+(FVector3 a, const FVector3& b) { return a += b; }
+inline FVector3 operator-(FVector3 a, const FVector3& b) { return a -= b; }
+inline FVector3 operator-(const FVector3& a) { return {-a.x, -a.y, -a.z}; }
+inline FVector3 operator*(FVector3 a, float scale) { return a *= scale; }
+inline FVector3 operator*(float scale, FVector3 a) { return a *= scale; }
+inline FVector3 operator*(const FVector3& a, const FVector3& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+inline float Dot(const FVector3& a, const FVector3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline FVector3 Cross(const FVector3& a, const FVector3& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x};
+}
+
+inline float Length(const FVector3& v) { return std::sqrt(Dot(v, v)); }
+
+// Zero vectors stay zero
+inline FVector3 Normalize(const FVector3& v)
+{
+    const float length = Length(v);
+    return length > 0.0f ? v * (1.0f / length) : FVector3{};
+}
+
+inline FVector3 Min(const FVector3& a, const FVector3& b)
+{
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+}
+
+inline FVector3 Max(const FVector3& a, const FVector3& b)
+{
+    return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+}
+
+inline FVector3 Abs(const FVector3& v)
+{
+    return {std::abs(v.x), std::abs(v.y), std::abs(v.z)};
+}
+
+inline FVector3 Lerp(const FVector3& a, const FVector3& b, float t)
+{
+    return a + (b - a) * t;
+}
+
+struct alignas(16) FVector4 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 0.0f;
+
+    float& operator[](int axis) { return (&x)[axis]; }
+    float operator[](int axis) const { return (&x)[axis]; }
+
+    FVector3 XYZ() const { return {x, y, z}; }
+};
+
+inline float Dot(const FVector4& a, const FVector4& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-instance vertex stream consumed by the triangle pipeline
+struct FInstanceData {
+    float offset[2];
+    float scale;
+    float padding;
+};
+
+struct FInstanceRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
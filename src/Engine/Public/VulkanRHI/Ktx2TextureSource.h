@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/BlockDecoder.h"
+#include "Core/FileManager.h"
+#include "VulkanRHI/TextureSource.h"
+
+#include <optional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class FVulkanGpu;
+
+enum class EKtx2Supercompression : uint32_t {
+    None = 0,
+    BasisLZ = 1,
+    Zstandard = 2,
+    Zlib = 3,
+};
+
+// 2D texture in a memory mapped KTX2 container. Blocks in a format the GPU
+// samples are uploaded as stored, straight from the mapping. Zlib and
+// Zstandard supercompression is undone on a worker thread, and BC1 to BC5
+// data the GPU cannot sample is decoded to 8-bit texels as a last resort.
+class FKtx2TextureSource : public FTextureSource
+{
+  public:
+    // Throws when the file is not a 2D KTX2 texture that can be uploaded
+    FKtx2TextureSource(const std::string& filename, const FVulkanGpu& gpu);
+
+    // Format the mips are uploaded in
+    vk::Format GetFormat() const override { return uploadFormat; }
+    vk::Extent2D GetExtent() const override { return extent; }
+    uint32_t GetMipCount() const override
+    {
+        return static_cast<uint32_t>(levels.size());
+    }
+
+    size_t GetMipSize(uint32_t mip) const override;
+    void ReadMip(uint32_t mip,
+                 FileManager::FReadCallback onComplete) const override;
+
+    vk::Format GetStoredFormat() const { return storedFormat; }
+    EKtx2Supercompression GetSupercompression() const
+    {
+        return supercompression;
+    }
+    bool IsDecodedOnCpu() const { return fallback.has_value(); }
+
+    // True if the GPU can sample and copy images of the format
+    static bool IsFormatSupported(const FVulkanGpu& gpu, vk::Format format);
+
+  private:
+    struct FLevel {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    std::string filename;
+    FileBlob file;
+
+    vk::Format storedFormat;
+    vk::Format uploadFormat;
+    vk::Extent2D extent;
+    EKtx2Supercompression supercompression;
+    std::optional<EBlockFormat> fallback;
+
+    std::vector<FLevel> levels;
+};
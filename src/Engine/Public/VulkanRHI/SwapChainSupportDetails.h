@@ -12,11 +12,13 @@ struct FSwapChainSupportDetails {
     std::vector<vk::SurfaceFormatKHR> formats;
     std::vector<vk::PresentModeKHR> presentModes;
 
-    vk::PhysicalDevice device;
     vk::SurfaceKHR surface;
 
   public:
-    FSwapChainSupportDetails(vk::PhysicalDevice device, vk::SurfaceKHR surface);
+    FSwapChainSupportDetails(vk::SurfaceKHR surface,
+                             const vk::SurfaceCapabilitiesKHR& capabilities,
+                             const std::vector<vk::SurfaceFormatKHR>& formats,
+                             const std::vector<vk::PresentModeKHR>& presentModes);
 
     vk::SurfaceKHR GetSurface() const { return surface; }
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Core/FileManager.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Texel block of a format, 1x1 for uncompressed formats
+struct FTextureBlockInfo {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t bytes = 0;
+};
+
+// A texture with a full mip chain whose mips are read on demand by
+// FVulkanTextureStreamer
+class FTextureSource
+{
+  public:
+    virtual ~FTextureSource() = default;
+
+    virtual vk::Format GetFormat() const = 0;
+    // Size of mip 0
+    virtual vk::Extent2D GetExtent() const = 0;
+    virtual uint32_t GetMipCount() const = 0;
+
+    // Bytes of one tightly packed mip, as uploaded to the image
+    virtual size_t GetMipSize(uint32_t mip) const = 0;
+
+    // Reads one mip. onComplete may run on any thread and after the source
+    // is gone, so the read must not reference it.
+    virtual void ReadMip(uint32_t mip,
+                         FileManager::FReadCallback onComplete) const = 0;
+
+    vk::Extent2D GetMipExtent(uint32_t mip) const;
+
+    // Mips down to 1x1
+    static uint32_t GetFullMipCount(vk::Extent2D extent);
+
+    // Throws for formats the streamer cannot size
+    static FTextureBlockInfo GetBlockInfo(vk::Format format);
+    static size_t GetImageSize(vk::Format format, vk::Extent2D extent);
+};
+
+// Mips stored back to back from mip 0 in one file without a header
+class FRawTextureSource : public FTextureSource
+{
+  public:
+    FRawTextureSource(const std::string& filename, vk::Format format,
+                      vk::Extent2D extent, uint32_t mipCount);
+
+    vk::Format GetFormat() const override { return format; }
+    vk::Extent2D GetExtent() const override { return extent; }
+    uint32_t GetMipCount() const override { return mipCount; }
+
+    size_t GetMipSize(uint32_t mip) const override;
+    void ReadMip(uint32_t mip,
+                 FileManager::FReadCallback onComplete) const override;
+
+  private:
+    std::string filename;
+    vk::Format format;
+    vk::Extent2D extent;
+    uint32_t mipCount;
+
+    std::vector<uint64_t> mipOffsets;
+};
+
+// RGBA8 checkerboard generated on a worker thread, each mip gets its own
+// color so the resident level is visible
+class FProceduralTextureSource : public FTextureSource
+{
+  public:
+    FProceduralTextureSource(vk::Extent2D extent, uint32_t seed);
+
+    vk::Format GetFormat() const override
+    {
+        return vk::Format::eR8G8B8A8Unorm;
+    }
+    vk::Extent2D GetExtent() const override { return extent; }
+    uint32_t GetMipCount() const override { return mipCount; }
+
+    size_t GetMipSize(uint32_t mip) const override;
+    void ReadMip(uint32_t mip,
+                 FileManager::FReadCallback onComplete) const override;
+
+  private:
+    vk::Extent2D extent;
+    uint32_t mipCount;
+    uint32_t seed;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+class FVulkanDevice;
+
+class FVulkanBuffer
+{
+  public:
+    FVulkanBuffer(FVulkanDevice* device, vk::DeviceSize size,
+                  vk::BufferUsageFlags usage,
+                  vk::MemoryPropertyFlags properties);
+    FVulkanBuffer(const FVulkanBuffer& other) = delete;
+    ~FVulkanBuffer();
+
+    vk::Buffer GetBuffer() const { return buffer; }
+    vk::DeviceSize GetSize() const { return size; }
+
+    // Persistently maps the buffer, only valid for host visible memory
+    void* Map();
+    void Unmap();
+
+    // Makes device writes visible to the mapping on non coherent memory
+    void Invalidate();
+
+    void Upload(const void* data, vk::DeviceSize dataSize,
+                vk::DeviceSize offset = 0);
+
+  private:
+    FVulkanDevice* device;
+
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    vk::DeviceSize size;
+
+    void* mappedData;
+};
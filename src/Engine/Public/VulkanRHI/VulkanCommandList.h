@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <stdint.h>
+#include <vulkan/vulkan.hpp>
+
+struct FCommandListStats {
+    // Commands recorded into the command buffer, state, draws and passes
+    uint64_t issued = 0;
+    // State commands dropped because they would not change anything
+    uint64_t filtered = 0;
+
+    FCommandListStats& operator+=(const FCommandListStats& other)
+    {
+        issued += other.issued;
+        filtered += other.filtered;
+        return *this;
+    }
+};
+
+// Records into a command buffer and remembers the bound pipelines, descriptor
+// sets, vertex and index buffers, viewport, scissor and push constants, so
+// calls that set what is already set never reach the driver. Bindings
+// survive render pass boundaries like they do in Vulkan.
+//
+// Graphics pipelines are assumed to leave viewport and scissor dynamic, as
+// every pipeline of the device does, so binding one keeps them. Commands
+// recorded straight into GetCommandBuffer() that change state must be
+// followed by InvalidateState().
+class FVulkanCommandList
+{
+  public:
+    static constexpr uint32_t MaxDescriptorSets = 8;
+    static constexpr uint32_t MaxVertexBindings = 16;
+    // The minimum maxPushConstantsSize
+    static constexpr uint32_t MaxPushConstantBytes = 128;
+
+    explicit FVulkanCommandList(vk::CommandBuffer commandBuffer);
+
+    vk::CommandBuffer GetCommandBuffer() const { return commandBuffer; }
+
+    void BeginRenderPass(const vk::RenderPassBeginInfo& info,
+                         vk::SubpassContents contents);
+    void NextSubpass(vk::SubpassContents contents);
+    void EndRenderPass();
+
+    void BindPipeline(vk::PipelineBindPoint bindPoint, vk::Pipeline pipeline);
+    // Sets with dynamic offsets are always bound
+    void BindDescriptorSets(vk::PipelineBindPoint bindPoint,
+                            vk::PipelineLayout layout, uint32_t firstSet,
+                            std::span<const vk::DescriptorSet> sets,
+                            std::span<const uint32_t> dynamicOffsets = {});
+    void BindVertexBuffers(uint32_t firstBinding,
+                           std::span<const vk::Buffer> buffers,
+                           std::span<const vk::DeviceSize> offsets);
+    void BindIndexBuffer(vk::Buffer buffer, vk::DeviceSize offset,
+                         vk::IndexType indexType);
+
+    void SetViewport(const vk::Viewport& viewport);
+    void SetScissor(const vk::Rect2D& scissor);
+
+    void PushConstants(vk::PipelineLayout layout,
+                       vk::ShaderStageFlags stageFlags, uint32_t offset,
+                       uint32_t size, const void* values);
+
+    void Draw(uint32_t vertexCount, uint32_t instanceCount,
+              uint32_t firstVertex, uint32_t firstInstance);
+    void DrawIndexed(uint32_t indexCount, uint32_t instanceCount,
+                     uint32_t firstIndex, int32_t vertexOffset,
+                     uint32_t firstInstance);
+
+    // Forgets all state, the next call of every kind is recorded
+    void InvalidateState();
+
+    const FCommandListStats& GetStats() const { return stats; }
+
+  private:
+    struct FBindPointState {
+        vk::Pipeline pipeline;
+        vk::PipelineLayout descriptorLayout;
+        std::array<vk::DescriptorSet, MaxDescriptorSets> descriptorSets;
+    };
+
+    struct FVertexBinding {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+    };
+
+    FBindPointState& GetBindPoint(vk::PipelineBindPoint bindPoint);
+
+    // Counts the command as issued when it changes something
+    bool Filter(bool bRedundant);
+
+    vk::CommandBuffer commandBuffer;
+
+    std::array<FBindPointState, 2> bindPoints;
+    std::array<FVertexBinding, MaxVertexBindings> vertexBindings;
+
+    vk::Buffer indexBuffer;
+    vk::DeviceSize indexOffset;
+    vk::IndexType indexType;
+
+    bool bViewportSet;
+    vk::Viewport viewport;
+    bool bScissorSet;
+    vk::Rect2D scissor;
+
+    vk::PipelineLayout pushConstantLayout;
+    std::array<uint8_t, MaxPushConstantBytes> pushConstants;
+    // Bytes of pushConstants that hold a recorded value
+    std::array<bool, MaxPushConstantBytes> pushConstantsSet;
+
+    FCommandListStats stats;
+};
@@ -1,16 +1,38 @@
 #pragma once
 
+#include "Core/DrawQueue.h"
+#include "Core/DynamicResolution.h"
+#include "Core/FrustumCuller.h"
+#include "Core/LinearAllocator.h"
+#include "Core/MeshFormat.h"
+#include "Core/MeshLodSelector.h"
+#include "VulkanRHI/InstanceData.h"
 #include "VulkanRHI/QueueFamilyIndices.h"
 #include "VulkanRHI/SwapChainSupportDetails.h"
+#include "VulkanRHI/VulkanCommandList.h"
+#include "VulkanRHI/VulkanFrameReadback.h"
+#include "VulkanRHI/VulkanMemoryBudget.h"
+#include "VulkanRHI/VulkanSpecialization.h"
 #include <vulkan/vulkan.hpp>
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+class FileBlob;
+class FVulkanBuffer;
 class FVulkanGpu;
+class FVulkanGpuTimer;
+class FVulkanMesh;
 class FVulkanShader;
 class FVulkanSwapChain;
+class FVulkanTextureStreamer;
 
 class FVulkanDevice
 {
@@ -20,6 +42,8 @@ class FVulkanDevice
 
     std::shared_ptr<FVulkanShader> CreateShader(const std::string& filename,
                                                 vk::ShaderStageFlagBits stage);
+    std::shared_ptr<FVulkanShader> CreateShader(const FileBlob& blob,
+                                                vk::ShaderStageFlagBits stage);
 
     vk::Queue* GetGraphicsQueue() { return &graphicsQueue; }
     vk::Queue* GetPresentQueue() { return &presentQueue; }
@@ -28,28 +52,151 @@ class FVulkanDevice
 
     FVulkanGpu* GetPhysicalDevice() const { return physicalDevice; }
 
-    FVulkanSwapChain* GetSwapChain() const { return swapChain.get(); }
+    // One swapchain per window, in the order the surfaces were created
+    FVulkanSwapChain* GetSwapChain(size_t index = 0) const
+    {
+        return swapChains[index].get();
+    }
+    size_t GetSwapChainCount() const { return swapChains.size(); }
+
+    // Format of the render pass color attachment shared by all swapchains
+    vk::Format GetSurfaceFormat() const;
+
+    // -msaa=<samples>, clamped to the counts the device supports. Above one
+    // sample the scene is drawn to a transient target resolved in the pass.
+    vk::SampleCountFlagBits GetSampleCount() const { return sampleCount; }
+
+    // -depthformat=<d32|d24s8|d32s8|d16>, falls back to the first supported
+    vk::Format GetDepthFormat() const { return depthFormat; }
+
+    // -depthprepass lays down depth in a first subpass so the color subpass
+    // only shades the visible fragment with an equal depth test. Only with
+    // -mesh, the triangles have no depth.
+    bool IsDepthPrepassEnabled() const { return bDepthPrepass; }
+
+    // -drs renders into a scene target at a scale picked from the GPU time
+    // against -drsbudget=<ms>, then upscales into the swapchain image
+    bool IsDynamicResolutionEnabled() const
+    {
+        return dynamicResolution.has_value();
+    }
+    float GetResolutionScale() const
+    {
+        return dynamicResolution ? dynamicResolution->GetScale() : 1.0f;
+    }
 
     vk::RenderPass GetRenderPass() const { return renderPass; }
 
+    // Returns the triangle pipeline compiled with the given specialization
+    // constants, variants are created once and shared by hash
+    vk::Pipeline
+    GetPipelineVariant(const FVulkanSpecialization& vertexSpecialization,
+                       const FVulkanSpecialization& fragmentSpecialization);
+
+    // Transient allocations that live until the next BeginNextFrame
+    FLinearAllocator& GetFrameAllocator() { return frameAllocator; }
+
     void BeginNextFrame();
 
     vk::CommandBuffer CreateCommandBuffer();
 
+    // Records and submits a command buffer on the graphics queue, then waits
+    // for it. Only for loading, outside of the frame loop.
+    void SubmitImmediate(const std::function<void(vk::CommandBuffer*)>& record);
+
     void Render(vk::CommandBuffer* commandBuffer);
     void Submit(vk::CommandBuffer* commandBuffer);
 
+    // Presents every swapchain with a single vkQueuePresentKHR
+    void Present();
+
+    void DrawInstanced(FVulkanCommandList& commandList, uint32_t vertexCount,
+                       const FInstanceRange& range);
+
+    // Commands recorded by the last Render through FVulkanCommandList, and
+    // the redundant ones it dropped
+    const FCommandListStats& GetLastCommandStats() const
+    {
+        return lastCommandStats;
+    }
+
+    // Replaces the instances drawn by Render, waits for the previous frame
+    // when the instance buffer has to grow
+    void SetInstanceData(std::span<const FInstanceData> instances);
+    uint32_t GetInstanceCount() const { return instanceCount; }
+
+    // Render only draws the instances whose bounding sphere touches the
+    // frustum. Instances are placed in clip space, so the default is the clip
+    // volume.
+    void SetCullingFrustum(const FFrustum& frustum);
+    // Instances that passed culling in the last Render
+    uint32_t GetVisibleInstanceCount() const
+    {
+        return static_cast<uint32_t>(culler.GetVisible().size());
+    }
+
+    // -mesh=<file.mesh> draws every instance as a cooked mesh instead of the
+    // triangle. Each instance gets the coarsest LOD whose error projects
+    // under -lodpixels=<px> (default 1), the instances are grouped by LOD.
+    FVulkanMesh* GetMesh() const { return mesh.get(); }
+
+    // Triangles drawn per scene pass with the current LODs
+    uint64_t GetSceneTriangleCount() const;
+
+    // Index of the frame being recorded, frames start at 1
+    uint64_t GetFrameIndex() const { return frameIndex; }
+    // Every frame up to this index has finished on the GPU
+    uint64_t GetCompletedFrameIndex() const { return completedFrameIndex; }
+
+    // Copies the first swapchain's image out every frame, see
+    // FVulkanFrameReadback
+    FVulkanFrameReadback*
+    EnableReadback(uint32_t slotCount, FVulkanFrameReadback::FConsumer consumer,
+                   EReadbackFormat format = EReadbackFormat::Native);
+    FVulkanFrameReadback* GetReadback() const { return readback.get(); }
+
+    // Texture mips streamed against -texturebudget=<MiB>
+    FVulkanTextureStreamer* GetTextureStreamer() const
+    {
+        return textureStreamer.get();
+    }
+
+    // GPU time of the last finished frame in milliseconds
+    std::optional<double> GetLastGpuTime() const { return lastGpuTime; }
+    // CPU time of the last Render, the command recording without the fence
+    // wait, submit or present, in milliseconds
+    double GetLastRecordTime() const { return lastRecordTime; }
+    // Time the last BeginNextFrame waited for the previous frame
+    double GetLastFenceWaitTime() const { return lastFenceWaitTime; }
+
+    uint32_t FindMemoryType(uint32_t typeBits,
+                            vk::MemoryPropertyFlags properties) const;
+    bool HasMemoryType(uint32_t typeBits,
+                       vk::MemoryPropertyFlags properties) const;
+    // Allocations are tracked against the heap budgets under the category
+    vk::DeviceMemory AllocateMemory(const vk::MemoryRequirements& requirements,
+                                    vk::MemoryPropertyFlags properties,
+                                    EMemoryCategory category);
+    void FreeMemory(vk::DeviceMemory memory);
+
+    const FVulkanMemoryBudget& GetMemoryBudget() const { return memoryBudget; }
+    FVulkanMemoryBudget& GetMemoryBudget() { return memoryBudget; }
+
   protected:
     FVulkanGpu* physicalDevice;
 
     vk::Device device;
 
+    // Before everything that allocates device memory
+    FVulkanMemoryBudget memoryBudget;
+
     vk::Queue graphicsQueue;
     vk::Queue presentQueue;
 
-    std::unique_ptr<FVulkanSwapChain> swapChain;
+    std::vector<std::unique_ptr<FVulkanSwapChain>> swapChains;
 
     std::vector<std::shared_ptr<FVulkanShader>> shaders;
+    std::mutex shaderMutex;
 
     // TODO: Move to separate class
     vk::Viewport viewport;
@@ -58,22 +205,124 @@ class FVulkanDevice
     vk::PipelineLayout pipelineLayout;
     vk::Pipeline graphicsPipeline;
 
+    struct FPipelineVariant {
+        FVulkanSpecialization vertexSpecialization;
+        FVulkanSpecialization fragmentSpecialization;
+        vk::Pipeline pipeline;
+    };
+
+    std::shared_ptr<FVulkanShader> vertexShader;
+    std::shared_ptr<FVulkanShader> fragmentShader;
+
+    std::unordered_map<size_t, std::vector<FPipelineVariant>> pipelineVariants;
+    std::mutex pipelineVariantMutex;
+
     vk::RenderPass renderPass;
+    vk::SampleCountFlagBits sampleCount;
+
+    vk::Format depthFormat;
+    uint32_t depthAttachmentIndex;
+    bool bDepthPrepass;
+    vk::Pipeline depthPrepassPipeline;
+
+    std::optional<FDynamicResolution> dynamicResolution;
+    // Scale the frame in flight was recorded with
+    float renderScale;
+    vk::Filter upscaleFilter;
 
     vk::CommandPool commandPool;
 
     vk::Fence inRenderFence;
 
+    uint64_t frameIndex;
+    uint64_t completedFrameIndex;
+
+    std::unique_ptr<FVulkanFrameReadback> readback;
+
+    std::unique_ptr<FVulkanTextureStreamer> textureStreamer;
+
+    FLinearAllocator frameAllocator;
+
+    std::unique_ptr<FVulkanBuffer> instanceBuffer;
+    uint32_t instanceCount;
+
+    // Instances as set and their bounding spheres as x, y, z and radius
+    // arrays. The buffer holds the visible ones.
+    std::vector<FInstanceData> sceneInstances;
+    std::vector<float> instanceSpheres;
+    FFrustum cullingFrustum;
+    FFrustumCuller culler;
+    bool bVisibilityDirty;
+
+    // Known before the mesh loads, the pipeline is created meanwhile
+    bool bMeshInput;
+    std::unique_ptr<FVulkanMesh> mesh;
+
+    // Indexed like sceneInstances, the buffer holds the visible instances
+    // sorted by LOD
+    std::vector<uint8_t> meshInstanceLods;
+    std::array<FInstanceRange, MaxMeshLodCount> meshLodRanges;
+    std::optional<FMeshLodSelector> meshLodSelector;
+    bool bMeshLodsDirty;
+
+    // One per LOD range, or the triangle range, and pass
+    struct FSceneDraw {
+        uint32_t lod;
+        FInstanceRange range;
+    };
+
+    // Draws of the frame sorted by FDrawKey, the pass is the subpass
+    std::vector<FSceneDraw> sceneDraws;
+    FDrawQueue drawQueue;
+    // Indexed by the pipeline field of the keys
+    std::vector<vk::Pipeline> drawPipelines;
+
+    FCommandListStats lastCommandStats;
+
+    std::unique_ptr<FVulkanGpuTimer> gpuTimer;
+    std::optional<double> lastGpuTime;
+    double lastRecordTime;
+    double lastFenceWaitTime;
+
   private:
     FSwapChainSupportDetails swapChainDetails;
 
   private:
     void InitSwapChain();
     void InitDeviceQueue();
-    void InitPipeline();
+    void InitPipeline(std::shared_ptr<FVulkanShader> vertShader,
+                      std::shared_ptr<FVulkanShader> fragShader);
+    // Depth only pipelines skip the fragment stage and color outputs
+    vk::Pipeline
+    CreateGraphicsPipeline(const FVulkanSpecialization& vertexSpecialization,
+                           const FVulkanSpecialization& fragmentSpecialization,
+                           bool bDepthOnly = false);
+    vk::Format ChooseDepthFormat() const;
+    void InitDynamicResolution();
+
+    void UpscaleSceneTarget(vk::CommandBuffer* commandBuffer,
+                            const FVulkanSwapChain& swapChain,
+                            vk::Extent2D renderExtent);
     void InitRenderPass();
 
     void InitCommandPool();
 
     void InitFences();
+    void InitInstanceData();
+
+    // Culls the instances after they or the frustum changed and writes the
+    // visible ones to the instance buffer, unless UpdateMeshLods does
+    void CullInstances();
+
+    // Selects the LOD of every visible instance for the viewport size, only
+    // rewrites the instance buffer when one changed
+    void UpdateMeshLods();
+
+    uint32_t GetDrawPipelineId(vk::Pipeline pipeline);
+
+    // Queues the scene draws of every subpass and sorts them
+    void BuildDrawQueue();
+    // Walks the sorted queue and only binds when the state bits of the key
+    // change, moving to the next subpass along with the pass bits
+    void RecordDraws(FVulkanCommandList& commandList);
 };
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class FVulkanBuffer;
+class FVulkanDevice;
+class FVulkanShader;
+class FVulkanSwapChain;
+
+enum class EReadbackFormat : uint8_t {
+    // The swapchain's 8-bit RGBA or BGRA pixels
+    Native,
+    // 4:2:0 YUV converted by a compute shader, Y plane then interleaved UV
+    NV12,
+    // 4:2:0 YUV converted by a compute shader, Y, U and V planes
+    I420,
+};
+
+struct FReadbackFrame {
+    uint64_t frameIndex = 0;
+    // Time the frame was recorded, relative to the first readback
+    uint64_t timestampNs = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Bytes per row of the first plane
+    uint32_t rowPitch = 0;
+    EReadbackFormat readbackFormat = EReadbackFormat::Native;
+    vk::Format format = vk::Format::eUndefined;
+    std::span<const uint8_t> pixels;
+};
+
+// Copies the presented image into a ring of host visible buffers. A slot is
+// handed to the consumer thread once the frame that wrote it has retired, a
+// frame is dropped instead of stalling when every slot is still in use.
+class FVulkanFrameReadback
+{
+  public:
+    // Runs on the readback thread, the pixels are only valid during the call
+    using FConsumer = std::function<void(const FReadbackFrame&)>;
+
+    // Throws when the first swapchain cannot be copied from or is not 8 bit
+    // RGBA or BGRA. YUV formats crop the image to a multiple of 8 by 2 pixels
+    FVulkanFrameReadback(FVulkanDevice* device, uint32_t slotCount,
+                         FConsumer consumer,
+                         EReadbackFormat readbackFormat =
+                             EReadbackFormat::Native);
+    FVulkanFrameReadback(const FVulkanFrameReadback& other) = delete;
+    ~FVulkanFrameReadback();
+
+    // Records the copy of the current image, which must be in present layout
+    void Record(vk::CommandBuffer* commandBuffer,
+                const FVulkanSwapChain& swapChain, uint64_t frameIndex);
+
+    // Hands every slot written up to completedFrameIndex to the consumer
+    void Retire(uint64_t completedFrameIndex);
+
+    // Waits until the consumer has processed every retired slot
+    void Flush();
+
+    uint64_t GetCapturedCount() const { return capturedCount; }
+    uint64_t GetDroppedCount() const { return droppedCount; }
+
+    // Writes every frame to <directory>/frame_<index>.<png|raw>
+    static FConsumer CreateFileSink(const std::string& directory,
+                                    const std::string& format);
+
+    // Streams YUV frames to a FVideoStreamWriter destination
+    static FConsumer CreateVideoSink(const std::string& destination);
+
+  private:
+    enum class ESlotState : uint8_t {
+        Free,
+        InFlight,
+        Retired,
+    };
+
+    // Push constants of rgba_to_yuv.comp
+    struct FConversionConstants {
+        uint32_t width;
+        uint32_t height;
+        uint32_t sourceWidth;
+    };
+
+    struct FSlot {
+        std::unique_ptr<FVulkanBuffer> buffer;
+        ESlotState state = ESlotState::Free;
+        uint64_t frameIndex = 0;
+        uint64_t timestampNs = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        vk::Format format = vk::Format::eUndefined;
+
+        // Conversion output binding, rewritten whenever the slot is recorded
+        vk::DescriptorSet descriptorSet;
+    };
+
+    FVulkanDevice* device;
+    vk::MemoryPropertyFlags memoryProperties;
+    FConsumer consumer;
+    EReadbackFormat readbackFormat;
+
+    std::chrono::steady_clock::time_point startTime;
+
+    // Color to YUV conversion, only created for the YUV formats. The image is
+    // copied to a device local buffer the compute shader reads from and
+    // writes straight into the mapped slot buffer.
+    std::shared_ptr<FVulkanShader> conversionShader;
+    vk::DescriptorSetLayout descriptorSetLayout;
+    vk::DescriptorPool descriptorPool;
+    vk::PipelineLayout conversionLayout;
+    vk::Pipeline conversionPipeline;
+    std::unique_ptr<FVulkanBuffer> sourceBuffer;
+
+    // Slot state is shared with the readback thread, buffers are only
+    // (re)created by the render thread while a slot is free
+    std::vector<FSlot> slots;
+    uint32_t nextSlot;
+
+    std::mutex mutex;
+    std::condition_variable retiredCondition;
+    std::condition_variable freeCondition;
+    bool bStopping;
+
+    std::atomic<uint64_t> capturedCount;
+    std::atomic<uint64_t> droppedCount;
+
+    std::thread thread;
+
+  private:
+    void InitConversion();
+
+    vk::DeviceSize GetFrameSize(uint32_t width, uint32_t height) const;
+
+    void CopyImageToBuffer(vk::CommandBuffer* commandBuffer,
+                           const FVulkanSwapChain& swapChain,
+                           vk::Buffer buffer);
+    void RecordCopy(vk::CommandBuffer* commandBuffer,
+                    const FVulkanSwapChain& swapChain, FSlot& slot);
+    void RecordConversion(vk::CommandBuffer* commandBuffer,
+                          const FVulkanSwapChain& swapChain, FSlot& slot);
+
+    void ConsumerLoop();
+};
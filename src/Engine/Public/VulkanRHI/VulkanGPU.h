@@ -1,13 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "VulkanRHI/QueueFamilyIndices.h"
 #include "VulkanRHI/SwapChainSupportDetails.h"
 #include "VulkanRHI/VulkanDevice.h"
+#include "VulkanRHI/VulkanGpuCapabilities.h"
 #include "VulkanRHI/VulkanShader.h"
 
 class FVulkanInstance;
@@ -22,25 +25,73 @@ class FVulkanGpu
 
     void InitLogicalDevice();
 
-    FQueueFamilyIndices GetQueueFamilies() const;
-    const vk::PhysicalDeviceProperties GetProperties() const;
-    const vk::PhysicalDeviceFeatures GetFeatures() const;
+    const FVulkanGpuCapabilities& GetCapabilities() const
+    {
+        return capabilities;
+    }
 
-    std::vector<vk::ExtensionProperties> GetExtensions() const;
+    const FQueueFamilyIndices& GetQueueFamilies() const;
+    const vk::PhysicalDeviceProperties& GetProperties() const;
+    const vk::PhysicalDeviceFeatures& GetFeatures() const;
+    const vk::PhysicalDeviceMemoryProperties& GetMemoryProperties() const;
 
-    FSwapChainSupportDetails GetSwapChainSupportDetails() const;
+    uint32_t GetGraphicsTimestampValidBits() const;
+
+    const std::vector<vk::ExtensionProperties>& GetExtensions() const;
+
+    // VK_EXT_memory_budget was enabled with the logical device
+    bool HasMemoryBudget() const { return bMemoryBudget; }
+    // Current budget and usage of every heap, needs HasMemoryBudget
+    vk::PhysicalDeviceMemoryBudgetPropertiesEXT QueryMemoryBudget() const;
+
+    vk::FormatProperties GetFormatProperties(vk::Format format) const;
+
+    // First candidate usable as an optimally tiled depth attachment
+    std::optional<vk::Format>
+    FindDepthFormat(const std::vector<vk::Format>& candidates) const;
+
+    FSwapChainSupportDetails
+    GetSwapChainSupportDetails(vk::SurfaceKHR surface) const;
+
+    // Surface capabilities change with the window size, everything else in
+    // the snapshot stays valid
+    void InvalidateSurfaceCapabilities(vk::SurfaceKHR surface);
+
+    // The capability snapshot is taken for the first surface, other windows
+    // must be presentable from the same queue family
+    bool SupportsSurface(vk::SurfaceKHR surface) const;
 
     bool IsValid() const;
     uint32_t GetScore() const;
 
+    std::string GetName() const;
+
+    // Case insensitive match against the device UUID or part of the name
+    bool MatchesIdentifier(const std::string& identifier) const;
+
     FVulkanDevice* GetLogicalDevice() const;
 
+    FVulkanInstance* GetInstance() const { return instance; }
+
   protected:
     vk::PhysicalDevice device;
     FVulkanInstance* instance;
 
     std::vector<const char*> layers;
 
+    const FVulkanGpuCapabilities capabilities;
+
+    bool bMemoryBudget;
+
+    struct FSurfaceInfo {
+        std::optional<vk::SurfaceCapabilitiesKHR> capabilities;
+        std::vector<vk::SurfaceFormatKHR> formats;
+        std::vector<vk::PresentModeKHR> presentModes;
+    };
+
+    // Queried lazily for every surface but the first
+    mutable std::unordered_map<VkSurfaceKHR, FSurfaceInfo> surfaceInfos;
+
     std::unique_ptr<FVulkanDevice> logicalDevice;
 
   private:
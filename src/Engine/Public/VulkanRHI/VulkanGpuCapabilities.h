@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include <optional>
+
+#include "VulkanRHI/QueueFamilyIndices.h"
+
+// Immutable snapshot of everything queried from a physical device, captured
+// once so device and swapchain creation do not go back to the driver
+struct FVulkanGpuCapabilities {
+    vk::PhysicalDeviceProperties properties;
+    vk::PhysicalDeviceFeatures features;
+    vk::PhysicalDeviceMemoryProperties memoryProperties;
+
+    // Only available on Vulkan 1.1 devices
+    std::optional<std::array<uint8_t, VK_UUID_SIZE>> deviceUUID;
+
+    std::vector<vk::ExtensionProperties> extensions;
+
+    std::vector<vk::QueueFamilyProperties> queueFamilies;
+    // Indexed by queue family, for the surface the snapshot was taken with
+    std::vector<bool> presentSupport;
+    FQueueFamilyIndices queueFamilyIndices;
+
+    std::vector<vk::SurfaceFormatKHR> surfaceFormats;
+    std::vector<vk::PresentModeKHR> presentModes;
+
+    static FVulkanGpuCapabilities Query(vk::PhysicalDevice device,
+                                        vk::SurfaceKHR surface);
+
+    bool HasExtension(const char* name) const;
+
+    // Formatted as xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, empty if unknown
+    std::string GetUUIDString() const;
+
+    vk::DeviceSize GetDeviceLocalMemorySize() const;
+
+    // Highest sample count usable for both color and depth framebuffer
+    // attachments that does not exceed the requested count
+    vk::SampleCountFlagBits GetSampleCount(uint32_t requested) const;
+
+    // Transfer family without graphics or compute, backed by a copy engine
+    bool HasDedicatedTransferQueue() const;
+    // Compute family without graphics
+    bool HasAsyncComputeQueue() const;
+};
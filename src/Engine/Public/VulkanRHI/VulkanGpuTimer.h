@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <vulkan/vulkan.hpp>
+
+class FVulkanDevice;
+
+// Measures GPU time between two timestamps written into a command buffer
+class FVulkanGpuTimer
+{
+  public:
+    FVulkanGpuTimer(FVulkanDevice* device);
+    FVulkanGpuTimer(const FVulkanGpuTimer& other) = delete;
+    ~FVulkanGpuTimer();
+
+    bool IsSupported() const { return bSupported; }
+
+    // Must be recorded outside of a render pass
+    void Begin(vk::CommandBuffer* commandBuffer);
+    void End(vk::CommandBuffer* commandBuffer);
+
+    // Reads back the last recorded interval, the command buffer must have
+    // finished executing
+    std::optional<double> Resolve();
+
+  private:
+    FVulkanDevice* device;
+
+    vk::QueryPool queryPool;
+
+    double timestampPeriod;
+    uint64_t timestampMask;
+
+    bool bSupported;
+    bool bPending;
+};
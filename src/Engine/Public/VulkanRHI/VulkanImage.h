@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+class FVulkanDevice;
+
+// 2D render target with a single mip and layer, and its view
+class FVulkanImage
+{
+  public:
+    // Transient attachments use lazily allocated memory when the device has
+    // it, on tile based GPUs they then never get backing memory
+    FVulkanImage(FVulkanDevice* device, vk::Extent2D extent, vk::Format format,
+                 vk::ImageUsageFlags usage,
+                 vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1);
+    FVulkanImage(const FVulkanImage& other) = delete;
+    ~FVulkanImage();
+
+    vk::Image GetImage() const { return image; }
+    vk::ImageView GetView() const { return view; }
+    vk::Format GetFormat() const { return format; }
+    vk::Extent2D GetExtent() const { return extent; }
+    vk::SampleCountFlagBits GetSamples() const { return samples; }
+
+    bool IsLazilyAllocated() const { return bLazilyAllocated; }
+
+    static vk::ImageAspectFlags GetAspectMask(vk::Format format);
+
+  private:
+    FVulkanDevice* device;
+
+    vk::Image image;
+    vk::ImageView view;
+    vk::DeviceMemory memory;
+
+    vk::Extent2D extent;
+    vk::Format format;
+    vk::SampleCountFlagBits samples;
+
+    bool bLazilyAllocated;
+};
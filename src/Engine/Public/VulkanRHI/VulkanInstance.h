@@ -12,21 +12,30 @@ class FVulkanRHI;
 class FVulkanInstance
 {
   public:
-    FVulkanInstance(GLFWwindow* window);
+    FVulkanInstance();
     ~FVulkanInstance();
 
     static std::vector<const char*> validationLayers;
 
   public:
+    // Startup steps, run in this order by FVulkanRHI::Init. CreateInstance
+    // does not depend on the window and can run while it is being created.
+    // CreateSurface is called once per window, the first surface is the one
+    // the GPU is selected for.
+    void CreateInstance();
+    void CreateSurface(GLFWwindow* window);
+    void SelectGPU();
+
     std::vector<std::unique_ptr<FVulkanGpu>> GetGPUs();
 
     FVulkanGpu* GetPhysicalDevice() const { return device.get(); }
 
-    vk::SurfaceKHR GetSurface() const { return surface; }
+    vk::SurfaceKHR GetSurface() const { return surfaces.front(); }
+    const std::vector<vk::SurfaceKHR>& GetSurfaces() const { return surfaces; }
 
   protected:
     vk::Instance instance;
-    vk::SurfaceKHR surface;
+    std::vector<vk::SurfaceKHR> surfaces;
     std::unique_ptr<FVulkanGpu> device;
 
     std::vector<const char*> enabledLayers;
@@ -34,8 +43,4 @@ class FVulkanInstance
 
   private:
     bool SupportValidationLayer() const;
-
-    void SelectGPU();
-    void CreateInstance();
-    void CreateSurface(GLFWwindow* window);
 };
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class FVulkanGpu;
+
+enum class EMemoryCategory : uint8_t {
+    Buffer,
+    Image,
+    // Host visible buffers only read by transfers
+    Staging,
+    // Render targets and depth buffers
+    Attachment,
+    Count,
+};
+
+const char* GetMemoryCategoryName(EMemoryCategory category);
+
+struct FMemoryHeapBudget {
+    vk::DeviceSize size = 0;
+    bool bDeviceLocal = false;
+
+    // What the process may use and uses, as reported by VK_EXT_memory_budget
+    // at the last query and adjusted by what was allocated since. Without
+    // the extension the budget is 80% of the heap and the usage is ours.
+    vk::DeviceSize budget = 0;
+    vk::DeviceSize usage = 0;
+
+    // Device memory allocated through FVulkanDevice::AllocateMemory
+    vk::DeviceSize allocated = 0;
+    vk::DeviceSize peakAllocated = 0;
+    std::array<vk::DeviceSize, static_cast<size_t>(EMemoryCategory::Count)>
+        categories = {};
+
+    bool bPressure = false;
+};
+
+// Tracks the device memory allocations per heap and category and compares
+// the heap usage against the budget of the driver. The driver is queried
+// every -memoryinterval=<frames> (default 30) frames.
+//
+// A heap is under pressure once its usage passes -memorypressure=<percent>
+// (default 90) of the budget, until it drops 5% under it again. Callbacks
+// run on both transitions so streaming can stop growing before allocations
+// start failing.
+class FVulkanMemoryBudget
+{
+  public:
+    using FPressureCallback =
+        std::function<void(uint32_t heapIndex, bool bPressure)>;
+
+    explicit FVulkanMemoryBudget(FVulkanGpu* gpu);
+    FVulkanMemoryBudget(const FVulkanMemoryBudget& other) = delete;
+
+    // Thread safe
+    void OnAllocate(vk::DeviceMemory memory, uint32_t memoryTypeIndex,
+                    vk::DeviceSize size, EMemoryCategory category);
+    void OnFree(vk::DeviceMemory memory);
+
+    // Called once per frame, queries the driver when the interval is up and
+    // runs the callbacks of heaps whose pressure changed
+    void Update(uint64_t frameIndex);
+
+    void AddPressureCallback(FPressureCallback callback);
+
+    // Copy of every heap, the counters keep changing on other threads
+    std::vector<FMemoryHeapBudget> GetHeaps() const;
+    // Whether any heap with all of the flags is under pressure
+    bool IsUnderPressure(vk::MemoryHeapFlags flags) const;
+
+    // Budgets come from VK_EXT_memory_budget, not from the heap sizes
+    bool HasDriverBudget() const { return bDriverBudget; }
+
+    // One line per heap: usage, budget and the allocations per category
+    std::string Format(uint32_t heapIndex) const;
+
+  private:
+    struct FAllocation {
+        uint32_t heapIndex;
+        vk::DeviceSize size;
+        EMemoryCategory category;
+    };
+
+    void QueryBudget();
+
+    FVulkanGpu* gpu;
+    bool bDriverBudget;
+    uint32_t queryInterval;
+    double pressureThreshold;
+    bool bLog;
+
+    uint64_t lastQueryFrame;
+
+    // Indexed by memory type
+    std::vector<uint32_t> typeHeaps;
+
+    mutable std::mutex mutex;
+    std::vector<FMemoryHeapBudget> heaps;
+    // Driver usage minus our allocations at the last query, the part of the
+    // usage we do not track
+    std::vector<vk::DeviceSize> untrackedUsage;
+    std::unordered_map<VkDeviceMemory, FAllocation> allocations;
+
+    std::vector<FPressureCallback> callbacks;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core/MeshFormat.h"
+#include "VulkanRHI/InstanceData.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class FVulkanBuffer;
+class FVulkanCommandList;
+class FVulkanDevice;
+
+// Push constants of mesh.vert, positions decode as unorm * scale + bias
+struct FMeshConstants {
+    float positionScale[4];
+    float positionBias[4];
+};
+
+// Mesh cooked by the MeshCooker tool in device local buffers. The file is
+// memory mapped and its vertex and index sections are copied to the GPU as
+// stored, nothing is parsed on load.
+class FVulkanMesh
+{
+  public:
+    // Uploads with a blocking submit
+    FVulkanMesh(FVulkanDevice* device, const std::string& filename);
+    FVulkanMesh(const FVulkanMesh& other) = delete;
+    ~FVulkanMesh();
+
+    const FMeshFileHeader& GetHeader() const { return header; }
+    const std::vector<FMeshLod>& GetLods() const { return lods; }
+
+    // Object space radius of the sphere around the bounds
+    float GetBoundingRadius() const;
+    // Decodes positions into the unit sphere around the bounds
+    FMeshConstants GetNormalizedConstants() const;
+
+    // Vertices go to binding 0
+    void Bind(FVulkanCommandList& commandList) const;
+    void DrawInstanced(FVulkanCommandList& commandList, uint32_t lod,
+                       const FInstanceRange& range) const;
+
+  private:
+    FVulkanDevice* device;
+
+    FMeshFileHeader header;
+    std::vector<FMeshLod> lods;
+
+    std::unique_ptr<FVulkanBuffer> vertexBuffer;
+    std::unique_ptr<FVulkanBuffer> indexBuffer;
+    vk::IndexType indexType;
+};
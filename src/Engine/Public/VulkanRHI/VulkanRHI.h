@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -17,6 +18,12 @@ class FVulkanRHI
 
     void Render();
 
+    // Returns false once any window has been asked to close
+    bool PollEvents();
+    void Draw();
+
+    void WaitIdle();
+
     FVulkanInstance* GetInstance() const;
 
     static std::vector<vk::ExtensionProperties> GetAvailableExtensions();
@@ -24,15 +31,18 @@ class FVulkanRHI
 
   private:
     std::unique_ptr<FVulkanInstance> Instance;
-    GLFWwindow* window;
+
+    // One swapchain is created per window, -windows=<count>
+    std::vector<GLFWwindow*> windows;
 
     // TODO: refactor this
     std::shared_ptr<vk::CommandBuffer> commandBuffer;
 
-  private:
-    void CreateWindow();
+    std::chrono::steady_clock::time_point initStartTime;
+    bool bFirstFrameReported;
 
-    void Draw();
+  private:
+    void CreateWindows();
 
     static void OnFramebufferResize(GLFWwindow* window, int width, int height);
 };
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Core/FileManager.h"
+#include "VulkanRHI/VulkanSpecialization.h"
 #include <memory>
+#include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vulkan/vulkan.hpp>
 
 class FVulkanDevice;
@@ -14,7 +17,20 @@ class FVulkanShader
                   vk::ShaderStageFlagBits stage, const std::string& entryPoint);
     ~FVulkanShader();
 
-    vk::PipelineShaderStageCreateInfo CreatePipelineStage() const;
+    // The specialization must outlive the returned stage
+    vk::PipelineShaderStageCreateInfo CreatePipelineStage(
+        const FVulkanSpecialization* specialization = nullptr) const;
+
+    // Names a constant_id of the shader so variants can be built by name
+    void DeclareConstant(const std::string& name, uint32_t constantId);
+    uint32_t GetConstantId(const std::string& name) const;
+
+    template <typename T>
+    void Specialize(FVulkanSpecialization& specialization,
+                    const std::string& name, const T& value) const
+    {
+        specialization.Set(GetConstantId(name), value);
+    }
 
   private:
     FVulkanDevice* device;
@@ -22,4 +38,6 @@ class FVulkanShader
 
     vk::ShaderStageFlagBits stage;
     std::string entryPoint;
+
+    std::unordered_map<std::string, uint32_t> constants;
 };
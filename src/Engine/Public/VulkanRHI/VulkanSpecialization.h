@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstring>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+// Specialization constant values for one shader stage. Entries are kept
+// sorted by constant id so equal sets hash equally regardless of the order
+// they were set in.
+class FVulkanSpecialization
+{
+  public:
+    FVulkanSpecialization() = default;
+    FVulkanSpecialization(const FVulkanSpecialization& other);
+    FVulkanSpecialization& operator=(const FVulkanSpecialization& other);
+
+    // Only 32-bit scalars are supported, bool is stored as VkBool32
+    template <typename T>
+    FVulkanSpecialization& Set(uint32_t constantId, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            const VkBool32 boolValue = value ? VK_TRUE : VK_FALSE;
+            SetRaw(constantId, &boolValue);
+        } else {
+            static_assert(sizeof(T) == 4 && std::is_trivially_copyable_v<T>,
+                          "Specialization constants must be 32-bit scalars");
+            SetRaw(constantId, &value);
+        }
+        return *this;
+    }
+
+    bool IsEmpty() const { return entries.empty(); }
+
+    // Valid until this object is modified or destroyed, nullptr when empty
+    const vk::SpecializationInfo* GetInfo() const;
+
+    size_t GetHash() const;
+
+    bool operator==(const FVulkanSpecialization& other) const;
+
+  private:
+    std::vector<vk::SpecializationMapEntry> entries;
+    std::vector<uint8_t> data;
+
+    mutable vk::SpecializationInfo info;
+
+    void SetRaw(uint32_t constantId, const void* value);
+};
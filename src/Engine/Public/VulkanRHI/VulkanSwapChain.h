@@ -6,18 +6,31 @@
 #include <vector>
 
 class FVulkanDevice;
+class FVulkanImage;
 
 class FVulkanSwapChain
 {
   public:
-    FVulkanSwapChain(FVulkanDevice* device);
+    FVulkanSwapChain(FVulkanDevice* device, vk::SurfaceKHR surface);
     FVulkanSwapChain(const FVulkanSwapChain& other) = delete;
     ~FVulkanSwapChain();
 
     vk::Format GetFormat() const { return ImageFormat; }
     vk::Extent2D GetExtent() const { return Extent; }
 
+    vk::SwapchainKHR GetHandle() const { return swapChain; }
+    vk::SurfaceKHR GetSurface() const { return surface; }
+
     vk::Framebuffer GetFrameBuffer() const;
+    vk::Image GetImage() const;
+    FVulkanImage* GetSceneTarget() const { return sceneTarget.get(); }
+
+    // Images can be copied from when the surface allows transfer usage
+    bool SupportsReadback() const
+    {
+        return static_cast<bool>(ImageUsage &
+                                 vk::ImageUsageFlagBits::eTransferSrc);
+    }
 
     void AcquireNextImage();
     uint32_t GetCurrentImage() const { return CurrentIndex; };
@@ -32,7 +45,8 @@ class FVulkanSwapChain
         return renderFinishedSemaphore;
     }
 
-    void Present();
+    // Called with this swapchain's entry of the batched present results
+    void OnPresentResult(vk::Result result);
 
     void Recreate();
 
@@ -41,14 +55,23 @@ class FVulkanSwapChain
   protected:
     FVulkanDevice* logicalDevice;
 
+    vk::SurfaceKHR surface;
     vk::SwapchainKHR swapChain;
     std::vector<vk::Image> Images;
     std::vector<vk::ImageView> ImageViews;
     vk::Format ImageFormat;
     vk::Extent2D Extent;
+    vk::ImageUsageFlags ImageUsage;
 
     std::vector<vk::Framebuffer> frameBuffers;
 
+    // Multisampled target resolved into the swapchain image, shared by all
+    // framebuffers since only one frame is in flight
+    std::unique_ptr<FVulkanImage> colorTarget;
+    std::unique_ptr<FVulkanImage> depthTarget;
+    // Scene color with dynamic resolution, blitted to the swapchain image
+    std::unique_ptr<FVulkanImage> sceneTarget;
+
     int32_t CurrentIndex;
 
     bool bSwapchainNeedsResize;
@@ -60,6 +83,7 @@ class FVulkanSwapChain
   private:
     void CreateSwapChain();
     void CreateImageViews();
+    void CreateRenderTargets();
     void CreateFrameBuffers();
     void CreateSyncObjects();
 
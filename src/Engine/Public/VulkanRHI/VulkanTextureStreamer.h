@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Core/FileManager.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class FTextureSource;
+class FVulkanBuffer;
+class FVulkanDevice;
+
+// Index of a texture in its FVulkanTextureStreamer, handles are not reused
+using FTextureHandle = uint32_t;
+
+struct FTextureStreamingStats {
+    uint32_t textureCount = 0;
+    // Mip data the budget applies to, including mips being read
+    vk::DeviceSize committedBytes = 0;
+    // Device memory of every texture image, including images kept alive
+    // until the frame that last used them retires
+    vk::DeviceSize residentBytes = 0;
+    vk::DeviceSize peakResidentBytes = 0;
+    vk::DeviceSize budgetBytes = 0;
+    uint32_t pendingReads = 0;
+    uint64_t streamedMips = 0;
+    uint64_t evictedMips = 0;
+    // Textures drawn larger than their resident mip
+    uint32_t starvedTextures = 0;
+};
+
+// Streams texture mips in and out against a device memory budget. Every
+// texture keeps the mips of 64 pixels and below resident, larger mips are read
+// one at a time when the on screen size asks for them. When the budget is
+// full, mips that are no longer drawn at their size are dropped, least
+// recently requested first. Mips still in use are never dropped for another
+// texture, so a full budget stops streaming instead of thrashing.
+//
+// Without sparse residency every mip change recreates the image with the new
+// mip range and copies the mips both images share on the GPU.
+class FVulkanTextureStreamer
+{
+  public:
+    FVulkanTextureStreamer(FVulkanDevice* device, vk::DeviceSize budgetBytes,
+                           uint32_t maxPendingReads);
+    FVulkanTextureStreamer(const FVulkanTextureStreamer& other) = delete;
+    // The device must be idle
+    ~FVulkanTextureStreamer();
+
+    // Starts reading the mip tail, the texture has no view until it arrives.
+    // Tails are always loaded, even past the budget.
+    FTextureHandle AddTexture(std::unique_ptr<FTextureSource> source);
+    void RemoveTexture(FTextureHandle texture);
+
+    // Size in pixels the texture covers on screen this frame, the largest
+    // request of the frame wins
+    void RequestScreenSize(FTextureHandle texture, float pixels);
+
+    // Frees what the retired frames used, then picks the mips to read and to
+    // drop from the requests made since the previous call
+    void Retire(uint64_t completedFrameIndex);
+
+    // While set no mips are read beyond the tails, for when the device heap
+    // is close to its budget whatever the streaming budget says
+    void SetMemoryPressure(bool bPressure);
+
+    // Records the uploads of finished reads and the image changes, outside of
+    // a render pass
+    void Record(vk::CommandBuffer* commandBuffer, uint64_t frameIndex);
+
+    // Sampled in ShaderReadOnlyOptimal layout, its mip 0 is the resident mip.
+    // Null until the tail is resident. Changes whenever mips stream in or out.
+    vk::ImageView GetView(FTextureHandle texture) const;
+
+    // Mip of the source the view starts at, the mip count if none is resident
+    uint32_t GetResidentMip(FTextureHandle texture) const;
+    // Mip the last requests asked for
+    uint32_t GetWantedMip(FTextureHandle texture) const;
+
+    const FTextureStreamingStats& GetStats() const { return stats; }
+
+  private:
+    struct FTexture {
+        std::unique_ptr<FTextureSource> source;
+
+        // Holds mips [residentMip, mipCount) of the source
+        vk::Image image;
+        vk::ImageView view;
+        vk::DeviceMemory memory;
+        vk::DeviceSize memorySize = 0;
+
+        uint32_t mipCount = 0;
+        uint32_t residentMip = 0;
+        // Mips from here on are never dropped
+        uint32_t tailMip = 0;
+        // The image is recreated with this mip once its reads are done. The
+        // budget is committed for [targetMip, mipCount).
+        uint32_t targetMip = 0;
+        uint32_t wantedMip = 0;
+
+        float screenSize = 0.0f;
+        uint64_t lastRequest = 0;
+
+        // Reads of mips [targetMip, residentMip) still in flight
+        uint32_t pendingReads = 0;
+        std::vector<std::optional<FileBlob>> loadedMips;
+        bool bFailed = false;
+    };
+
+    struct FCompletedRead {
+        FTextureHandle texture;
+        uint32_t mip;
+        std::optional<FileBlob> blob;
+    };
+
+    // Kept alive until the frame that last used it retires
+    struct FRetiredResource {
+        uint64_t frameIndex = 0;
+        vk::Image image;
+        vk::ImageView view;
+        vk::DeviceMemory memory;
+        vk::DeviceSize memorySize = 0;
+        std::unique_ptr<FVulkanBuffer> stagingBuffer;
+    };
+
+    FVulkanDevice* device;
+    vk::DeviceSize budgetBytes;
+    uint32_t maxPendingReads;
+
+    std::vector<FTexture> textures;
+    std::vector<FRetiredResource> retired;
+
+    // Counts Retire calls, requests made in between share a value
+    uint64_t requestIndex;
+    uint64_t lastRecordedFrame;
+    bool bMemoryPressure;
+
+    // Filled by the read callbacks on worker threads
+    std::mutex completedMutex;
+    std::vector<FCompletedRead> completedReads;
+    std::vector<FCompletedRead> drainedReads;
+    std::atomic<uint32_t> outstandingReads;
+
+    FTextureStreamingStats stats;
+
+  private:
+    vk::DeviceSize GetMipRangeSize(const FTexture& texture,
+                                   uint32_t firstMip) const;
+    uint32_t GetMipForScreenSize(const FTexture& texture) const;
+
+    void StartReads(FTextureHandle handle, uint32_t firstMip);
+    void DrainCompletedReads();
+
+    // Drops one mip of the least recently requested texture that is resident
+    // above what it asks for, false if there is none
+    bool EvictOneMip(FTextureHandle requester);
+
+    void RecreateImage(vk::CommandBuffer* commandBuffer, FTexture& texture,
+                       uint64_t frameIndex);
+    void RetireImage(FTexture& texture, uint64_t frameIndex,
+                     std::unique_ptr<FVulkanBuffer> stagingBuffer);
+    void DestroyResource(FRetiredResource& resource);
+};
@@ -0,0 +1,665 @@
+#include "GltfImporter.h"
+
+#include "Json.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t GlbMagic = 0x46546c67;       // "glTF"
+constexpr uint32_t GlbJsonChunk = 0x4e4f534a;   // "JSON"
+constexpr uint32_t GlbBinaryChunk = 0x004e4942; // "BIN\0"
+
+constexpr uint32_t ComponentByte = 5120;
+constexpr uint32_t ComponentUnsignedByte = 5121;
+constexpr uint32_t ComponentShort = 5122;
+constexpr uint32_t ComponentUnsignedShort = 5123;
+constexpr uint32_t ComponentUnsignedInt = 5125;
+constexpr uint32_t ComponentFloat = 5126;
+
+constexpr uint32_t ModeTriangles = 4;
+
+// glTF forbids cycles, the limit only guards against malformed files
+constexpr uint32_t MaxNodeDepth = 64;
+
+// Column major like glTF
+using FMatrix = std::array<float, 16>;
+
+constexpr FMatrix Identity = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                              0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+FMatrix Multiply(const FMatrix& a, const FMatrix& b)
+{
+    FMatrix result = {};
+    for (size_t column = 0; column < 4; column++) {
+        for (size_t row = 0; row < 4; row++) {
+            for (size_t k = 0; k < 4; k++) {
+                result[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+            }
+        }
+    }
+    return result;
+}
+
+std::array<float, 3> Cross(const float* a, const float* b)
+{
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+            a[0] * b[1] - a[1] * b[0]};
+}
+
+uint32_t ReadUInt32(std::span<const uint8_t> bytes, size_t offset)
+{
+    if (offset + 4 > bytes.size()) {
+        throw std::runtime_error("Truncated GLB file");
+    }
+    uint32_t value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(value));
+    return value;
+}
+
+std::vector<uint8_t> ReadBinaryFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    if (!file) {
+        throw std::runtime_error("Failed to read file " + filename);
+    }
+    return bytes;
+}
+
+std::vector<uint8_t> DecodeBase64(std::string_view text)
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(text.size() / 4 * 3);
+
+    uint32_t bits = 0;
+    uint32_t bitCount = 0;
+
+    for (const char c : text) {
+        uint32_t value;
+        if (c >= 'A' && c <= 'Z') {
+            value = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            value = c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            value = c - '0' + 52;
+        } else if (c == '+') {
+            value = 62;
+        } else if (c == '/') {
+            value = 63;
+        } else if (c == '=') {
+            break;
+        } else {
+            throw std::runtime_error("Invalid base64 data URI");
+        }
+
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            bytes.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+
+    return bytes;
+}
+
+// Relative URIs may escape characters such as spaces
+std::string DecodeUri(std::string_view uri)
+{
+    std::string result;
+    for (size_t i = 0; i < uri.size(); i++) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            result += static_cast<char>(
+                std::stoi(std::string(uri.substr(i + 1, 2)), nullptr, 16));
+            i += 2;
+        } else {
+            result += uri[i];
+        }
+    }
+    return result;
+}
+
+struct FAccessor {
+    // Null when the accessor has no buffer view, its elements are all zero
+    const uint8_t* data = nullptr;
+    size_t stride = 0;
+    uint32_t count = 0;
+    uint32_t componentType = 0;
+    uint32_t componentSize = 0;
+    uint32_t componentCount = 0;
+    bool bNormalized = false;
+};
+
+float ReadComponent(const uint8_t* data, uint32_t componentType,
+                    bool bNormalized)
+{
+    switch (componentType) {
+    case ComponentFloat: {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case ComponentByte: {
+        const float value = static_cast<float>(static_cast<int8_t>(data[0]));
+        return bNormalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case ComponentUnsignedByte: {
+        const float value = static_cast<float>(data[0]);
+        return bNormalized ? value / 255.0f : value;
+    }
+    case ComponentShort: {
+        int16_t raw;
+        std::memcpy(&raw, data, sizeof(raw));
+        const float value = static_cast<float>(raw);
+        return bNormalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case ComponentUnsignedShort: {
+        uint16_t raw;
+        std::memcpy(&raw, data, sizeof(raw));
+        const float value = static_cast<float>(raw);
+        return bNormalized ? value / 65535.0f : value;
+    }
+    default: {
+        uint32_t raw;
+        std::memcpy(&raw, data, sizeof(raw));
+        return static_cast<float>(raw);
+    }
+    }
+}
+
+class FGltfReader
+{
+  public:
+    explicit FGltfReader(const std::string& filename) : filename(filename) {}
+
+    FSourceMesh Read();
+
+  private:
+    std::string filename;
+    FJsonValue document;
+    std::vector<std::vector<uint8_t>> buffers;
+    uint32_t skippedPrimitives = 0;
+
+    FSourceMesh mesh;
+
+  private:
+    void LoadBuffers(std::span<const uint8_t> binaryChunk, bool bHasBinary);
+
+    FAccessor GetAccessor(uint32_t index) const;
+    std::vector<float> ReadFloats(uint32_t index,
+                                  uint32_t componentCount) const;
+    std::vector<uint32_t> ReadIndices(uint32_t index) const;
+
+    void AddNode(uint32_t index, const FMatrix& parent, uint32_t depth);
+    void AddMesh(uint32_t index, const FMatrix& transform);
+};
+
+FSourceMesh FGltfReader::Read()
+{
+    const std::vector<uint8_t> bytes = ReadBinaryFile(filename);
+
+    std::span<const uint8_t> binaryChunk;
+    bool bHasBinary = false;
+
+    if (bytes.size() >= 12 && ReadUInt32(bytes, 0) == GlbMagic) {
+        if (ReadUInt32(bytes, 4) != 2) {
+            throw std::runtime_error(filename + ": unsupported GLB version");
+        }
+
+        const std::span<const uint8_t> file(
+            bytes.data(), std::min<size_t>(ReadUInt32(bytes, 8), bytes.size()));
+
+        // The JSON chunk comes first, the optional binary chunk second
+        size_t offset = 12;
+        const uint32_t jsonLength = ReadUInt32(file, offset);
+        if (ReadUInt32(file, offset + 4) != GlbJsonChunk ||
+            offset + 8 + jsonLength > file.size()) {
+            throw std::runtime_error(filename + ": invalid GLB JSON chunk");
+        }
+        document = FJsonValue::Parse(std::string_view(
+            reinterpret_cast<const char*>(file.data() + offset + 8),
+            jsonLength));
+
+        offset += 8 + ((jsonLength + 3) & ~3u);
+        if (offset + 8 <= file.size() &&
+            ReadUInt32(file, offset + 4) == GlbBinaryChunk) {
+            const uint32_t binaryLength = ReadUInt32(file, offset);
+            if (offset + 8 + binaryLength > file.size()) {
+                throw std::runtime_error(filename +
+                                         ": truncated GLB binary chunk");
+            }
+            binaryChunk = file.subspan(offset + 8, binaryLength);
+            bHasBinary = true;
+        }
+    } else {
+        document = FJsonValue::Parse(std::string_view(
+            reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+    }
+
+    if (!document["asset"]["version"].GetString().starts_with("2.")) {
+        throw std::runtime_error(filename + ": only glTF 2.0 is supported");
+    }
+
+    // Draco, meshopt and quantization extensions change how data is read
+    if (const FJsonValue* required = document.Find("extensionsRequired");
+        required != nullptr && required->GetSize() > 0) {
+        throw std::runtime_error(filename + ": required extension " +
+                                 (*required)[0].GetString() +
+                                 " is not supported");
+    }
+
+    LoadBuffers(binaryChunk, bHasBinary);
+
+    if (const FJsonValue* scenes = document.Find("scenes")) {
+        const FJsonValue& scene = (*scenes)[document.GetUInt("scene", 0)];
+        if (const FJsonValue* nodes = scene.Find("nodes")) {
+            for (const FJsonValue& node : nodes->GetItems()) {
+                AddNode(node.GetUInt(), Identity, 0);
+            }
+        }
+    } else if (const FJsonValue* meshes = document.Find("meshes")) {
+        // Without a scene every mesh is taken as is
+        for (uint32_t i = 0; i < meshes->GetSize(); i++) {
+            AddMesh(i, Identity);
+        }
+    }
+
+    if (skippedPrimitives > 0) {
+        std::cout << filename << ": skipped " << skippedPrimitives
+                  << " primitives that are not triangle lists" << std::endl;
+    }
+
+    if (mesh.indices.empty()) {
+        throw std::runtime_error(filename + " has no triangles");
+    }
+
+    return std::move(mesh);
+}
+
+void FGltfReader::LoadBuffers(std::span<const uint8_t> binaryChunk,
+                              bool bHasBinary)
+{
+    const FJsonValue* list = document.Find("buffers");
+    if (list == nullptr) {
+        return;
+    }
+
+    for (size_t i = 0; i < list->GetSize(); i++) {
+        const FJsonValue& buffer = (*list)[i];
+        const uint32_t byteLength = buffer["byteLength"].GetUInt();
+
+        std::vector<uint8_t> data;
+
+        const FJsonValue* uri = buffer.Find("uri");
+        if (uri == nullptr) {
+            // Only the first buffer of a GLB may refer to the binary chunk
+            if (i != 0 || !bHasBinary) {
+                throw std::runtime_error(filename + ": buffer " +
+                                         std::to_string(i) + " has no data");
+            }
+            data.assign(binaryChunk.begin(), binaryChunk.end());
+        } else if (uri->GetString().starts_with("data:")) {
+            const std::string& text = uri->GetString();
+            const size_t comma = text.find(',');
+            if (comma == std::string::npos ||
+                !text.substr(0, comma).ends_with(";base64")) {
+                throw std::runtime_error(
+                    filename + ": only base64 data URIs are supported");
+            }
+            data = DecodeBase64(std::string_view(text).substr(comma + 1));
+        } else {
+            const std::string path =
+                (std::filesystem::path(filename).parent_path() /
+                 DecodeUri(uri->GetString()))
+                    .string();
+            data = ReadBinaryFile(path);
+            mesh.dependencies.push_back(path);
+        }
+
+        if (data.size() < byteLength) {
+            throw std::runtime_error(filename + ": buffer " +
+                                     std::to_string(i) + " is truncated");
+        }
+
+        buffers.push_back(std::move(data));
+    }
+}
+
+FAccessor FGltfReader::GetAccessor(uint32_t index) const
+{
+    const FJsonValue& json = document["accessors"][index];
+
+    if (json.Find("sparse") != nullptr) {
+        throw std::runtime_error(filename +
+                                 ": sparse accessors are not supported");
+    }
+
+    FAccessor accessor;
+    accessor.count = json["count"].GetUInt();
+    accessor.componentType = json["componentType"].GetUInt();
+
+    const FJsonValue* normalized = json.Find("normalized");
+    accessor.bNormalized = normalized != nullptr && normalized->GetBool();
+
+    switch (accessor.componentType) {
+    case ComponentByte:
+    case ComponentUnsignedByte:
+        accessor.componentSize = 1;
+        break;
+    case ComponentShort:
+    case ComponentUnsignedShort:
+        accessor.componentSize = 2;
+        break;
+    case ComponentUnsignedInt:
+    case ComponentFloat:
+        accessor.componentSize = 4;
+        break;
+    default:
+        throw std::runtime_error(filename + ": invalid component type");
+    }
+
+    const std::string& type = json["type"].GetString();
+    if (type == "SCALAR") {
+        accessor.componentCount = 1;
+    } else if (type == "VEC2") {
+        accessor.componentCount = 2;
+    } else if (type == "VEC3") {
+        accessor.componentCount = 3;
+    } else if (type == "VEC4") {
+        accessor.componentCount = 4;
+    } else {
+        throw std::runtime_error(filename + ": unsupported accessor type " +
+                                 type);
+    }
+
+    const size_t elementSize =
+        static_cast<size_t>(accessor.componentSize) * accessor.componentCount;
+    accessor.stride = elementSize;
+
+    const FJsonValue* viewIndex = json.Find("bufferView");
+    if (viewIndex == nullptr) {
+        return accessor;
+    }
+
+    const FJsonValue& view = document["bufferViews"][viewIndex->GetUInt()];
+    const uint32_t bufferIndex = view["buffer"].GetUInt();
+    if (bufferIndex >= buffers.size()) {
+        throw std::runtime_error(filename + ": invalid buffer index");
+    }
+    const std::vector<uint8_t>& buffer = buffers[bufferIndex];
+
+    const uint64_t viewOffset = view.GetUInt("byteOffset", 0);
+    const uint64_t viewLength = view["byteLength"].GetUInt();
+    const uint64_t accessorOffset = json.GetUInt("byteOffset", 0);
+    accessor.stride = view.GetUInt("byteStride", 0) != 0
+                          ? view.GetUInt("byteStride", 0)
+                          : elementSize;
+
+    const uint64_t accessedLength =
+        accessor.count > 0
+            ? accessorOffset + accessor.stride * (accessor.count - 1ull) +
+                  elementSize
+            : 0;
+    if (viewOffset + viewLength > buffer.size() ||
+        accessedLength > viewLength) {
+        throw std::runtime_error(filename + ": accessor " +
+                                 std::to_string(index) + " is out of bounds");
+    }
+
+    accessor.data = buffer.data() + viewOffset + accessorOffset;
+    return accessor;
+}
+
+std::vector<float> FGltfReader::ReadFloats(uint32_t index,
+                                           uint32_t componentCount) const
+{
+    const FAccessor accessor = GetAccessor(index);
+    if (accessor.componentCount != componentCount) {
+        throw std::runtime_error(filename + ": accessor " +
+                                 std::to_string(index) +
+                                 " has an unexpected type");
+    }
+
+    std::vector<float> values(static_cast<size_t>(accessor.count) *
+                              componentCount);
+    if (accessor.data == nullptr) {
+        return values;
+    }
+
+    for (size_t i = 0; i < accessor.count; i++) {
+        const uint8_t* element = accessor.data + i * accessor.stride;
+        for (size_t c = 0; c < componentCount; c++) {
+            values[i * componentCount + c] =
+                ReadComponent(element + c * accessor.componentSize,
+                              accessor.componentType, accessor.bNormalized);
+        }
+    }
+    return values;
+}
+
+std::vector<uint32_t> FGltfReader::ReadIndices(uint32_t index) const
+{
+    const FAccessor accessor = GetAccessor(index);
+    if (accessor.componentCount != 1 ||
+        (accessor.componentType != ComponentUnsignedByte &&
+         accessor.componentType != ComponentUnsignedShort &&
+         accessor.componentType != ComponentUnsignedInt)) {
+        throw std::runtime_error(filename + ": invalid index accessor");
+    }
+
+    std::vector<uint32_t> indices(accessor.count, 0);
+    if (accessor.data == nullptr) {
+        return indices;
+    }
+
+    for (size_t i = 0; i < accessor.count; i++) {
+        const uint8_t* element = accessor.data + i * accessor.stride;
+        uint32_t value = 0;
+        std::memcpy(&value, element, accessor.componentSize);
+        indices[i] = value;
+    }
+    return indices;
+}
+
+void FGltfReader::AddNode(uint32_t index, const FMatrix& parent,
+                          uint32_t depth)
+{
+    if (depth > MaxNodeDepth) {
+        throw std::runtime_error(filename + ": node hierarchy is too deep");
+    }
+
+    const FJsonValue& node = document["nodes"][index];
+
+    FMatrix local = Identity;
+    if (const FJsonValue* matrix = node.Find("matrix")) {
+        for (size_t i = 0; i < 16; i++) {
+            local[i] = static_cast<float>((*matrix)[i].GetNumber());
+        }
+    } else {
+        // T * R * S, rotation is a unit quaternion x, y, z, w
+        float t[3] = {0.0f, 0.0f, 0.0f};
+        float r[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        float s[3] = {1.0f, 1.0f, 1.0f};
+
+        if (const FJsonValue* translation = node.Find("translation")) {
+            for (size_t i = 0; i < 3; i++) {
+                t[i] = static_cast<float>((*translation)[i].GetNumber());
+            }
+        }
+        if (const FJsonValue* rotation = node.Find("rotation")) {
+            for (size_t i = 0; i < 4; i++) {
+                r[i] = static_cast<float>((*rotation)[i].GetNumber());
+            }
+        }
+        if (const FJsonValue* scale = node.Find("scale")) {
+            for (size_t i = 0; i < 3; i++) {
+                s[i] = static_cast<float>((*scale)[i].GetNumber());
+            }
+        }
+
+        const float x = r[0], y = r[1], z = r[2], w = r[3];
+        const float rotationColumns[3][3] = {
+            {1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y)},
+            {2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x)},
+            {2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y)},
+        };
+
+        for (size_t column = 0; column < 3; column++) {
+            for (size_t row = 0; row < 3; row++) {
+                local[column * 4 + row] =
+                    rotationColumns[column][row] * s[column];
+            }
+        }
+        local[12] = t[0];
+        local[13] = t[1];
+        local[14] = t[2];
+    }
+
+    const FMatrix world = Multiply(parent, local);
+
+    if (const FJsonValue* meshIndex = node.Find("mesh")) {
+        AddMesh(meshIndex->GetUInt(), world);
+    }
+
+    if (const FJsonValue* children = node.Find("children")) {
+        for (const FJsonValue& child : children->GetItems()) {
+            AddNode(child.GetUInt(), world, depth + 1);
+        }
+    }
+}
+
+void FGltfReader::AddMesh(uint32_t index, const FMatrix& transform)
+{
+    // Normals transform by the cofactor matrix, a mirroring transform also
+    // flips the winding
+    const std::array<float, 3> cofactor[3] = {
+        Cross(&transform[4], &transform[8]),
+        Cross(&transform[8], &transform[0]),
+        Cross(&transform[0], &transform[4]),
+    };
+    const float determinant = transform[0] * cofactor[0][0] +
+                              transform[1] * cofactor[0][1] +
+                              transform[2] * cofactor[0][2];
+    const bool bMirrored = determinant < 0.0f;
+
+    const FJsonValue& primitives = document["meshes"][index]["primitives"];
+
+    for (const FJsonValue& primitive : primitives.GetItems()) {
+        if (primitive.GetUInt("mode", ModeTriangles) != ModeTriangles) {
+            skippedPrimitives++;
+            continue;
+        }
+
+        const FJsonValue& attributes = primitive["attributes"];
+
+        const std::vector<float> positions =
+            ReadFloats(attributes["POSITION"].GetUInt(), 3);
+        const size_t vertexCount = positions.size() / 3;
+
+        std::vector<float> normals;
+        if (const FJsonValue* normal = attributes.Find("NORMAL")) {
+            normals = ReadFloats(normal->GetUInt(), 3);
+        }
+        std::vector<float> uvs;
+        if (const FJsonValue* uv = attributes.Find("TEXCOORD_0")) {
+            uvs = ReadFloats(uv->GetUInt(), 2);
+        }
+
+        if ((!normals.empty() && normals.size() != vertexCount * 3) ||
+            (!uvs.empty() && uvs.size() != vertexCount * 2)) {
+            throw std::runtime_error(filename +
+                                     ": attribute counts do not match");
+        }
+
+        const size_t firstVertex = mesh.vertices.size();
+        const size_t firstIndex = mesh.indices.size();
+
+        for (size_t v = 0; v < vertexCount; v++) {
+            FSourceVertex vertex = {};
+            const float* p = &positions[v * 3];
+            for (size_t i = 0; i < 3; i++) {
+                vertex.position[i] = transform[i] * p[0] +
+                                     transform[4 + i] * p[1] +
+                                     transform[8 + i] * p[2] +
+                                     transform[12 + i];
+            }
+
+            if (!normals.empty()) {
+                const float* n = &normals[v * 3];
+                float length = 0.0f;
+                for (size_t i = 0; i < 3; i++) {
+                    vertex.normal[i] = cofactor[0][i] * n[0] +
+                                       cofactor[1][i] * n[1] +
+                                       cofactor[2][i] * n[2];
+                    if (bMirrored) {
+                        vertex.normal[i] = -vertex.normal[i];
+                    }
+                    length += vertex.normal[i] * vertex.normal[i];
+                }
+                length = std::sqrt(length);
+                for (size_t i = 0; i < 3 && length > 0.0f; i++) {
+                    vertex.normal[i] /= length;
+                }
+            }
+
+            if (!uvs.empty()) {
+                vertex.uv[0] = uvs[v * 2];
+                vertex.uv[1] = uvs[v * 2 + 1];
+            }
+
+            mesh.vertices.push_back(vertex);
+        }
+
+        std::vector<uint32_t> indices;
+        if (const FJsonValue* indexAccessor = primitive.Find("indices")) {
+            indices = ReadIndices(indexAccessor->GetUInt());
+        } else {
+            indices.resize(vertexCount);
+            std::iota(indices.begin(), indices.end(), 0);
+        }
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex =
+                    indices[i + (bMirrored ? 2 - corner : corner)];
+                if (vertex >= vertexCount) {
+                    throw std::runtime_error(filename +
+                                             ": index is out of range");
+                }
+                mesh.indices.push_back(
+                    static_cast<uint32_t>(firstVertex + vertex));
+            }
+        }
+
+        if (normals.empty()) {
+            mesh.GenerateNormals(firstVertex, firstIndex);
+        }
+    }
+}
+
+} // namespace
+
+FSourceMesh FGltfImporter::Import(const std::string& filename)
+{
+    return FGltfReader(filename).Read();
+}
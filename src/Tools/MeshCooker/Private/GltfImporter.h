@@ -0,0 +1,14 @@
+#pragma once
+
+#include "SourceMesh.h"
+
+#include <string>
+
+// glTF 2.0 as .gltf with external or data URI buffers, or as .glb. Every
+// triangle primitive of the default scene is merged into one mesh in scene
+// space, materials are ignored.
+class FGltfImporter
+{
+  public:
+    static FSourceMesh Import(const std::string& filename);
+};
@@ -0,0 +1,388 @@
+#include "Json.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+class FJsonParser
+{
+  public:
+    explicit FJsonParser(std::string_view text) : text(text), position(0) {}
+
+    FJsonValue ParseDocument()
+    {
+        FJsonValue value = ParseValue(0);
+        SkipSpaces();
+        if (position != text.size()) {
+            Error("Unexpected data after the document");
+        }
+        return value;
+    }
+
+  private:
+    static constexpr uint32_t MaxDepth = 256;
+
+    std::string_view text;
+    size_t position;
+
+  private:
+    [[noreturn]] void Error(const std::string& message) const
+    {
+        throw std::runtime_error("JSON offset " + std::to_string(position) +
+                                 ": " + message);
+    }
+
+    void SkipSpaces()
+    {
+        while (position < text.size() &&
+               (text[position] == ' ' || text[position] == '\t' ||
+                text[position] == '\n' || text[position] == '\r')) {
+            position++;
+        }
+    }
+
+    char Peek() const
+    {
+        return position < text.size() ? text[position] : '\0';
+    }
+
+    void Expect(char expected)
+    {
+        SkipSpaces();
+        if (Peek() != expected) {
+            Error(std::string("Expected '") + expected + "'");
+        }
+        position++;
+    }
+
+    bool Consume(std::string_view literal)
+    {
+        if (text.substr(position, literal.size()) != literal) {
+            return false;
+        }
+        position += literal.size();
+        return true;
+    }
+
+    FJsonValue ParseValue(uint32_t depth);
+    FJsonValue ParseNumber();
+    std::string ParseString();
+    uint32_t ParseHex4();
+};
+
+FJsonValue FJsonParser::ParseValue(uint32_t depth)
+{
+    if (depth > MaxDepth) {
+        Error("Document is nested too deeply");
+    }
+
+    SkipSpaces();
+
+    FJsonValue value;
+
+    switch (Peek()) {
+    case '{':
+        position++;
+        value.type = FJsonValue::EType::Object;
+        SkipSpaces();
+        if (Peek() == '}') {
+            position++;
+            return value;
+        }
+        while (true) {
+            SkipSpaces();
+            if (Peek() != '"') {
+                Error("Expected a member name");
+            }
+            value.keys.push_back(ParseString());
+            Expect(':');
+            value.items.push_back(ParseValue(depth + 1));
+            SkipSpaces();
+            if (Peek() != ',') {
+                break;
+            }
+            position++;
+        }
+        Expect('}');
+        return value;
+    case '[':
+        position++;
+        value.type = FJsonValue::EType::Array;
+        SkipSpaces();
+        if (Peek() == ']') {
+            position++;
+            return value;
+        }
+        while (true) {
+            value.items.push_back(ParseValue(depth + 1));
+            SkipSpaces();
+            if (Peek() != ',') {
+                break;
+            }
+            position++;
+        }
+        Expect(']');
+        return value;
+    case '"':
+        value.type = FJsonValue::EType::String;
+        value.string = ParseString();
+        return value;
+    case 't':
+    case 'f':
+        value.type = FJsonValue::EType::Bool;
+        value.boolean = Consume("true");
+        if (!value.boolean && !Consume("false")) {
+            Error("Invalid literal");
+        }
+        return value;
+    case 'n':
+        if (!Consume("null")) {
+            Error("Invalid literal");
+        }
+        return value;
+    default:
+        return ParseNumber();
+    }
+}
+
+FJsonValue FJsonParser::ParseNumber()
+{
+    const size_t start = position;
+
+    auto skipDigits = [this]() {
+        const size_t first = position;
+        while (Peek() >= '0' && Peek() <= '9') {
+            position++;
+        }
+        return position > first;
+    };
+
+    if (Peek() == '-') {
+        position++;
+    }
+    if (!skipDigits()) {
+        Error("Expected a value");
+    }
+    if (Peek() == '.') {
+        position++;
+        if (!skipDigits()) {
+            Error("Expected a fraction");
+        }
+    }
+    if (Peek() == 'e' || Peek() == 'E') {
+        position++;
+        if (Peek() == '+' || Peek() == '-') {
+            position++;
+        }
+        if (!skipDigits()) {
+            Error("Expected an exponent");
+        }
+    }
+
+    FJsonValue value;
+    value.type = FJsonValue::EType::Number;
+    value.number =
+        std::strtod(std::string(text.substr(start, position - start)).c_str(),
+                    nullptr);
+    return value;
+}
+
+std::string FJsonParser::ParseString()
+{
+    // Opening quote
+    position++;
+
+    std::string result;
+
+    while (true) {
+        if (position >= text.size()) {
+            Error("Unterminated string");
+        }
+
+        const char c = text[position++];
+        if (c == '"') {
+            return result;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            Error("Control character in string");
+        }
+        if (c != '\\') {
+            result += c;
+            continue;
+        }
+
+        const char escape = Peek();
+        position++;
+
+        switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+            result += escape;
+            break;
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'u': {
+            uint32_t codePoint = ParseHex4();
+
+            // Characters outside the BMP are escaped as surrogate pairs
+            if (codePoint >= 0xd800 && codePoint < 0xdc00) {
+                if (!Consume("\\u")) {
+                    Error("Unpaired surrogate");
+                }
+                const uint32_t low = ParseHex4();
+                if (low < 0xdc00 || low >= 0xe000) {
+                    Error("Unpaired surrogate");
+                }
+                codePoint = 0x10000 + ((codePoint - 0xd800) << 10) +
+                            (low - 0xdc00);
+            } else if (codePoint >= 0xdc00 && codePoint < 0xe000) {
+                Error("Unpaired surrogate");
+            }
+
+            if (codePoint < 0x80) {
+                result += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                result += static_cast<char>(0xc0 | (codePoint >> 6));
+                result += static_cast<char>(0x80 | (codePoint & 0x3f));
+            } else if (codePoint < 0x10000) {
+                result += static_cast<char>(0xe0 | (codePoint >> 12));
+                result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                result += static_cast<char>(0x80 | (codePoint & 0x3f));
+            } else {
+                result += static_cast<char>(0xf0 | (codePoint >> 18));
+                result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+                result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                result += static_cast<char>(0x80 | (codePoint & 0x3f));
+            }
+            break;
+        }
+        default:
+            Error("Invalid escape sequence");
+        }
+    }
+}
+
+uint32_t FJsonParser::ParseHex4()
+{
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        const char c = Peek();
+        position++;
+
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            Error("Invalid unicode escape");
+        }
+    }
+
+    return value;
+}
+
+FJsonValue FJsonValue::Parse(std::string_view text)
+{
+    return FJsonParser(text).ParseDocument();
+}
+
+bool FJsonValue::GetBool() const
+{
+    if (type != EType::Bool) {
+        throw std::runtime_error("JSON value is not a boolean");
+    }
+    return boolean;
+}
+
+double FJsonValue::GetNumber() const
+{
+    if (type != EType::Number) {
+        throw std::runtime_error("JSON value is not a number");
+    }
+    return number;
+}
+
+uint32_t FJsonValue::GetUInt() const
+{
+    const double value = GetNumber();
+    if (value < 0.0 || value > 4294967295.0 || std::floor(value) != value) {
+        throw std::runtime_error("JSON value is not an unsigned integer");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+const std::string& FJsonValue::GetString() const
+{
+    if (type != EType::String) {
+        throw std::runtime_error("JSON value is not a string");
+    }
+    return string;
+}
+
+const std::vector<FJsonValue>& FJsonValue::GetItems() const
+{
+    if (type != EType::Array && type != EType::Object) {
+        throw std::runtime_error("JSON value is not an array or object");
+    }
+    return items;
+}
+
+const FJsonValue& FJsonValue::operator[](size_t index) const
+{
+    const std::vector<FJsonValue>& elements = GetItems();
+    if (index >= elements.size()) {
+        throw std::runtime_error("JSON index " + std::to_string(index) +
+                                 " is out of range");
+    }
+    return elements[index];
+}
+
+const FJsonValue* FJsonValue::Find(std::string_view key) const
+{
+    if (type != EType::Object) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) {
+            return &items[i];
+        }
+    }
+    return nullptr;
+}
+
+const FJsonValue& FJsonValue::operator[](std::string_view key) const
+{
+    const FJsonValue* value = Find(key);
+    if (value == nullptr) {
+        throw std::runtime_error("Missing JSON member \"" + std::string(key) +
+                                 "\"");
+    }
+    return *value;
+}
+
+uint32_t FJsonValue::GetUInt(std::string_view key, uint32_t fallback) const
+{
+    const FJsonValue* value = Find(key);
+    return value != nullptr ? value->GetUInt() : fallback;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read only JSON document, enough for glTF. Accessors throw std::runtime_error
+// when the value has another type.
+class FJsonValue
+{
+  public:
+    enum class EType { Null, Bool, Number, String, Array, Object };
+
+    static FJsonValue Parse(std::string_view text);
+
+    EType GetType() const { return type; }
+
+    bool GetBool() const;
+    double GetNumber() const;
+    // Throws unless the number is an integer that fits
+    uint32_t GetUInt() const;
+    const std::string& GetString() const;
+
+    // Elements of an array or members of an object, in document order
+    const std::vector<FJsonValue>& GetItems() const;
+    size_t GetSize() const { return GetItems().size(); }
+    const FJsonValue& operator[](size_t index) const;
+
+    // Null if the value is not an object or has no such member
+    const FJsonValue* Find(std::string_view key) const;
+    const FJsonValue& operator[](std::string_view key) const;
+
+    uint32_t GetUInt(std::string_view key, uint32_t fallback) const;
+
+  private:
+    friend class FJsonParser;
+
+    EType type = EType::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<FJsonValue> items;
+    // Member names of an object, parallel to items
+    std::vector<std::string> keys;
+};
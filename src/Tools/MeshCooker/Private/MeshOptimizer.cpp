@@ -0,0 +1,395 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+
+// Forsyth's tuning, the cache is modelled as LRU
+constexpr uint32_t CacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+// Hardware caches are closer to a small FIFO when cutting overdraw clusters
+constexpr uint32_t ClusterCacheSize = 16;
+
+float GetVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The last triangle's vertices are scored lower so the next
+            // triangle does not reuse a whole edge strip-like
+            score = LastTriangleScore;
+        } else {
+            const float scale = 1.0f / (CacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale,
+                             CacheDecayPower);
+        }
+    }
+
+    // Vertices with few triangles left are finished first
+    score += ValenceBoostScale *
+             std::pow(static_cast<float>(remainingTriangles),
+                      -ValenceBoostPower);
+    return score;
+}
+
+// FIFO cache model, a vertex is a hit while fewer than cacheSize misses
+// happened since it was loaded
+class FFifoCache
+{
+  public:
+    FFifoCache(size_t vertexCount, uint32_t cacheSize)
+        : timestamps(vertexCount, 0), cacheSize(cacheSize),
+          time(cacheSize + 1)
+    {
+    }
+
+    uint32_t CountMisses(const uint32_t* triangle)
+    {
+        uint32_t misses = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = triangle[corner];
+            if (time - timestamps[vertex] > cacheSize) {
+                timestamps[vertex] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+
+    void Flush() { time += cacheSize + 1; }
+
+  private:
+    std::vector<uint32_t> timestamps;
+    uint32_t cacheSize;
+    uint32_t time;
+};
+
+struct FVector {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+} // namespace
+
+void FMeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices,
+                                         size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Triangles using each vertex, the first remainingTriangles[v] entries of
+    // a vertex's range are the ones not emitted yet
+    std::vector<uint32_t> firstAdjacency(vertexCount + 1, 0);
+    for (const uint32_t vertex : indices) {
+        firstAdjacency[vertex + 1]++;
+    }
+    std::partial_sum(firstAdjacency.begin(), firstAdjacency.end(),
+                     firstAdjacency.begin());
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = indices[triangle * 3 + corner];
+            adjacency[firstAdjacency[vertex] + remainingTriangles[vertex]++] =
+                static_cast<uint32_t>(triangle);
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        vertexScore[vertex] = GetVertexScore(-1, remainingTriangles[vertex]);
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    std::array<uint32_t, CacheSize + 3> cache;
+    size_t cacheCount = 0;
+
+    // Lowest triangle that may not be emitted, dead ends continue from there
+    size_t nextUnemitted = 0;
+    int64_t best = -1;
+
+    while (output.size() < indices.size()) {
+        if (best < 0) {
+            while (emitted[nextUnemitted]) {
+                nextUnemitted++;
+            }
+            best = static_cast<int64_t>(nextUnemitted);
+        }
+
+        const size_t triangle = static_cast<size_t>(best);
+        const uint32_t* corners = &indices[triangle * 3];
+        emitted[triangle] = true;
+
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = corners[corner];
+            output.push_back(vertex);
+
+            // Swap the triangle out of the vertex's remaining range
+            uint32_t* first = &adjacency[firstAdjacency[vertex]];
+            uint32_t* last = first + remainingTriangles[vertex];
+            uint32_t* found = std::find(first, last, triangle);
+            if (found != last) {
+                std::swap(*found, *(last - 1));
+                remainingTriangles[vertex]--;
+            }
+        }
+
+        // The triangle's vertices move to the front, the rest shift back and
+        // the ones past the cache size fall out
+        std::array<uint32_t, CacheSize + 3> newCache;
+        size_t newCount = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = corners[corner];
+            if (std::find(newCache.begin(), newCache.begin() + newCount,
+                          vertex) == newCache.begin() + newCount) {
+                newCache[newCount++] = vertex;
+            }
+        }
+        for (size_t i = 0; i < cacheCount; i++) {
+            const uint32_t vertex = cache[i];
+            if (vertex != corners[0] && vertex != corners[1] &&
+                vertex != corners[2]) {
+                newCache[newCount++] = vertex;
+            }
+        }
+
+        for (size_t i = 0; i < newCount; i++) {
+            const uint32_t vertex = newCache[i];
+            cachePosition[vertex] =
+                i < CacheSize ? static_cast<int32_t>(i) : -1;
+            vertexScore[vertex] = GetVertexScore(cachePosition[vertex],
+                                                 remainingTriangles[vertex]);
+        }
+
+        // Only triangles around the touched vertices changed score, the best
+        // of them is next
+        best = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCount; i++) {
+            const uint32_t vertex = newCache[i];
+            const uint32_t first = firstAdjacency[vertex];
+
+            for (uint32_t j = 0; j < remainingTriangles[vertex]; j++) {
+                const uint32_t candidate = adjacency[first + j];
+                const float score = vertexScore[indices[candidate * 3]] +
+                                    vertexScore[indices[candidate * 3 + 1]] +
+                                    vertexScore[indices[candidate * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = candidate;
+                }
+            }
+        }
+
+        cacheCount = std::min<size_t>(newCount, CacheSize);
+        std::copy_n(newCache.begin(), cacheCount, cache.begin());
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void FMeshOptimizer::OptimizeOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const std::array<float, 3>> positions, float threshold)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    FFifoCache cache(positions.size(), ClusterCacheSize);
+
+    // Hard boundaries are where the cache order already restarts, every
+    // vertex of the triangle misses
+    std::vector<size_t> hardBoundaries;
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        const uint32_t misses = cache.CountMisses(&indices[triangle * 3]);
+        if (triangle == 0 || misses == 3) {
+            hardBoundaries.push_back(triangle);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // Soft boundaries split a hard cluster as soon as the part so far has an
+    // ACMR within threshold of the whole cluster
+    std::vector<size_t> clusterStarts;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+        const size_t begin = hardBoundaries[h];
+        const size_t end = hardBoundaries[h + 1];
+
+        cache.Flush();
+        uint32_t clusterMisses = 0;
+        for (size_t triangle = begin; triangle < end; triangle++) {
+            clusterMisses += cache.CountMisses(&indices[triangle * 3]);
+        }
+        const float limit =
+            threshold * static_cast<float>(clusterMisses) / (end - begin);
+
+        cache.Flush();
+        clusterStarts.push_back(begin);
+        size_t runStart = begin;
+        uint32_t runMisses = 0;
+
+        for (size_t triangle = begin; triangle + 1 < end; triangle++) {
+            runMisses += cache.CountMisses(&indices[triangle * 3]);
+
+            if (static_cast<float>(runMisses) / (triangle + 1 - runStart) <=
+                limit) {
+                runStart = triangle + 1;
+                runMisses = 0;
+                clusterStarts.push_back(runStart);
+                cache.Flush();
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+
+    const size_t clusterCount = clusterStarts.size() - 1;
+
+    // Area weighted centroids and normals
+    auto accumulate = [&](size_t begin, size_t end, FVector& centroid,
+                          FVector& normal) {
+        double area = 0.0;
+        for (size_t triangle = begin; triangle < end; triangle++) {
+            const std::array<float, 3>& a = positions[indices[triangle * 3]];
+            const std::array<float, 3>& b =
+                positions[indices[triangle * 3 + 1]];
+            const std::array<float, 3>& c =
+                positions[indices[triangle * 3 + 2]];
+
+            const FVector ab = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const FVector ac = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            const FVector cross = {ab.y * ac.z - ab.z * ac.y,
+                                   ab.z * ac.x - ab.x * ac.z,
+                                   ab.x * ac.y - ab.y * ac.x};
+            const double weight = std::sqrt(
+                cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+
+            centroid.x += (a[0] + b[0] + c[0]) / 3.0 * weight;
+            centroid.y += (a[1] + b[1] + c[1]) / 3.0 * weight;
+            centroid.z += (a[2] + b[2] + c[2]) / 3.0 * weight;
+            normal.x += cross.x;
+            normal.y += cross.y;
+            normal.z += cross.z;
+            area += weight;
+        }
+
+        if (area > 0.0) {
+            centroid.x /= area;
+            centroid.y /= area;
+            centroid.z /= area;
+        }
+    };
+
+    FVector meshCentroid;
+    FVector meshNormal;
+    accumulate(0, triangleCount, meshCentroid, meshNormal);
+
+    std::vector<double> sortKeys(clusterCount);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+        FVector centroid;
+        FVector normal;
+        accumulate(clusterStarts[cluster], clusterStarts[cluster + 1],
+                   centroid, normal);
+
+        const double length = std::sqrt(normal.x * normal.x +
+                                        normal.y * normal.y +
+                                        normal.z * normal.z);
+        sortKeys[cluster] =
+            length > 0.0 ? ((centroid.x - meshCentroid.x) * normal.x +
+                            (centroid.y - meshCentroid.y) * normal.y +
+                            (centroid.z - meshCentroid.z) * normal.z) /
+                               length
+                         : 0.0;
+    }
+
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const size_t cluster : order) {
+        output.insert(output.end(),
+                      indices.begin() + clusterStarts[cluster] * 3,
+                      indices.begin() + clusterStarts[cluster + 1] * 3);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+std::vector<FMeshVertex>
+FMeshOptimizer::OptimizeVertexFetch(std::span<uint32_t> indices,
+                                    std::span<const FMeshVertex> vertices)
+{
+    constexpr uint32_t Unused = ~0u;
+
+    std::vector<uint32_t> remap(vertices.size(), Unused);
+    std::vector<FMeshVertex> output;
+    output.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == Unused) {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    return output;
+}
+
+FVertexCacheStats
+FMeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices,
+                                   size_t vertexCount, uint32_t cacheSize)
+{
+    FVertexCacheStats stats;
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return stats;
+    }
+
+    FFifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t referencedCount = 0;
+    uint32_t misses = 0;
+
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        misses += cache.CountMisses(&indices[triangle * 3]);
+
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = indices[triangle * 3 + corner];
+            if (!referenced[vertex]) {
+                referenced[vertex] = true;
+                referencedCount++;
+            }
+        }
+    }
+
+    stats.acmr = static_cast<float>(misses) / triangleCount;
+    stats.atvr = static_cast<float>(misses) / referencedCount;
+    return stats;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Core/MeshFormat.h"
+
+#include <array>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct FVertexCacheStats {
+    // Vertex shader invocations per triangle, 0.5 at best and 3 at worst
+    float acmr = 0.0f;
+    // Vertex shader invocations per referenced vertex, 1 at best
+    float atvr = 0.0f;
+};
+
+class FMeshOptimizer
+{
+  public:
+    // Reorders the triangles for the post-transform vertex cache with Tom
+    // Forsyth's linear-speed vertex cache optimisation
+    static void OptimizeVertexCache(std::span<uint32_t> indices,
+                                    size_t vertexCount);
+
+    // Splits cache ordered triangles into clusters and draws the clusters
+    // facing away from the mesh center first, so they tend to occlude the rest
+    // from any view (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+    // Vertex Locality and Reduced Overdraw"). Clusters are cut where their
+    // ACMR is within threshold of the input's.
+    static void
+    OptimizeOverdraw(std::span<uint32_t> indices,
+                     std::span<const std::array<float, 3>> positions,
+                     float threshold);
+
+    // Orders the vertices by first use and drops unreferenced ones
+    static std::vector<FMeshVertex>
+    OptimizeVertexFetch(std::span<uint32_t> indices,
+                        std::span<const FMeshVertex> vertices);
+
+    // Simulates a FIFO cache of the given size
+    static FVertexCacheStats
+    AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                       uint32_t cacheSize);
+};
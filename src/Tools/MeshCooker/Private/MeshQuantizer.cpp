@@ -0,0 +1,235 @@
+#include "MeshQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+
+struct FVertexKey {
+    FMeshVertex vertex;
+
+    bool operator==(const FVertexKey& other) const
+    {
+        return std::memcmp(&vertex, &other.vertex, sizeof(vertex)) == 0;
+    }
+};
+
+struct FVertexKeyHash {
+    size_t operator()(const FVertexKey& key) const
+    {
+        uint64_t words[2];
+        std::memcpy(words, &key.vertex, sizeof(words));
+        return static_cast<size_t>((words[0] * 0x9e3779b97f4a7c15ull) ^
+                                   (words[1] * 0xc2b2ae3d27d4eb4full));
+    }
+};
+
+float SignNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+} // namespace
+
+std::array<float, 3> FCookedMesh::GetPosition(const FMeshVertex& vertex) const
+{
+    std::array<float, 3> position;
+    for (size_t i = 0; i < 3; i++) {
+        position[i] =
+            positionMin[i] + vertex.position[i] / 65535.0f * positionExtent[i];
+    }
+    return position;
+}
+
+FCookedMesh FMeshQuantizer::Quantize(const FSourceMesh& mesh)
+{
+    FCookedMesh cooked;
+
+    float positionMax[3];
+    for (size_t i = 0; i < 3; i++) {
+        cooked.positionMin[i] = std::numeric_limits<float>::max();
+        positionMax[i] = std::numeric_limits<float>::lowest();
+    }
+
+    for (const FSourceVertex& vertex : mesh.vertices) {
+        for (size_t i = 0; i < 3; i++) {
+            if (!std::isfinite(vertex.position[i])) {
+                throw std::runtime_error("Mesh has a non finite position");
+            }
+            cooked.positionMin[i] =
+                std::min(cooked.positionMin[i], vertex.position[i]);
+            positionMax[i] = std::max(positionMax[i], vertex.position[i]);
+        }
+    }
+
+    for (size_t i = 0; i < 3; i++) {
+        cooked.positionExtent[i] = positionMax[i] - cooked.positionMin[i];
+    }
+
+    std::unordered_map<FVertexKey, uint32_t, FVertexKeyHash> unique;
+    std::vector<uint32_t> remap(mesh.vertices.size());
+
+    for (size_t v = 0; v < mesh.vertices.size(); v++) {
+        const FSourceVertex& source = mesh.vertices[v];
+
+        FMeshVertex vertex = {};
+        for (size_t i = 0; i < 3; i++) {
+            const float fraction =
+                cooked.positionExtent[i] > 0.0f
+                    ? (source.position[i] - cooked.positionMin[i]) /
+                          cooked.positionExtent[i]
+                    : 0.0f;
+            vertex.position[i] = static_cast<uint16_t>(
+                std::lround(std::clamp(fraction, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        const std::array<int16_t, 2> normal = EncodeOctahedral(source.normal);
+        vertex.normal[0] = normal[0];
+        vertex.normal[1] = normal[1];
+
+        vertex.uv[0] = EncodeHalf(source.uv[0]);
+        vertex.uv[1] = EncodeHalf(source.uv[1]);
+
+        const auto [found, bInserted] = unique.try_emplace(
+            FVertexKey{vertex}, static_cast<uint32_t>(cooked.vertices.size()));
+        if (bInserted) {
+            cooked.vertices.push_back(vertex);
+        }
+        remap[v] = found->second;
+    }
+
+    cooked.indices.reserve(mesh.indices.size());
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const uint32_t a = remap[mesh.indices[i]];
+        const uint32_t b = remap[mesh.indices[i + 1]];
+        const uint32_t c = remap[mesh.indices[i + 2]];
+
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+
+        cooked.indices.push_back(a);
+        cooked.indices.push_back(b);
+        cooked.indices.push_back(c);
+    }
+
+    if (cooked.indices.empty()) {
+        throw std::runtime_error("Every triangle of the mesh is degenerate");
+    }
+
+    cooked.lods.push_back({
+        .firstIndex = 0,
+        .indexCount = static_cast<uint32_t>(cooked.indices.size()),
+        .error = 0.0f,
+        .padding = 0,
+    });
+
+    return cooked;
+}
+
+uint16_t FMeshQuantizer::EncodeHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t magnitude = bits & 0x7fffffff;
+
+    // Infinity and NaN, NaN keeps a mantissa bit
+    if (magnitude >= 0x7f800000) {
+        return static_cast<uint16_t>(sign | 0x7c00 |
+                                     (magnitude > 0x7f800000 ? 0x200 : 0));
+    }
+
+    // Rounds to 65520 or above
+    if (magnitude >= 0x477ff000) {
+        return static_cast<uint16_t>(sign | 0x7c00);
+    }
+
+    // Below the smallest normal half the value is a multiple of 2^-24
+    if (magnitude < 0x38800000) {
+        float scaled;
+        std::memcpy(&scaled, &magnitude, sizeof(scaled));
+        return static_cast<uint16_t>(
+            sign | static_cast<uint32_t>(std::nearbyint(scaled * 16777216.0f)));
+    }
+
+    // Rebias the exponent from 127 to 15, a mantissa carry bumps the exponent
+    const uint32_t rounded =
+        magnitude - 0x38000000 + 0xfff + ((magnitude >> 13) & 1);
+    return static_cast<uint16_t>(sign | (rounded >> 13));
+}
+
+std::array<int16_t, 2> FMeshQuantizer::EncodeOctahedral(const float normal[3])
+{
+    const float length =
+        std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    if (!(length > 0.0f)) {
+        return {0, 0};
+    }
+
+    // Project onto the octahedron, then fold the lower half over the upper
+    float x = normal[0] / length;
+    float y = normal[1] / length;
+    if (normal[2] < 0.0f) {
+        const float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+        const float foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    const float unitLength = std::sqrt(normal[0] * normal[0] +
+                                       normal[1] * normal[1] +
+                                       normal[2] * normal[2]);
+
+    // Of the four neighbouring codes keep the one decoding closest to the
+    // normal rather than the one closest on the octahedron
+    std::array<int16_t, 2> best = {};
+    float bestDot = -2.0f;
+
+    for (int corner = 0; corner < 4; corner++) {
+        const float cx = (corner & 1) ? std::ceil(x * 32767.0f)
+                                      : std::floor(x * 32767.0f);
+        const float cy = (corner & 2) ? std::ceil(y * 32767.0f)
+                                      : std::floor(y * 32767.0f);
+
+        const int16_t candidate[2] = {
+            static_cast<int16_t>(std::clamp(cx, -32767.0f, 32767.0f)),
+            static_cast<int16_t>(std::clamp(cy, -32767.0f, 32767.0f)),
+        };
+
+        const std::array<float, 3> decoded = DecodeOctahedral(candidate);
+        const float dot = (decoded[0] * normal[0] + decoded[1] * normal[1] +
+                           decoded[2] * normal[2]) /
+                          unitLength;
+
+        if (dot > bestDot) {
+            bestDot = dot;
+            best = {candidate[0], candidate[1]};
+        }
+    }
+
+    return best;
+}
+
+std::array<float, 3> FMeshQuantizer::DecodeOctahedral(const int16_t encoded[2])
+{
+    // Matches the decode in mesh.vert
+    const float x = std::max(encoded[0] / 32767.0f, -1.0f);
+    const float y = std::max(encoded[1] / 32767.0f, -1.0f);
+
+    std::array<float, 3> normal = {x, y, 1.0f - std::abs(x) - std::abs(y)};
+    const float t = std::max(-normal[2], 0.0f);
+    normal[0] += normal[0] >= 0.0f ? -t : t;
+    normal[1] += normal[1] >= 0.0f ? -t : t;
+
+    const float length = std::sqrt(normal[0] * normal[0] +
+                                   normal[1] * normal[1] +
+                                   normal[2] * normal[2]);
+    for (float& component : normal) {
+        component /= length;
+    }
+    return normal;
+}
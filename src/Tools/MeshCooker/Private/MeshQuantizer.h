@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Core/MeshFormat.h"
+#include "SourceMesh.h"
+
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+// Mesh in its cooked vertex layout, the indices of every LOD back to back
+struct FCookedMesh {
+    std::vector<FMeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<FMeshLod> lods;
+    float positionMin[3] = {};
+    float positionExtent[3] = {};
+
+    std::array<float, 3> GetPosition(const FMeshVertex& vertex) const;
+};
+
+class FMeshQuantizer
+{
+  public:
+    // Vertices that become identical are merged and the triangles that
+    // collapse are dropped. The result has a single LOD.
+    static FCookedMesh Quantize(const FSourceMesh& mesh);
+
+    // Round to nearest even, out of range values become infinity
+    static uint16_t EncodeHalf(float value);
+    // Picks the snorm16 pair that decodes closest to the unit normal
+    static std::array<int16_t, 2> EncodeOctahedral(const float normal[3]);
+    static std::array<float, 3> DecodeOctahedral(const int16_t encoded[2]);
+};
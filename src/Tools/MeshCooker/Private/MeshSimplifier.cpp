@@ -0,0 +1,321 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+
+// A collapse may not rotate a remaining triangle by more than about 75 degrees
+constexpr double MinNormalCosine = 0.25;
+
+std::array<double, 3> Cross(const std::array<float, 3>& a,
+                            const std::array<float, 3>& b,
+                            const std::array<float, 3>& c)
+{
+    const double e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const double e1[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    return {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2],
+            e0[0] * e1[1] - e0[1] * e1[0]};
+}
+
+double Dot(const std::array<double, 3>& a, const std::array<double, 3>& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+} // namespace
+
+void FMeshSimplifier::FQuadric::AddPlane(const double normal[3],
+                                         double distance, double area)
+{
+    const double plane[4] = {normal[0], normal[1], normal[2], distance};
+
+    size_t i = 0;
+    for (size_t row = 0; row < 4; row++) {
+        for (size_t column = row; column < 4; column++) {
+            m[i++] += area * plane[row] * plane[column];
+        }
+    }
+    weight += area;
+}
+
+FMeshSimplifier::FQuadric&
+FMeshSimplifier::FQuadric::operator+=(const FQuadric& other)
+{
+    for (size_t i = 0; i < 10; i++) {
+        m[i] += other.m[i];
+    }
+    weight += other.weight;
+    return *this;
+}
+
+double
+FMeshSimplifier::FQuadric::Evaluate(const std::array<float, 3>& position) const
+{
+    const double v[4] = {position[0], position[1], position[2], 1.0};
+
+    // Off diagonal terms appear twice in v^T Q v
+    double result = 0.0;
+    size_t i = 0;
+    for (size_t row = 0; row < 4; row++) {
+        for (size_t column = row; column < 4; column++) {
+            const double scale = row == column ? 1.0 : 2.0;
+            result += scale * m[i++] * v[row] * v[column];
+        }
+    }
+    return std::max(result, 0.0);
+}
+
+FMeshSimplifier::FMeshSimplifier(
+    std::span<const uint32_t> indices,
+    std::span<const std::array<float, 3>> positions)
+    : indices(indices.begin(), indices.end()), positions(positions),
+      positionRemap(positions.size()), locked(positions.size(), false),
+      quadrics(positions.size()), error(0.0f)
+{
+    const size_t vertexCount = positions.size();
+
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return positions[a] < positions[b];
+    });
+
+    for (size_t first = 0; first < vertexCount;) {
+        size_t last = first + 1;
+        while (last < vertexCount &&
+               positions[order[last]] == positions[order[first]]) {
+            last++;
+        }
+        for (size_t i = first; i < last; i++) {
+            positionRemap[order[i]] = order[first];
+            // Splits in the other attributes have to stay where they are
+            locked[order[i]] = last - first > 1;
+        }
+        first = last;
+    }
+
+    // Edges of a single triangle are on a border, more than two make the
+    // surface non-manifold, both lock their vertices
+    std::vector<uint64_t> edges;
+    edges.reserve(this->indices.size());
+    for (size_t i = 0; i < this->indices.size(); i += 3) {
+        for (size_t corner = 0; corner < 3; corner++) {
+            const uint64_t a = positionRemap[this->indices[i + corner]];
+            const uint64_t b =
+                positionRemap[this->indices[i + (corner + 1) % 3]];
+            edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t first = 0; first < edges.size();) {
+        size_t last = first + 1;
+        while (last < edges.size() && edges[last] == edges[first]) {
+            last++;
+        }
+        if (last - first != 2) {
+            locked[edges[first] >> 32] = true;
+            locked[edges[first] & 0xffffffff] = true;
+        }
+        first = last;
+    }
+
+    for (size_t i = 0; i < this->indices.size(); i += 3) {
+        const uint32_t a = positionRemap[this->indices[i]];
+        const uint32_t b = positionRemap[this->indices[i + 1]];
+        const uint32_t c = positionRemap[this->indices[i + 2]];
+
+        const std::array<double, 3> normal =
+            Cross(positions[a], positions[b], positions[c]);
+        const double length = std::sqrt(Dot(normal, normal));
+        if (length == 0.0) {
+            continue;
+        }
+
+        const double unitNormal[3] = {normal[0] / length, normal[1] / length,
+                                      normal[2] / length};
+        const double distance = -(unitNormal[0] * positions[a][0] +
+                                  unitNormal[1] * positions[a][1] +
+                                  unitNormal[2] * positions[a][2]);
+
+        // Area weighted, so small triangles do not pin large flat regions
+        FQuadric quadric;
+        quadric.AddPlane(unitNormal, distance, length * 0.5);
+        quadrics[a] += quadric;
+        quadrics[b] += quadric;
+        quadrics[c] += quadric;
+    }
+
+    // Locks found on any vertex apply to its whole position
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (locked[v]) {
+            locked[positionRemap[v]] = true;
+        }
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        locked[v] = locked[positionRemap[v]];
+    }
+}
+
+float FMeshSimplifier::GetCollapseCost(uint32_t vertex, uint32_t target) const
+{
+    FQuadric quadric = quadrics[positionRemap[vertex]];
+    quadric += quadrics[positionRemap[target]];
+
+    if (quadric.weight == 0.0) {
+        return 0.0f;
+    }
+    return static_cast<float>(quadric.Evaluate(positions[target]) /
+                              quadric.weight);
+}
+
+bool FMeshSimplifier::FlipsTriangle(const FCollapse& collapse,
+                                    std::span<const uint32_t> triangles) const
+{
+    const uint32_t target = positionRemap[collapse.target];
+
+    for (const uint32_t triangle : triangles) {
+        std::array<uint32_t, 3> corners = {indices[triangle * 3],
+                                           indices[triangle * 3 + 1],
+                                           indices[triangle * 3 + 2]};
+
+        // Triangles on the collapsed edge disappear
+        if (positionRemap[corners[0]] == target ||
+            positionRemap[corners[1]] == target ||
+            positionRemap[corners[2]] == target) {
+            continue;
+        }
+
+        const std::array<double, 3> before =
+            Cross(positions[corners[0]], positions[corners[1]],
+                  positions[corners[2]]);
+        for (uint32_t& corner : corners) {
+            if (corner == collapse.vertex) {
+                corner = collapse.target;
+            }
+        }
+        const std::array<double, 3> after =
+            Cross(positions[corners[0]], positions[corners[1]],
+                  positions[corners[2]]);
+
+        const double lengths =
+            std::sqrt(Dot(before, before) * Dot(after, after));
+        if (Dot(before, after) <= MinNormalCosine * lengths) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FMeshSimplifier::Simplify(size_t targetIndexCount)
+{
+    const size_t vertexCount = positions.size();
+
+    // Collapses are batched in passes where no two touch the same triangle,
+    // so each is tested against up to date neighbours
+    while (indices.size() > targetIndexCount) {
+        const size_t triangleCount = indices.size() / 3;
+
+        std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+        for (const uint32_t index : indices) {
+            triangleOffsets[index + 1]++;
+        }
+        std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(),
+                         triangleOffsets.begin());
+
+        std::vector<uint32_t> vertexTriangles(indices.size());
+        std::vector<uint32_t> cursors(triangleOffsets.begin(),
+                                      triangleOffsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            vertexTriangles[cursors[indices[i]]++] =
+                static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<FCollapse> collapses;
+        collapses.reserve(indices.size() * 2);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[i + corner];
+                if (locked[vertex]) {
+                    continue;
+                }
+                for (size_t other = 1; other < 3; other++) {
+                    const uint32_t target = indices[i + (corner + other) % 3];
+                    collapses.push_back({
+                        .vertex = vertex,
+                        .target = target,
+                        .cost = GetCollapseCost(vertex, target),
+                    });
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const FCollapse& a, const FCollapse& b) {
+                      return a.cost < b.cost;
+                  });
+
+        // An interior collapse removes the two triangles on its edge
+        const size_t trianglesToRemove = triangleCount - targetIndexCount / 3;
+
+        std::vector<uint32_t> remap(vertexCount);
+        std::iota(remap.begin(), remap.end(), 0);
+        std::vector<bool> touched(vertexCount, false);
+        size_t removedTriangles = 0;
+
+        for (const FCollapse& collapse : collapses) {
+            if (removedTriangles >= trianglesToRemove) {
+                break;
+            }
+            if (touched[collapse.vertex] || touched[collapse.target]) {
+                continue;
+            }
+
+            const std::span<const uint32_t> triangles(
+                vertexTriangles.data() + triangleOffsets[collapse.vertex],
+                vertexTriangles.data() + triangleOffsets[collapse.vertex + 1]);
+            if (FlipsTriangle(collapse, triangles)) {
+                continue;
+            }
+
+            const uint32_t target = positionRemap[collapse.target];
+            for (const uint32_t triangle : triangles) {
+                bool bRemoved = false;
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const uint32_t index = indices[triangle * 3 + corner];
+                    touched[index] = true;
+                    bRemoved |= positionRemap[index] == target;
+                }
+                removedTriangles += bRemoved;
+            }
+
+            remap[collapse.vertex] = collapse.target;
+            quadrics[target] += quadrics[positionRemap[collapse.vertex]];
+            error = std::max(error, std::sqrt(collapse.cost));
+        }
+
+        if (removedTriangles == 0) {
+            break;
+        }
+
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t a = remap[indices[i]];
+            const uint32_t b = remap[indices[i + 1]];
+            const uint32_t c = remap[indices[i + 2]];
+
+            if (positionRemap[a] == positionRemap[b] ||
+                positionRemap[b] == positionRemap[c] ||
+                positionRemap[a] == positionRemap[c]) {
+                continue;
+            }
+
+            indices[writeIndex++] = a;
+            indices[writeIndex++] = b;
+            indices[writeIndex++] = c;
+        }
+        indices.resize(writeIndex);
+    }
+}
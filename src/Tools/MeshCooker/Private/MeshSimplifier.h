@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Quadric error metric simplification (Garland and Heckbert, "Surface
+// Simplification Using Quadric Error Metrics") by half edge collapses. A vertex
+// collapses onto one of its neighbours instead of a new position, so every LOD
+// indexes the same vertex buffer. Vertices on open borders and attribute seams,
+// where several vertices share a position, are never collapsed.
+class FMeshSimplifier
+{
+  public:
+    FMeshSimplifier(std::span<const uint32_t> indices,
+                    std::span<const std::array<float, 3>> positions);
+
+    // Collapses the cheapest edges until at most targetIndexCount indices are
+    // left or no collapse is allowed. Every call continues from the previous
+    // result, so the quadrics and the error keep accumulating.
+    void Simplify(size_t targetIndexCount);
+
+    const std::vector<uint32_t>& GetIndices() const { return indices; }
+
+    // Root mean square distance of the collapsed vertices to the original
+    // planes around them, in object space
+    float GetError() const { return error; }
+
+  private:
+    // Symmetric 4x4 matrix, the upper triangle row by row
+    struct FQuadric {
+        double m[10] = {};
+        double weight = 0.0;
+
+        void AddPlane(const double normal[3], double distance, double area);
+        FQuadric& operator+=(const FQuadric& other);
+        double Evaluate(const std::array<float, 3>& position) const;
+    };
+
+    struct FCollapse {
+        uint32_t vertex;
+        uint32_t target;
+        float cost;
+    };
+
+    float GetCollapseCost(uint32_t vertex, uint32_t target) const;
+    bool FlipsTriangle(const FCollapse& collapse,
+                       std::span<const uint32_t> triangles) const;
+
+    std::vector<uint32_t> indices;
+    std::span<const std::array<float, 3>> positions;
+
+    // First vertex at the same position, the quadrics are kept there
+    std::vector<uint32_t> positionRemap;
+    std::vector<bool> locked;
+    std::vector<FQuadric> quadrics;
+
+    float error;
+};
@@ -0,0 +1,76 @@
+#include "MeshWriter.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+uint64_t Align(uint64_t offset)
+{
+    return (offset + MeshFileAlignment - 1) & ~uint64_t{MeshFileAlignment - 1};
+}
+
+} // namespace
+
+size_t FMeshWriter::Write(const std::string& filename, const FCookedMesh& mesh)
+{
+    const bool bShortIndices = mesh.vertices.size() <= 0x10000;
+    const uint32_t indexSize = bShortIndices ? 2 : 4;
+
+    FMeshFileHeader header = {
+        .magic = MeshFileMagic,
+        .version = MeshFileVersion,
+        .vertexCount = static_cast<uint32_t>(mesh.vertices.size()),
+        .vertexStride = sizeof(FMeshVertex),
+        .indexCount = static_cast<uint32_t>(mesh.indices.size()),
+        .indexSize = indexSize,
+        .lodCount = static_cast<uint32_t>(mesh.lods.size()),
+        .padding = 0,
+        .positionMin = {mesh.positionMin[0], mesh.positionMin[1],
+                        mesh.positionMin[2]},
+        .positionExtent = {mesh.positionExtent[0], mesh.positionExtent[1],
+                           mesh.positionExtent[2]},
+        .vertexOffset = 0,
+        .indexOffset = 0,
+    };
+
+    header.vertexOffset =
+        Align(MeshLodTableOffset + mesh.lods.size() * sizeof(FMeshLod));
+    header.indexOffset =
+        Align(header.vertexOffset + mesh.vertices.size() * sizeof(FMeshVertex));
+    const uint64_t fileSize =
+        header.indexOffset +
+        static_cast<uint64_t>(mesh.indices.size()) * indexSize;
+
+    std::vector<char> file(fileSize, 0);
+
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + MeshLodTableOffset, mesh.lods.data(),
+                mesh.lods.size() * sizeof(FMeshLod));
+    std::memcpy(file.data() + header.vertexOffset, mesh.vertices.data(),
+                mesh.vertices.size() * sizeof(FMeshVertex));
+
+    char* indices = file.data() + header.indexOffset;
+    for (size_t i = 0; i < mesh.indices.size(); i++) {
+        if (bShortIndices) {
+            const uint16_t index = static_cast<uint16_t>(mesh.indices[i]);
+            std::memcpy(indices + i * 2, &index, sizeof(index));
+        } else {
+            std::memcpy(indices + i * 4, &mesh.indices[i], sizeof(uint32_t));
+        }
+    }
+
+    std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+    output.write(file.data(), file.size());
+    if (!output) {
+        throw std::runtime_error("Failed to write file " + filename);
+    }
+
+    return file.size();
+}
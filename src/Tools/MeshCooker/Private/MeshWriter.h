@@ -0,0 +1,14 @@
+#pragma once
+
+#include "MeshQuantizer.h"
+
+#include <stddef.h>
+#include <string>
+
+class FMeshWriter
+{
+  public:
+    // Indices are stored as 16-bit when every vertex can be addressed, returns
+    // the size of the file
+    static size_t Write(const std::string& filename, const FCookedMesh& mesh);
+};
@@ -0,0 +1,258 @@
+#include "ObjImporter.h"
+
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// Position, texture coordinate and normal index of a face corner, -1 when
+// the corner has none
+struct FCornerKey {
+    int32_t position;
+    int32_t uv;
+    int32_t normal;
+
+    bool operator==(const FCornerKey& other) const = default;
+};
+
+struct FCornerKeyHash {
+    size_t operator()(const FCornerKey& key) const
+    {
+        return (static_cast<size_t>(key.position) * 73856093u) ^
+               (static_cast<size_t>(key.uv) * 19349663u) ^
+               (static_cast<size_t>(key.normal) * 83492791u);
+    }
+};
+
+class FObjParser
+{
+  public:
+    FObjParser(const std::string& filename, const std::string& text)
+        : filename(filename), cursor(text.c_str()), line(1)
+    {
+    }
+
+    FSourceMesh Parse();
+
+  private:
+    const std::string& filename;
+    const char* cursor;
+    size_t line;
+
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 2>> uvs;
+    std::vector<std::array<float, 3>> normals;
+
+    std::unordered_map<FCornerKey, uint32_t, FCornerKeyHash> corners;
+    bool bMissingNormals = false;
+
+  private:
+    [[noreturn]] void Error(const std::string& message) const
+    {
+        throw std::runtime_error(filename + ":" + std::to_string(line) + ": " +
+                                 message);
+    }
+
+    void SkipSpaces()
+    {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') {
+            cursor++;
+        }
+    }
+
+    bool AtLineEnd()
+    {
+        SkipSpaces();
+        return *cursor == '\n' || *cursor == '\0' || *cursor == '#';
+    }
+
+    void SkipLine()
+    {
+        while (*cursor != '\n' && *cursor != '\0') {
+            cursor++;
+        }
+        if (*cursor == '\n') {
+            cursor++;
+            line++;
+        }
+    }
+
+    float ParseFloat()
+    {
+        if (AtLineEnd()) {
+            Error("Expected a number");
+        }
+
+        char* end = nullptr;
+        const float value = std::strtof(cursor, &end);
+        if (end == cursor) {
+            Error("Expected a number");
+        }
+        cursor = end;
+        return value;
+    }
+
+    // OBJ indices start at 1, negative indices count back from the last
+    // element read so far
+    int32_t ParseIndex(size_t count)
+    {
+        if (*cursor != '-' && *cursor != '+' &&
+            (*cursor < '0' || *cursor > '9')) {
+            Error("Expected an index");
+        }
+
+        char* end = nullptr;
+        const long value = std::strtol(cursor, &end, 10);
+        if (end == cursor || value == 0) {
+            Error("Expected an index");
+        }
+        cursor = end;
+
+        const long index =
+            value > 0 ? value - 1 : static_cast<long>(count) + value;
+        if (index < 0 || index >= static_cast<long>(count)) {
+            Error("Index " + std::to_string(value) + " is out of range");
+        }
+        return static_cast<int32_t>(index);
+    }
+
+    uint32_t ParseCorner(FSourceMesh& mesh);
+    void ParseFace(FSourceMesh& mesh);
+};
+
+FSourceMesh FObjParser::Parse()
+{
+    FSourceMesh mesh;
+
+    while (*cursor != '\0') {
+        SkipSpaces();
+
+        const char* keyword = cursor;
+        while (*cursor != ' ' && *cursor != '\t' && *cursor != '\r' &&
+               *cursor != '\n' && *cursor != '\0') {
+            cursor++;
+        }
+        const std::string_view command(keyword, cursor - keyword);
+
+        if (command == "v") {
+            const float x = ParseFloat();
+            const float y = ParseFloat();
+            const float z = ParseFloat();
+            positions.push_back({x, y, z});
+        } else if (command == "vt") {
+            const float u = ParseFloat();
+            const float v = AtLineEnd() ? 0.0f : ParseFloat();
+            // OBJ puts the origin at the bottom left of the texture
+            uvs.push_back({u, 1.0f - v});
+        } else if (command == "vn") {
+            const float x = ParseFloat();
+            const float y = ParseFloat();
+            const float z = ParseFloat();
+            normals.push_back({x, y, z});
+        } else if (command == "f") {
+            ParseFace(mesh);
+        }
+
+        SkipLine();
+    }
+
+    if (mesh.indices.empty()) {
+        throw std::runtime_error(filename + " has no faces");
+    }
+
+    if (bMissingNormals) {
+        mesh.GenerateNormals();
+    }
+
+    return mesh;
+}
+
+uint32_t FObjParser::ParseCorner(FSourceMesh& mesh)
+{
+    FCornerKey key = {.position = ParseIndex(positions.size()),
+                      .uv = -1,
+                      .normal = -1};
+
+    if (*cursor == '/') {
+        cursor++;
+        if (*cursor != '/') {
+            key.uv = ParseIndex(uvs.size());
+        }
+        if (*cursor == '/') {
+            cursor++;
+            key.normal = ParseIndex(normals.size());
+        }
+    }
+
+    const auto [found, bInserted] = corners.try_emplace(
+        key, static_cast<uint32_t>(mesh.vertices.size()));
+    if (!bInserted) {
+        return found->second;
+    }
+
+    FSourceVertex vertex = {};
+    for (size_t i = 0; i < 3; i++) {
+        vertex.position[i] = positions[key.position][i];
+    }
+    if (key.uv >= 0) {
+        vertex.uv[0] = uvs[key.uv][0];
+        vertex.uv[1] = uvs[key.uv][1];
+    }
+    if (key.normal >= 0) {
+        for (size_t i = 0; i < 3; i++) {
+            vertex.normal[i] = normals[key.normal][i];
+        }
+    } else {
+        bMissingNormals = true;
+    }
+
+    mesh.vertices.push_back(vertex);
+    return found->second;
+}
+
+void FObjParser::ParseFace(FSourceMesh& mesh)
+{
+    std::array<uint32_t, 2> fan = {};
+    size_t cornerCount = 0;
+
+    while (!AtLineEnd()) {
+        const uint32_t corner = ParseCorner(mesh);
+
+        if (cornerCount >= 2) {
+            mesh.indices.push_back(fan[0]);
+            mesh.indices.push_back(fan[1]);
+            mesh.indices.push_back(corner);
+            fan[1] = corner;
+        } else {
+            fan[cornerCount] = corner;
+        }
+        cornerCount++;
+    }
+
+    if (cornerCount < 3) {
+        Error("A face needs at least 3 corners");
+    }
+}
+
+} // namespace
+
+FSourceMesh FObjImporter::Import(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file " + filename);
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string text = stream.str();
+
+    return FObjParser(filename, text).Parse();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "SourceMesh.h"
+
+#include <string>
+
+// Wavefront OBJ positions, normals and texture coordinates. Polygons are
+// triangulated as fans, groups and materials are ignored.
+class FObjImporter
+{
+  public:
+    static FSourceMesh Import(const std::string& filename);
+};
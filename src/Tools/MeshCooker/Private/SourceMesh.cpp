@@ -0,0 +1,87 @@
+#include "SourceMesh.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+
+struct FPositionKey {
+    std::array<uint32_t, 3> bits;
+
+    bool operator==(const FPositionKey& other) const = default;
+};
+
+struct FPositionKeyHash {
+    size_t operator()(const FPositionKey& key) const
+    {
+        return (key.bits[0] * 73856093u) ^ (key.bits[1] * 19349663u) ^
+               (key.bits[2] * 83492791u);
+    }
+};
+
+FPositionKey GetKey(const FSourceVertex& vertex)
+{
+    FPositionKey key;
+    std::memcpy(key.bits.data(), vertex.position, sizeof(key.bits));
+    return key;
+}
+
+} // namespace
+
+void FSourceMesh::GenerateNormals(size_t firstVertex, size_t firstIndex)
+{
+    std::unordered_map<FPositionKey, std::array<float, 3>, FPositionKeyHash>
+        normals;
+
+    for (size_t i = firstIndex; i + 2 < indices.size(); i += 3) {
+        const float* a = vertices[indices[i]].position;
+        const float* b = vertices[indices[i + 1]].position;
+        const float* c = vertices[indices[i + 2]].position;
+
+        const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        const float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+
+        // The cross product length is twice the area, larger faces weigh more
+        const float normal[3] = {
+            ab[1] * ac[2] - ab[2] * ac[1],
+            ab[2] * ac[0] - ab[0] * ac[2],
+            ab[0] * ac[1] - ab[1] * ac[0],
+        };
+
+        for (size_t corner = 0; corner < 3; corner++) {
+            std::array<float, 3>& sum =
+                normals.try_emplace(GetKey(vertices[indices[i + corner]]),
+                                    std::array<float, 3>{})
+                    .first->second;
+            sum[0] += normal[0];
+            sum[1] += normal[1];
+            sum[2] += normal[2];
+        }
+    }
+
+    for (size_t i = firstVertex; i < vertices.size(); i++) {
+        FSourceVertex& vertex = vertices[i];
+
+        std::array<float, 3> normal = {0.0f, 0.0f, 0.0f};
+        if (const auto found = normals.find(GetKey(vertex));
+            found != normals.end()) {
+            normal = found->second;
+        }
+
+        const float length = std::sqrt(normal[0] * normal[0] +
+                                       normal[1] * normal[1] +
+                                       normal[2] * normal[2]);
+        if (length > 0.0f) {
+            vertex.normal[0] = normal[0] / length;
+            vertex.normal[1] = normal[1] / length;
+            vertex.normal[2] = normal[2] / length;
+        } else {
+            vertex.normal[0] = 0.0f;
+            vertex.normal[1] = 0.0f;
+            vertex.normal[2] = 1.0f;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct FSourceVertex {
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+// Triangle list as read from the source file, before quantization
+struct FSourceMesh {
+    std::vector<FSourceVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // Files read besides the source, written to the depfile
+    std::vector<std::string> dependencies;
+
+    // Sets the normals of vertices [firstVertex, end) to the area weighted
+    // average of the faces in [firstIndex, end) sharing their position, so UV
+    // seams stay smooth
+    void GenerateNormals(size_t firstVertex = 0, size_t firstIndex = 0);
+};
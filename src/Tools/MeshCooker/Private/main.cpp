@@ -0,0 +1,232 @@
+#include "GltfImporter.h"
+#include "MeshOptimizer.h"
+#include "MeshQuantizer.h"
+#include "MeshSimplifier.h"
+#include "MeshWriter.h"
+#include "ObjImporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Largest ACMR increase the overdraw order may cost over the cache order
+constexpr float OverdrawThreshold = 1.05f;
+
+constexpr uint32_t AnalyzedCacheSize = 16;
+
+// Each LOD aims for half the triangles of the previous one. The chain ends at
+// a few dozen triangles, or when locked borders and seams stall the
+// simplifier.
+constexpr float LodTriangleRatio = 0.5f;
+constexpr size_t MinLodTriangles = 32;
+constexpr float MinLodProgress = 0.85f;
+
+struct FArguments {
+    std::string input;
+    std::string output;
+    std::string depfile;
+};
+
+FArguments ParseArguments(int argc, char** argv)
+{
+    FArguments arguments;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument.starts_with("-out=")) {
+            arguments.output = argument.substr(5);
+        } else if (argument.starts_with("-depfile=")) {
+            arguments.depfile = argument.substr(9);
+        } else if (argument.starts_with("-")) {
+            throw std::runtime_error("Unknown option " + argument);
+        } else {
+            arguments.input = argument;
+        }
+    }
+
+    if (arguments.input.empty()) {
+        throw std::runtime_error(
+            "Usage: MeshCooker <mesh.obj|mesh.gltf|mesh.glb> "
+            "[-out=<file.mesh>] [-depfile=<file.d>]");
+    }
+
+    if (arguments.output.empty()) {
+        arguments.output = std::filesystem::path(arguments.input)
+                               .replace_extension(".mesh")
+                               .string();
+    }
+
+    return arguments;
+}
+
+FSourceMesh Import(const std::string& filename)
+{
+    std::string extension =
+        std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    if (extension == ".obj") {
+        return FObjImporter::Import(filename);
+    }
+    if (extension == ".gltf" || extension == ".glb") {
+        return FGltfImporter::Import(filename);
+    }
+
+    throw std::runtime_error("Unknown mesh format " + filename);
+}
+
+// Make syntax, spaces in paths are escaped
+void WriteDepfile(const FArguments& arguments, const FSourceMesh& mesh)
+{
+    auto escape = [](const std::string& path) {
+        std::string escaped;
+        for (const char c : path) {
+            if (c == ' ') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    };
+
+    std::ofstream file(arguments.depfile, std::ios::trunc);
+    file << escape(arguments.output) << ": " << escape(arguments.input);
+    for (const std::string& dependency : mesh.dependencies) {
+        file << " \\\n  " << escape(dependency);
+    }
+    file << "\n";
+
+    if (!file) {
+        throw std::runtime_error("Failed to write " + arguments.depfile);
+    }
+}
+
+// LOD 0 is the quantized mesh, the others reuse its vertices
+std::vector<std::vector<uint32_t>>
+BuildLods(const FCookedMesh& mesh,
+          std::span<const std::array<float, 3>> positions,
+          std::vector<float>& errors)
+{
+    std::vector<std::vector<uint32_t>> lods = {mesh.indices};
+    errors = {0.0f};
+
+    FMeshSimplifier simplifier(mesh.indices, positions);
+
+    while (lods.size() < MaxMeshLodCount) {
+        const size_t triangleCount = lods.back().size() / 3;
+        const size_t targetTriangles =
+            static_cast<size_t>(triangleCount * LodTriangleRatio);
+        if (targetTriangles < MinLodTriangles) {
+            break;
+        }
+
+        simplifier.Simplify(targetTriangles * 3);
+
+        const std::vector<uint32_t>& indices = simplifier.GetIndices();
+        if (indices.size() > lods.back().size() * MinLodProgress) {
+            break;
+        }
+
+        lods.push_back(indices);
+        errors.push_back(simplifier.GetError());
+    }
+
+    return lods;
+}
+
+void Cook(const FArguments& arguments)
+{
+    const FSourceMesh source = Import(arguments.input);
+
+    FCookedMesh mesh = FMeshQuantizer::Quantize(source);
+
+    const FVertexCacheStats before = FMeshOptimizer::AnalyzeVertexCache(
+        mesh.indices, mesh.vertices.size(), AnalyzedCacheSize);
+
+    std::vector<std::array<float, 3>> positions;
+    positions.reserve(mesh.vertices.size());
+    for (const FMeshVertex& vertex : mesh.vertices) {
+        positions.push_back(mesh.GetPosition(vertex));
+    }
+
+    std::vector<float> errors;
+    std::vector<std::vector<uint32_t>> lods =
+        BuildLods(mesh, positions, errors);
+
+    // Every LOD is ordered on its own and appended to the shared index buffer
+    mesh.indices.clear();
+    mesh.lods.clear();
+    for (size_t lod = 0; lod < lods.size(); lod++) {
+        std::vector<uint32_t>& indices = lods[lod];
+
+        FMeshOptimizer::OptimizeVertexCache(indices, mesh.vertices.size());
+        FMeshOptimizer::OptimizeOverdraw(indices, positions,
+                                         OverdrawThreshold);
+
+        mesh.lods.push_back({
+            .firstIndex = static_cast<uint32_t>(mesh.indices.size()),
+            .indexCount = static_cast<uint32_t>(indices.size()),
+            .error = errors[lod],
+            .padding = 0,
+        });
+        mesh.indices.insert(mesh.indices.end(), indices.begin(),
+                            indices.end());
+    }
+
+    // LOD 0 comes first, its vertices get the best fetch locality
+    mesh.vertices =
+        FMeshOptimizer::OptimizeVertexFetch(mesh.indices, mesh.vertices);
+
+    const FVertexCacheStats after = FMeshOptimizer::AnalyzeVertexCache(
+        std::span(mesh.indices).first(mesh.lods[0].indexCount),
+        mesh.vertices.size(), AnalyzedCacheSize);
+
+    const size_t cookedSize = FMeshWriter::Write(arguments.output, mesh);
+    const size_t sourceSize = source.vertices.size() * sizeof(FSourceVertex) +
+                              source.indices.size() * sizeof(uint32_t);
+
+    if (!arguments.depfile.empty()) {
+        WriteDepfile(arguments, source);
+    }
+
+    std::cout << arguments.input << ": " << source.vertices.size() << " -> "
+              << mesh.vertices.size() << " vertices, "
+              << mesh.lods[0].indexCount / 3 << " triangles, ACMR "
+              << before.acmr << " -> " << after.acmr << ", ATVR "
+              << before.atvr << " -> " << after.atvr << ", "
+              << sourceSize / 1024 << " KiB -> " << cookedSize / 1024
+              << " KiB" << std::endl;
+
+    for (size_t lod = 1; lod < mesh.lods.size(); lod++) {
+        std::cout << "  LOD " << lod << ": " << mesh.lods[lod].indexCount / 3
+                  << " triangles, error " << mesh.lods[lod].error
+                  << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        Cook(ParseArguments(argc, argv));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
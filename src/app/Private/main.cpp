@@ -1,9 +1,12 @@
+#include "Core/CommandLine.h"
 #include "GameEngine.h"
 #include <cstdlib>
 #include <iostream>
 
-int main()
+int main(int argc, char** argv)
 {
+    FCommandLine::Init(argc, argv);
+
     GameEngine app;
     try {
         app.run();
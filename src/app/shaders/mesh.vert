@@ -0,0 +1,49 @@
+#version 450
+
+// FMeshVertex, see Core/MeshFormat.h
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 3) in vec4 inInstance;
+
+// FMeshConstants, maps the unorm16 positions into the unit sphere around the
+// mesh bounds
+layout(push_constant) uniform MeshConstants {
+    vec4 positionScale;
+    vec4 positionBias;
+} mesh;
+
+layout(location = 0) out vec3 fragColor;
+
+// The depth prepass pipeline has to produce the same depth for the equal test
+invariant gl_Position;
+
+vec3 DecodeOctahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -t : t;
+    normal.y += normal.y >= 0.0 ? -t : t;
+    return normalize(normal);
+}
+
+void main() {
+    vec3 position =
+        inPosition.xyz * mesh.positionScale.xyz + mesh.positionBias.xyz;
+    vec3 normal = DecodeOctahedral(inNormal);
+
+    // There is no camera yet, the mesh looks down -z with y up. xy: offset,
+    // z: scale like the triangle, the depth spans the bounding sphere.
+    gl_Position = vec4(position.x * inInstance.z + inInstance.x,
+                       -position.y * inInstance.z + inInstance.y,
+                       0.5 - position.z * 0.5, 1.0);
+
+    const vec3 lightDirection = normalize(vec3(0.4, 0.8, 0.6));
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+
+    // Checker over the texture coordinates
+    float checker = mod(floor(inUV.x * 16.0) + floor(inUV.y * 8.0), 2.0);
+    vec3 albedo = mix(vec3(0.8, 0.45, 0.2), vec3(0.95, 0.8, 0.6), checker);
+
+    fragColor = albedo * (0.15 + 0.85 * diffuse);
+}
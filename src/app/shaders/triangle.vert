@@ -1,7 +1,12 @@
 #version 450
 
+layout(location = 0) in vec4 inInstance;
+
 layout(location = 0) out vec3 fragColor;
 
+// The depth prepass pipeline has to produce the same depth for the equal test
+invariant gl_Position;
+
 vec2 positions[3] = vec2[](
     vec2(0.0, -0.5),
     vec2(0.5, 0.5),
@@ -15,6 +20,7 @@ vec3 colors[3] = vec3[](
 );
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    // xy: offset, z: scale
+    gl_Position = vec4(positions[gl_VertexIndex] * inInstance.z + inInstance.xy, 0.0, 1.0);
     fragColor = colors[gl_VertexIndex];
 }